@@ -14,6 +14,10 @@ public class Program
 		//BenchmarkRunner.Run<StringtHashSet>( config );
 		//BenchmarkRunner.Run<MemoryAlloc>( config );
 		//BenchmarkRunner.Run<StringHashing>( config );
+		//BenchmarkRunner.Run<ParticleSimulation>( config );
+		//BenchmarkRunner.Run<NavMeshTileBuild>( config );
+		//BenchmarkRunner.Run<MovieSampleEncoding>( config );
+		//BenchmarkRunner.Run<SpatialQuery>( config );
 		BenchmarkRunner.Run<ByteStreamTest>( config );
 
 		//BenchmarkRunner.Run( typeof( Program ).Assembly, config );
@@ -0,0 +1,128 @@
+using BenchmarkDotNet.Attributes;
+using Sandbox;
+using Sandbox.MovieMaker;
+using Sandbox.MovieMaker.Compiled;
+using System;
+using System.Linq;
+
+/// <summary>
+/// Writing and reading the samples of a recorded movie, with the compressed <see cref="ByteStream"/> movies used to be
+/// saved with against the LZ4 compressed <see cref="SampleCodec"/> blobs. The recording is a skeleton's bone transforms at 60 samples per second,
+/// each bone swinging smoothly like a walk cycle with a bit of noise.
+/// </summary>
+[MemoryDiagnoser]
+public class MovieSampleEncoding
+{
+	const int BoneCount = 64;
+	const int SampleRate = 60;
+	const int Seconds = 10;
+
+	Transform[][] _bones;
+	byte[][] _legacy;
+	byte[][] _encoded;
+	string _json;
+
+	[GlobalSetup]
+	public void Setup()
+	{
+		var random = new Random( 1234 );
+
+		_bones = new Transform[BoneCount][];
+
+		for ( int b = 0; b < BoneCount; b++ )
+		{
+			var phase = random.Float( 0f, MathF.Tau );
+			var offset = new Vector3( random.Float( -8f, 8f ), random.Float( -8f, 8f ), random.Float( 0f, 64f ) );
+
+			_bones[b] = Enumerable.Range( 0, SampleRate * Seconds )
+				.Select( i =>
+				{
+					var t = i / (float)SampleRate * 2f + phase;
+					var position = offset + new Vector3( MathF.Sin( t ) * 4f, 0f, MathF.Abs( MathF.Cos( t ) ) * 2f ) + random.VectorInSphere( 0.01f );
+					var rotation = Rotation.From( MathF.Sin( t ) * 30f, MathF.Cos( t * 0.5f ) * 10f, 0f );
+
+					return new Transform( position, rotation );
+				} )
+				.ToArray();
+		}
+
+		_legacy = _bones.Select( LegacyEncode ).ToArray();
+		_encoded = _bones.Select( x => SampleCodec.Encode<Transform>( x ) ).ToArray();
+
+		var root = MovieClip.RootGameObject( "Skeleton" );
+		_json = Json.Serialize( MovieClip.FromTracks( _bones
+			.Select( ( x, i ) => root.GameObject( $"Bone{i}" )
+				.Property<Transform>( nameof( GameObject.LocalTransform ) )
+				.WithSamples( (0d, Seconds), SampleRate, x ) ) ) );
+	}
+
+	static byte[] LegacyEncode( Transform[] samples )
+	{
+		using var stream = ByteStream.Create( 16 * samples.Length + 4 );
+		stream.WriteArray( (ReadOnlySpan<Transform>)samples );
+
+		return stream.Compress().ToArray();
+	}
+
+	[Benchmark( Baseline = true )]
+	public int WriteLegacy()
+	{
+		var total = 0;
+
+		foreach ( var bone in _bones )
+		{
+			total += LegacyEncode( bone ).Length;
+		}
+
+		return total;
+	}
+
+	[Benchmark]
+	public int Write()
+	{
+		var total = 0;
+
+		foreach ( var bone in _bones )
+		{
+			total += SampleCodec.Encode<Transform>( bone ).Length;
+		}
+
+		return total;
+	}
+
+	[Benchmark]
+	public int ReadLegacy()
+	{
+		var total = 0;
+
+		foreach ( var data in _legacy )
+		{
+			var stream = ByteStream.CreateReader( data ).Decompress();
+			total += stream.ReadArraySpan<Transform>( 0x10_0000 ).ToArray().Length;
+		}
+
+		return total;
+	}
+
+	[Benchmark]
+	public int Read()
+	{
+		var total = 0;
+
+		foreach ( var data in _encoded )
+		{
+			total += SampleCodec.Decode<Transform>( data ).Length;
+		}
+
+		return total;
+	}
+
+	/// <summary>
+	/// Loading the whole clip, which only decodes samples once something plays them.
+	/// </summary>
+	[Benchmark]
+	public MovieClip LoadClip()
+	{
+		return Json.Deserialize<MovieClip>( _json );
+	}
+}
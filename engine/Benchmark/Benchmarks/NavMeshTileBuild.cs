@@ -0,0 +1,118 @@
+using BenchmarkDotNet.Attributes;
+using Sandbox;
+using Sandbox.Navigation.Generation;
+using System;
+using System.Collections.Generic;
+
+/// <summary>
+/// Builds a navmesh tile's compact heightfield from a fixed triangle soup, the same steps as
+/// <see cref="HeightFieldGenerator.Generate"/> but without needing a physics world to collect from.
+/// </summary>
+[MemoryDiagnoser]
+public class NavMeshTileBuild
+{
+	[Params( 4.0f, 2.0f, 1.0f )]
+	public float CellSize { get; set; }
+
+	const float TileSize = 512.0f;
+	const float CellHeight = 2.0f;
+	const float MaxSlope = 45.0f;
+
+	const int WalkableHeight = 32;
+	const int WalkableClimb = 9;
+	const int WalkableRadius = 4;
+
+	Vector3[] _vertices;
+	int[] _indices;
+	int[] _areas;
+
+	Heightfield _heightfield;
+	int _size;
+
+	[GlobalSetup]
+	public void Setup()
+	{
+		var vertices = new List<Vector3>();
+		var indices = new List<int>();
+
+		// Rolling ground, in nav space where y is up
+		const int groundSteps = 48;
+		var step = TileSize / groundSteps;
+
+		for ( int z = 0; z <= groundSteps; z++ )
+		{
+			for ( int x = 0; x <= groundSteps; x++ )
+			{
+				vertices.Add( new Vector3( x * step, 40 + MathF.Sin( x * 0.3f ) * 12 + MathF.Cos( z * 0.2f ) * 8, z * step ) );
+			}
+		}
+
+		for ( int z = 0; z < groundSteps; z++ )
+		{
+			for ( int x = 0; x < groundSteps; x++ )
+			{
+				int i = z * (groundSteps + 1) + x;
+				indices.AddRange( [i, i + groundSteps + 1, i + 1, i + 1, i + groundSteps + 1, i + groundSteps + 2] );
+			}
+		}
+
+		// Boxes to walk around and on top of
+		var random = new Random( 1234 );
+		int[] boxFaces = [0, 1, 3, 0, 3, 2, 4, 7, 5, 4, 6, 7, 0, 4, 5, 0, 5, 1, 2, 3, 7, 2, 7, 6, 0, 2, 6, 0, 6, 4, 1, 5, 7, 1, 7, 3];
+
+		for ( int b = 0; b < 40; b++ )
+		{
+			var mins = new Vector3( random.Float( 0, TileSize - 64 ), random.Float( 20, 60 ), random.Float( 0, TileSize - 64 ) );
+			var maxs = mins + new Vector3( random.Float( 16, 64 ), random.Float( 10, 80 ), random.Float( 16, 64 ) );
+
+			int first = vertices.Count;
+			for ( int k = 0; k < 8; k++ )
+			{
+				vertices.Add( new Vector3( (k & 1) != 0 ? maxs.x : mins.x, (k & 2) != 0 ? maxs.y : mins.y, (k & 4) != 0 ? maxs.z : mins.z ) );
+			}
+
+			foreach ( var index in boxFaces )
+			{
+				indices.Add( first + index );
+			}
+		}
+
+		_vertices = vertices.ToArray();
+		_indices = indices.ToArray();
+		_areas = new int[_indices.Length / 3];
+
+		_size = (int)(TileSize / CellSize);
+		_heightfield = new Heightfield( _size, _size, Vector3.Zero, new Vector3( TileSize, 256, TileSize ), CellSize, CellHeight );
+	}
+
+	[GlobalCleanup]
+	public void Cleanup()
+	{
+		_heightfield.Dispose();
+	}
+
+	[Benchmark]
+	public int Rasterize()
+	{
+		InputFilter.MarkWalkableTriangles( MaxSlope, _vertices, _indices, _areas );
+
+		_heightfield.Init( _size, _size, Vector3.Zero, new Vector3( TileSize, 256, TileSize ), CellSize, CellHeight );
+		Rasterization.RasterizeTriangles( _vertices, _indices, _areas, _heightfield, WalkableClimb );
+
+		return _heightfield.TotalSpanCount;
+	}
+
+	[Benchmark]
+	public int BuildTile()
+	{
+		Rasterize();
+
+		_heightfield.EnsureCompressed();
+		SpanFilter.Filter( WalkableHeight, WalkableClimb, _heightfield );
+
+		using var chf = _heightfield.BuildCompactHeightfield( WalkableHeight, WalkableClimb );
+		AreaFilter.ErodeWalkableArea( WalkableRadius, chf );
+
+		return chf.SpanCount;
+	}
+}
@@ -0,0 +1,85 @@
+using BenchmarkDotNet.Attributes;
+using Sandbox;
+using System;
+using System.Collections.Generic;
+
+/// <summary>
+/// Moving particles one at a time through their fields, against copying them into a
+/// <see cref="ParticleBuffer"/> and running the movement stages with SIMD.
+/// </summary>
+[MemoryDiagnoser]
+public class ParticleSimulation
+{
+	[Params( 1000, 50000 )]
+	public int ParticleCount { get; set; }
+
+	const int ChunkSize = 64;
+	const float TimeDelta = 1.0f / 60.0f;
+
+	readonly Vector3 _force = new Vector3( 0, 0, -800 );
+
+	List<Particle> _particles;
+	ParticleBuffer _buffer;
+
+	[GlobalSetup]
+	public void Setup()
+	{
+		var random = new Random( 1234 );
+
+		_particles = new List<Particle>( ParticleCount );
+		_buffer = new ParticleBuffer();
+
+		for ( int i = 0; i < ParticleCount; i++ )
+		{
+			_particles.Add( new Particle
+			{
+				Position = new Vector3( random.NextSingle(), random.NextSingle(), random.NextSingle() ) * 1000,
+				Velocity = new Vector3( random.NextSingle() - 0.5f, random.NextSingle() - 0.5f, random.NextSingle() ) * 500,
+				TimeScale = 1
+			} );
+		}
+	}
+
+	[Benchmark( Baseline = true )]
+	public void PerParticle()
+	{
+		foreach ( var p in _particles )
+		{
+			var timeScale = TimeDelta * p.TimeScale;
+
+			p.ApplyDamping( 0.5f * timeScale );
+			p.Velocity += 1.0f * _force * timeScale;
+			p.Position += p.Velocity * timeScale;
+		}
+	}
+
+	[Benchmark]
+	public void Batched()
+	{
+		for ( int start = 0; start < _particles.Count; start += ChunkSize )
+		{
+			var count = Math.Min( ChunkSize, _particles.Count - start );
+
+			_buffer.Reset( count );
+			_buffer.ForceDirection = _force;
+
+			for ( int i = 0; i < count; i++ )
+			{
+				var p = _particles[start + i];
+				var timeScale = TimeDelta * p.TimeScale;
+
+				_buffer.TimeScale[i] = timeScale;
+				_buffer.Damping[i] = 0.5f * timeScale;
+				_buffer.ForceScale[i] = timeScale;
+				_buffer.Read( i, p, Vector3.Zero );
+			}
+
+			_buffer.Simulate();
+
+			for ( int i = 0; i < count; i++ )
+			{
+				_buffer.Write( i, _particles[start + i] );
+			}
+		}
+	}
+}
@@ -0,0 +1,127 @@
+using BenchmarkDotNet.Attributes;
+using Sandbox;
+using Sandbox.Utility;
+using System;
+using System.Collections.Generic;
+
+/// <summary>
+/// Proximity queries over 50,000 objects spread across a map, comparing the <see cref="SpatialHash{T}"/> behind
+/// <see cref="Scene.FindInSphere{T}"/> with checking every object's distance.
+/// </summary>
+[MemoryDiagnoser]
+public class SpatialQuery
+{
+	const int ObjectCount = 50_000;
+	const int QueryCount = 256;
+	const float MapSize = 32_000.0f;
+	const float Radius = 1024.0f;
+
+	object[] _objects;
+	Vector3[] _positions;
+	Vector3[] _queries;
+
+	SpatialHash<object> _hash;
+	int[] _handles;
+
+	List<int> _results = new( 1024 );
+	List<object> _objectResults = new( 1024 );
+
+	[GlobalSetup]
+	public void Setup()
+	{
+		var random = new Random( 1234 );
+
+		_objects = new object[ObjectCount];
+		_positions = new Vector3[ObjectCount];
+		_handles = new int[ObjectCount];
+		_hash = new SpatialHash<object>( 512.0f );
+
+		for ( int i = 0; i < ObjectCount; i++ )
+		{
+			_objects[i] = new object();
+			_positions[i] = RandomPosition( random );
+			_handles[i] = _hash.Add( _objects[i], _positions[i] );
+		}
+
+		_queries = new Vector3[QueryCount];
+
+		for ( int i = 0; i < QueryCount; i++ )
+		{
+			_queries[i] = RandomPosition( random );
+		}
+	}
+
+	static Vector3 RandomPosition( Random random )
+	{
+		return new Vector3( random.Float( -MapSize, MapSize ), random.Float( -MapSize, MapSize ), random.Float( 0, 2048 ) );
+	}
+
+	[Benchmark( Baseline = true )]
+	public int SphereLinear()
+	{
+		int found = 0;
+		var radiusSquared = Radius * Radius;
+
+		foreach ( var center in _queries )
+		{
+			_objectResults.Clear();
+
+			for ( int i = 0; i < _positions.Length; i++ )
+			{
+				if ( _positions[i].DistanceSquared( center ) <= radiusSquared )
+				{
+					_objectResults.Add( _objects[i] );
+				}
+			}
+
+			found += _objectResults.Count;
+		}
+
+		return found;
+	}
+
+	[Benchmark]
+	public int SphereHash()
+	{
+		int found = 0;
+
+		foreach ( var center in _queries )
+		{
+			_results.Clear();
+			_hash.FindInSphere( new Sphere( center, Radius ), _results );
+
+			found += _results.Count;
+		}
+
+		return found;
+	}
+
+	[Benchmark]
+	public int BoxHash()
+	{
+		int found = 0;
+
+		foreach ( var center in _queries )
+		{
+			_results.Clear();
+			_hash.FindInBox( BBox.FromPositionAndSize( center, Radius * 2 ), _results );
+
+			found += _results.Count;
+		}
+
+		return found;
+	}
+
+	/// <summary>
+	/// A tenth of the objects moving a little, like a busy frame.
+	/// </summary>
+	[Benchmark]
+	public void MoveHash()
+	{
+		for ( int i = 0; i < ObjectCount; i += 10 )
+		{
+			_positions[i] += new Vector3( 37, -23, 0 );
+			_hash.Move( _handles[i], _positions[i] );
+		}
+	}
+}
@@ -41,6 +41,51 @@ public partial class BlacklistTest
 		Assert.IsFalse( group.BuildResult.Success );
 	}
 
+	/// <summary>
+	/// Unchanged trees are skipped by the walker on rebuild, but must be walked again if a
+	/// declaration somewhere else changes what they bind to.
+	/// </summary>
+	[TestMethod]
+	public async Task IncrementalWalkRebindsUnchangedTrees()
+	{
+		var fs = new MemoryFileSystem();
+		fs.WriteAllText( "/Program.cs", "public static class Program { public static int Run() => Helpers.SizeOf<int>(); }" );
+		fs.WriteAllText( "/Helpers.cs", "public static class Helpers { public static int SizeOf<T>() => 4; }" );
+
+		var group = new CompileGroup( "Test" );
+
+		var compilerSettings = new Compiler.Configuration();
+		compilerSettings.Clean();
+
+		var compiler = group.CreateCompiler( "test", null, compilerSettings );
+		compiler.AddSourceLocation( fs );
+
+		await group.BuildAsync();
+		Assert.IsTrue( group.BuildResult.Success, group.BuildResult.BuildDiagnosticsString() );
+
+		// Body only change, nothing else can bind differently
+		fs.WriteAllText( "/Helpers.cs", "public static class Helpers { public static int SizeOf<T>() => 8; }" );
+		compiler.MarkForRecompile();
+
+		await group.BuildAsync();
+		Assert.IsTrue( group.BuildResult.Success, group.BuildResult.BuildDiagnosticsString() );
+
+		// Program.cs is untouched, but Helpers now resolves to a blacklisted type
+		fs.WriteAllText( "/Helpers.cs", "global using Helpers = System.Runtime.CompilerServices.Unsafe;" );
+		compiler.MarkForRecompile();
+
+		await group.BuildAsync();
+		Assert.IsFalse( group.BuildResult.Success );
+		Assert.AreEqual( 1, compiler.Diagnostics.Count( x => x.Id == "SB500" ) );
+
+		// Rebuilding without changes should still report it
+		compiler.MarkForRecompile();
+
+		await group.BuildAsync();
+		Assert.IsFalse( group.BuildResult.Success );
+		Assert.AreEqual( 1, compiler.Diagnostics.Count( x => x.Id == "SB500" ) );
+	}
+
 	void CompileAndWalk( string code, out List<Diagnostic> diagnostics )
 	{
 		var syntaxTree = CSharpSyntaxTree.ParseText( code );
@@ -1,4 +1,5 @@
 using System;
+using System.Collections.Generic;
 
 namespace TestCompiler;
 
@@ -156,6 +157,71 @@ public partial class CodeArchiveTest
 			"Server build should have same number of .Server.cs files" );
 	}
 
+	class TestOutputCache : ICompileOutputCache
+	{
+		public Dictionary<string, byte[]> Entries { get; } = new();
+		public int Hits { get; private set; }
+
+		public byte[] Get( string key )
+		{
+			if ( !Entries.TryGetValue( key, out var data ) ) return null;
+
+			Hits++;
+			return data;
+		}
+
+		public void Set( string key, byte[] data ) => Entries[key] = data;
+	}
+
+	static async Task<CompilerOutput> CompileWithCache( byte[] archiveData, ICompileOutputCache cache )
+	{
+		var group = new CompileGroup( "Test" );
+		group.OutputCache = cache;
+
+		var compiler = group.GetOrCreateCompiler( "test" );
+		compiler.UpdateFromArchive( new CodeArchive( archiveData ) );
+
+		await group.BuildAsync();
+
+		Assert.IsTrue( group.BuildResult.Success, group.BuildResult.BuildDiagnosticsString() );
+
+		return compiler.Output;
+	}
+
+	/// <summary>
+	/// Building the same archive twice with an <see cref="CompileGroup.OutputCache"/> should
+	/// only compile the first time, and give back the same assembly the second time.
+	/// </summary>
+	[TestMethod]
+	public async Task OutputCache()
+	{
+		var group = new CompileGroup( "Test" );
+		var compiler = group.CreateCompiler( "test", System.IO.Path.GetFullPath( "data/code/base" ), new Compiler.Configuration() );
+		await group.BuildAsync();
+
+		var data = compiler.Output.Archive.Serialize();
+		var cache = new TestOutputCache();
+
+		var first = await CompileWithCache( data, cache );
+		Assert.AreEqual( 1, cache.Entries.Count );
+		Assert.AreEqual( 0, cache.Hits );
+
+		var second = await CompileWithCache( data, cache );
+		Assert.AreEqual( 1, cache.Entries.Count );
+		Assert.AreEqual( 1, cache.Hits );
+
+		CollectionAssert.AreEqual( first.AssemblyData, second.AssemblyData );
+		Assert.AreEqual( first.XmlDocumentation, second.XmlDocumentation );
+
+		// A different archive shouldn't hit
+		var changed = new CodeArchive( data );
+		changed.Configuration.DefineConstants += ";CACHE_TEST";
+
+		await CompileWithCache( changed.Serialize(), cache );
+		Assert.AreEqual( 2, cache.Entries.Count );
+		Assert.AreEqual( 1, cache.Hits );
+	}
+
 	/// <summary>
 	/// <see cref="Compiler.UpdateFromArchive"/> needs to copy references from the archive, otherwise
 	/// assemblies can be loaded in the wrong order when players join a host. This was causing deserialization
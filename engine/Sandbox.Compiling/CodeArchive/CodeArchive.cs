@@ -57,6 +57,12 @@ public class CodeArchive
 	/// </summary>
 	internal bool Version_UsesOldRazorNamespaces => Version < 1007;
 
+	/// <summary>
+	/// Hash of the serialized bytes this archive was loaded from, or null if it wasn't loaded from bytes.
+	/// Used to look up previously compiled output in <see cref="CompileGroup.OutputCache"/>.
+	/// </summary>
+	internal string ContentHash { get; private set; }
+
 	public CodeArchive()
 	{
 		Version = 1007;
@@ -65,6 +71,7 @@ public class CodeArchive
 	public CodeArchive( byte[] data )
 	{
 		Deserialize( data );
+		ContentHash = Convert.ToHexString( System.Security.Cryptography.SHA256.HashData( data ) );
 	}
 
 	/// <summary>
@@ -84,6 +84,12 @@ public class CompileGroup : IDisposable
 	/// </summary>
 	public AccessControl AccessControl { get; set; }
 
+	/// <summary>
+	/// Persistent cache of compiled assemblies. If set, compilers building from a <see cref="CodeArchive"/> will
+	/// skip compiling when the archive, references and compiler are identical to a previous build.
+	/// </summary>
+	public ICompileOutputCache OutputCache { get; set; }
+
 	public CompileGroup( string name )
 	{
 		log = new Logger( $"CompileGroup/{name}" );
@@ -290,7 +296,7 @@ public class CompileGroup : IDisposable
 			//
 			// Accumulate the build result
 			//
-			bool allSuccess = compileList.All( x => x.BuildResult?.Success ?? false );
+			bool allSuccess = compileList.All( x => x.BuildResult?.Success ?? x.Output?.Successful ?? false );
 			result.Failed = !allSuccess;
 
 			foreach ( var compiler in toCompile.OrderBy( x => x.DependencyIndex() ) )
@@ -460,3 +466,19 @@ public interface ICompileReferenceProvider
 	/// </summary>
 	PortableExecutableReference Lookup( string reference );
 }
+
+/// <summary>
+/// Stores compiled output between sessions, see <see cref="CompileGroup.OutputCache"/>
+/// </summary>
+public interface ICompileOutputCache
+{
+	/// <summary>
+	/// Get previously stored data, or null if there isn't any
+	/// </summary>
+	byte[] Get( string key );
+
+	/// <summary>
+	/// Store data for this key
+	/// </summary>
+	void Set( string key, byte[] data );
+}
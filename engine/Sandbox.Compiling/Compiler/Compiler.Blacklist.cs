@@ -3,12 +3,18 @@ using Microsoft.CodeAnalysis.CSharp;
 using Microsoft.CodeAnalysis.CSharp.Syntax;
 using Sandbox.Generator;
 using System.Collections.Concurrent;
+using System.Collections.Immutable;
 using System.Runtime.CompilerServices;
+using System.Security.Cryptography;
 
 namespace Sandbox;
 
 partial class Compiler
 {
+	/// <summary>
+	/// Walk the compilation looking for blacklisted symbols. Results are kept in <see cref="IncrementalCompileState"/>
+	/// so on hotload we only walk trees that changed, unless a change elsewhere could make unchanged trees bind differently.
+	/// </summary>
 	private void RunBlacklistWalker( CSharpCompilation compiler, CompilerOutput output )
 	{
 		if ( !compiler.SyntaxTrees.Any() )
@@ -16,18 +22,100 @@ partial class Compiler
 			return;
 		}
 
-		ConcurrentBag<Diagnostic> diagnostics = new();
+		var trees = compiler.SyntaxTrees.ToArray();
+		var results = new IncrementalCompileState.BlacklistTreeResult[trees.Length];
+		var previous = incrementalState.BlacklistResults;
 
-		var result = System.Threading.Tasks.Parallel.ForEach( compiler.SyntaxTrees, tree =>
+		//
+		// Reuse results for trees whose text hasn't changed since last time
+		//
+		System.Threading.Tasks.Parallel.For( 0, trees.Length, i =>
 		{
+			var tree = trees[i];
+			var contentHash = Convert.ToHexString( tree.GetText().GetContentHash().AsSpan() );
+
+			if ( previous.TryGetValue( tree.FilePath, out var result ) && result.ContentHash == contentHash )
+			{
+				results[i] = result;
+				return;
+			}
+
+			results[i] = new( contentHash, GetDeclarationHash( tree ), default );
+		} );
+
+		//
+		// If declarations or references changed, symbols could resolve differently anywhere - walk everything
+		//
+		var declarationHash = CombineDeclarationHashes( trees, results );
+		var references = compiler.References.ToImmutableArray();
+
+		bool walkAll = declarationHash != incrementalState.BlacklistDeclarationHash
+			|| incrementalState.BlacklistReferences.IsDefault
+			|| !incrementalState.BlacklistReferences.ToHashSet().SetEquals( references );
+
+		System.Threading.Tasks.Parallel.For( 0, trees.Length, i =>
+		{
+			if ( !walkAll && !results[i].Diagnostics.IsDefault )
+				return;
+
+			var tree = trees[i];
 			var semanticModel = compiler.GetSemanticModel( tree );
 
 			var walker = new BlacklistCodeWalker( semanticModel );
 			walker.Visit( tree.GetRoot() );
 
-			walker.Diagnostics.ForEach( diagnostics.Add );
+			results[i] = results[i] with { Diagnostics = walker.Diagnostics.ToImmutableArray() };
 		} );
 
-		output.Diagnostics.AddRange( diagnostics );
+		incrementalState.BlacklistResults = trees
+			.Select( ( tree, i ) => (tree.FilePath, Result: results[i]) )
+			.DistinctBy( x => x.FilePath )
+			.ToDictionary( x => x.FilePath, x => x.Result );
+
+		incrementalState.BlacklistDeclarationHash = declarationHash;
+		incrementalState.BlacklistReferences = references;
+
+		output.Diagnostics.AddRange( results.SelectMany( x => x.Diagnostics ) );
+	}
+
+	/// <summary>
+	/// Hash everything in a tree except member bodies. Changing a method body can't change what
+	/// symbols code in another tree binds to, but changing a declaration can.
+	/// </summary>
+	private static string GetDeclarationHash( SyntaxTree tree )
+	{
+		using var hash = IncrementalHash.CreateHash( HashAlgorithmName.SHA256 );
+
+		foreach ( var token in tree.GetRoot().DescendantTokens( IsDeclarationNode ) )
+		{
+			hash.AppendData( Encoding.UTF8.GetBytes( token.Text ) );
+			hash.AppendData( " "u8 );
+		}
+
+		return Convert.ToHexString( hash.GetHashAndReset() );
+	}
+
+	private static bool IsDeclarationNode( SyntaxNode node )
+	{
+		if ( node is AttributeArgumentListSyntax )
+			return false;
+
+		if ( node is not (BlockSyntax or ArrowExpressionClauseSyntax) )
+			return true;
+
+		return node.Parent is not (BaseMethodDeclarationSyntax or AccessorDeclarationSyntax or BasePropertyDeclarationSyntax or LocalFunctionStatementSyntax);
+	}
+
+	private static string CombineDeclarationHashes( SyntaxTree[] trees, IncrementalCompileState.BlacklistTreeResult[] results )
+	{
+		using var hash = IncrementalHash.CreateHash( HashAlgorithmName.SHA256 );
+
+		for ( int i = 0; i < trees.Length; i++ )
+		{
+			hash.AppendData( Encoding.UTF8.GetBytes( trees[i].FilePath ) );
+			hash.AppendData( Encoding.UTF8.GetBytes( results[i].DeclarationHash ) );
+		}
+
+		return Convert.ToHexString( hash.GetHashAndReset() );
 	}
 }
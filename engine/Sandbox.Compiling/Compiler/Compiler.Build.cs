@@ -148,6 +148,17 @@ partial class Compiler
 		var releaseMode = archive.Configuration.ReleaseMode == ReleaseMode.Release;
 		var conf = archive.Configuration;
 
+		//
+		// If we've built this exact archive against these exact references before, use that
+		//
+		var cacheKey = GetOutputCacheKey( archive, refs );
+		if ( cacheKey is not null && TryLoadCachedOutput( cacheKey, output ) && VerifyCachedOutput( output ) )
+		{
+			BuildResult = null;
+			OnBuildSuccessful( output, false );
+			return;
+		}
+
 		var options = incrementalState.Compilation?.Options;
 
 
@@ -275,6 +286,19 @@ partial class Compiler
 
 		incrementalState.Update( archive.SyntaxTrees.ToImmutableArray(), beforeIlHotloadProcessingTrees, compiler );
 
+		if ( cacheKey is not null && output.Successful )
+		{
+			StoreCachedOutput( cacheKey, output );
+		}
+
+		OnBuildSuccessful( output, ilHotloadSupported );
+	}
+
+	/// <summary>
+	/// Makes the built assembly available to be referenced by other compilers
+	/// </summary>
+	void OnBuildSuccessful( CompilerOutput output, bool ilHotloadSupported )
+	{
 		using ( var a_stream = new System.IO.MemoryStream( output.AssemblyData ) )
 		{
 			MetadataReference = output.MetadataReference = Microsoft.CodeAnalysis.MetadataReference.CreateFromStream( a_stream );
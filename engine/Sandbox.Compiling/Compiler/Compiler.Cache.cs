@@ -0,0 +1,143 @@
+﻿using Microsoft.CodeAnalysis;
+using Microsoft.CodeAnalysis.CSharp;
+using System.Security.Cryptography;
+using System.Text.Json;
+
+namespace Sandbox;
+
+partial class Compiler
+{
+	/// <summary>
+	/// Bump this if the cached data layout changes
+	/// </summary>
+	const int OutputCacheVersion = 1;
+
+	/// <summary>
+	/// Get a key that identifies the output of compiling this archive with these references, or null if
+	/// this build can't be cached. Only builds from a loaded <see cref="CodeArchive"/> are cached, since
+	/// source builds are hotloaded and incremental anyway.
+	/// </summary>
+	string GetOutputCacheKey( CodeArchive archive, IReadOnlyList<PortableExecutableReference> refs )
+	{
+		if ( Group?.OutputCache is null ) return null;
+		if ( archive != _currentArchive || archive.ContentHash is null ) return null;
+
+		var sb = new StringBuilder();
+		sb.AppendLine( $"v{OutputCacheVersion}" );
+		sb.AppendLine( AssemblyName );
+		sb.AppendLine( archive.ContentHash );
+		sb.AppendLine( JsonSerializer.Serialize( config ) );
+
+		// Anything that changes how we compile or what we allow
+		sb.AppendLine( typeof( Compiler ).Assembly.ManifestModule.ModuleVersionId.ToString() );
+		sb.AppendLine( typeof( CSharpCompilation ).Assembly.ManifestModule.ModuleVersionId.ToString() );
+		sb.AppendLine( typeof( Generator.Processor ).Assembly.ManifestModule.ModuleVersionId.ToString() );
+		sb.AppendLine( typeof( Razor.RazorProcessor ).Assembly.ManifestModule.ModuleVersionId.ToString() );
+		sb.AppendLine( Group.AccessControl?.GetType().Assembly.ManifestModule.ModuleVersionId.ToString() ?? "no access control" );
+
+		foreach ( var mvid in refs.Select( GetModuleVersionId ).Order() )
+		{
+			if ( mvid is null ) return null;
+
+			sb.AppendLine( mvid );
+		}
+
+		return Convert.ToHexString( SHA256.HashData( Encoding.UTF8.GetBytes( sb.ToString() ) ) );
+	}
+
+	static string GetModuleVersionId( PortableExecutableReference reference )
+	{
+		try
+		{
+			return reference.GetMetadata() switch
+			{
+				AssemblyMetadata assembly => string.Join( ",", assembly.GetModules().Select( x => x.GetModuleVersionId() ) ),
+				ModuleMetadata module => module.GetModuleVersionId().ToString(),
+				_ => null
+			};
+		}
+		catch ( System.Exception )
+		{
+			return null;
+		}
+	}
+
+	/// <summary>
+	/// Fill the output from the cache, returns false if there's nothing usable stored for this key
+	/// </summary>
+	bool TryLoadCachedOutput( string key, CompilerOutput output )
+	{
+		try
+		{
+			var data = Group.OutputCache.Get( key );
+			if ( data is null || data.Length == 0 ) return false;
+
+			using var compressed = ByteStream.CreateReader( data );
+			using var bs = compressed.Decompress();
+
+			if ( bs.Read<string>() != "SBCO" ) return false;
+			if ( bs.Read<int>() != OutputCacheVersion ) return false;
+
+			output.AssemblyData = bs.ReadArray<byte>( 256 * 1024 * 1024 );
+			output.XmlDocumentation = bs.Read<string>();
+			output.Successful = true;
+
+			log.Trace( $"Using cached output ({output.AssemblyData.Length} bytes)" );
+			return true;
+		}
+		catch ( System.Exception e )
+		{
+			log.Warning( e, $"Couldn't read cached compile output: {e.Message}" );
+			return false;
+		}
+	}
+
+	/// <summary>
+	/// The cache lives on disk, so anything in it could have been swapped out since we stored it. Run the
+	/// same whitelist check a fresh build gets on the cached assembly. There's no syntax tree to run the
+	/// blacklist walker over, but everything it looks for ends up in the IL that the whitelist checks.
+	/// If it fails we throw the cached output away and compile from source, which reports the errors and
+	/// overwrites the entry.
+	/// </summary>
+	bool VerifyCachedOutput( CompilerOutput output )
+	{
+		if ( !config.Whitelist || Group.AccessControl is not { } access )
+			return true;
+
+		using ( var stream = new System.IO.MemoryStream( output.AssemblyData ) )
+		{
+			var result = access.VerifyAssembly( stream, out _ );
+			if ( result.Success )
+				return true;
+		}
+
+		log.Warning( "Cached compile output failed whitelist verification, recompiling" );
+
+		output.Successful = false;
+		output.AssemblyData = null;
+		output.XmlDocumentation = null;
+		return false;
+	}
+
+	/// <summary>
+	/// Store a successful build so the next identical build can skip compiling
+	/// </summary>
+	void StoreCachedOutput( string key, CompilerOutput output )
+	{
+		try
+		{
+			using ByteStream bs = ByteStream.Create( output.AssemblyData.Length + 1024 );
+
+			bs.Write( "SBCO" ); // sbox compiler output
+			bs.Write( OutputCacheVersion );
+			bs.WriteArray( output.AssemblyData );
+			bs.Write( output.XmlDocumentation );
+
+			Group.OutputCache.Set( key, bs.Compress().ToArray() );
+		}
+		catch ( System.Exception e )
+		{
+			log.Warning( e, $"Couldn't store compile output: {e.Message}" );
+		}
+	}
+}
@@ -7,7 +7,8 @@ namespace Sandbox;
 partial class Compiler
 {
 	/// <summary>
-	/// Process Razor files from the code archive and generate C# syntax trees
+	/// Process Razor files from the code archive and generate C# syntax trees. Trees generated by
+	/// previous builds are reused when the razor source and namespace options haven't changed.
 	/// </summary>
 	private List<SyntaxTree> ProcessRazorFiles( CodeArchive archive, CompilerOutput output )
 	{
@@ -16,9 +17,20 @@ partial class Compiler
 			.ToList();
 
 		if ( razorFiles.Count == 0 )
+		{
+			incrementalState.RazorTrees = new();
 			return [];
+		}
+
+		var rootNamespace = archive.Configuration.RootNamespace;
+		var useFolderNamespaces = !archive.Version_UsesOldRazorNamespaces;
 
-		var trees = new ConcurrentBag<SyntaxTree>();
+		// Only read from here while we're in the parallel loop, the generated trees go into a new
+		// dictionary so anything that was deleted or changed falls out of the cache
+		var previousTrees = incrementalState.RazorTrees;
+
+		var trees = new ConcurrentDictionary<string, SyntaxTree>();
+		var cachedTrees = new ConcurrentDictionary<IncrementalCompileState.RazorTreeKey, SyntaxTree>();
 		var diagnostics = new ConcurrentBag<Diagnostic>();
 
 		Parallel.ForEach( razorFiles, file =>
@@ -35,25 +47,30 @@ partial class Compiler
 
 			try
 			{
-				// Use the existing RazorProcessor to generate C# code from the Razor file
-				// Pass the root namespace so Razor can auto-generate @namespace directives from folder structure
-				var generatedCode = Sandbox.Razor.RazorProcessor.GenerateFromSource( file.Text, file.LocalPath, archive.Configuration.RootNamespace, !archive.Version_UsesOldRazorNamespaces );
-
 				// Create the generated file path using the same naming convention
 				string filePath = $"_gen_{filenameOnly}_{hash:x}.cs";
 
-				// Parse the generated C# code into a syntax tree
-				var tree = CSharpSyntaxTree.ParseText( generatedCode, path: filePath, encoding: System.Text.Encoding.UTF8 );
+				var key = new IncrementalCompileState.RazorTreeKey( file.LocalPath, file.Text, rootNamespace, useFolderNamespaces );
+
+				if ( !previousTrees.TryGetValue( key, out var tree ) )
+				{
+					// Use the existing RazorProcessor to generate C# code from the Razor file
+					// Pass the root namespace so Razor can auto-generate @namespace directives from folder structure
+					var generatedCode = Sandbox.Razor.RazorProcessor.GenerateFromSource( file.Text, file.LocalPath, rootNamespace, useFolderNamespaces );
+
+					// Parse the generated C# code into a syntax tree
+					tree = CSharpSyntaxTree.ParseText( generatedCode, path: filePath, encoding: System.Text.Encoding.UTF8 );
+				}
 
 				// Check for duplicates
-				if ( trees.Any( x => x.FilePath == filePath ) )
+				if ( !trees.TryAdd( filePath, tree ) )
 				{
 					var desc = new DiagnosticDescriptor( "SB6001", "Razor Error", $"Duplicate Razor Component: {file.LocalPath}", "razor", DiagnosticSeverity.Error, true );
 					diagnostics.Add( Diagnostic.Create( desc, null ) );
 					return;
 				}
 
-				trees.Add( tree );
+				cachedTrees[key] = tree;
 
 				// Map the generated file path to the original .razor file for debugging support
 				lock ( archive.FileMap )
@@ -72,12 +89,14 @@ partial class Compiler
 			}
 		} );
 
+		incrementalState.RazorTrees = new( cachedTrees );
+
 		// Add any diagnostics to the output
 		if ( diagnostics.Any() )
 		{
 			output.Diagnostics.AddRange( diagnostics );
 		}
 
-		return trees.OrderBy( x => x.FilePath ).ToList();
+		return trees.Values.OrderBy( x => x.FilePath ).ToList();
 	}
 }
@@ -15,6 +15,42 @@ class IncrementalCompileState
 	public ImmutableArray<SyntaxTree> PreHotloadSyntaxTrees;
 	public CSharpCompilation Compilation;
 
+	/// <summary>
+	/// Syntax trees generated from .razor files by previous builds, keyed by everything that affects
+	/// what the generator outputs. Lets us skip regenerating components that haven't changed.
+	/// </summary>
+	public Dictionary<RazorTreeKey, SyntaxTree> RazorTrees = new();
+
+	/// <summary>
+	/// Identifies the output of a single razor file. The source text is part of the key, so a lookup
+	/// hashes the contents and only hits when the file is exactly the same as last time.
+	/// </summary>
+	public readonly record struct RazorTreeKey( string LocalPath, string Text, string RootNamespace, bool UseFolderNamespaces );
+
+	/// <summary>
+	/// Blacklist walker results from the previous build, keyed by syntax tree file path.
+	/// </summary>
+	public Dictionary<string, BlacklistTreeResult> BlacklistResults = new();
+
+	/// <summary>
+	/// Combined <see cref="BlacklistTreeResult.DeclarationHash"/> of every tree when the blacklist walker last ran.
+	/// If this changes, symbols might resolve differently in trees that didn't change, so everything gets walked again.
+	/// </summary>
+	public string BlacklistDeclarationHash;
+
+	/// <summary>
+	/// References used when the blacklist walker last ran.
+	/// </summary>
+	public ImmutableArray<MetadataReference> BlacklistReferences;
+
+	/// <summary>
+	/// What the blacklist walker found in a single syntax tree.
+	/// </summary>
+	/// <param name="ContentHash">Hash of the full source text of the tree.</param>
+	/// <param name="DeclarationHash">Hash of the tree with member bodies left out, anything that can change how other trees bind.</param>
+	/// <param name="Diagnostics">Errors the walker found, or default if the tree still needs walking.</param>
+	public record BlacklistTreeResult( string ContentHash, string DeclarationHash, ImmutableArray<Diagnostic> Diagnostics );
+
 	public bool HasState => Compilation is not null;
 
 	internal void Reset()
@@ -23,6 +59,10 @@ class IncrementalCompileState
 		OldSyntaxTrees = default;
 		SyntaxTrees = default;
 		PreHotloadSyntaxTrees = default;
+		RazorTrees = new();
+		BlacklistResults = new();
+		BlacklistDeclarationHash = default;
+		BlacklistReferences = default;
 	}
 
 	internal void Update( ImmutableArray<SyntaxTree> syntaxTrees, ImmutableArray<SyntaxTree> beforeIlHotloadProcessingTrees, CSharpCompilation compiler )
@@ -20,6 +20,7 @@ freely, subject to the following restrictions:
 */
 
 using System.Diagnostics;
+using System.Runtime.InteropServices;
 using System.Threading;
 
 namespace DotRecast.Detour.Crowd
@@ -120,6 +121,12 @@ namespace DotRecast.Detour.Crowd
 
 		private readonly DtProximityGrid _grid;
 
+		// The active agents sorted by proximity grid cell, so each parallel chunk covers one area of the map
+		private readonly List<DtCrowdAgent> _partitionedAgents;
+		private long[] _partitionKeys = Array.Empty<long>();
+
+		private readonly DtCrowdTelemetry _telemetry;
+
 		private int _maxPathResult;
 		internal readonly Vector3 _agentPlacementHalfExtents;
 
@@ -127,6 +134,9 @@ namespace DotRecast.Detour.Crowd
 
 		private DtNavMeshQuery _navQuery;
 
+		// Nav queries aren't thread safe, so each worker in the parallel phases gets its own
+		private DtNavMeshQuery[] _workerNavQueries;
+
 		private DtNavMesh _navMesh;
 
 		public DtCrowd( DtCrowdConfig config, DtNavMesh nav )
@@ -156,6 +166,8 @@ namespace DotRecast.Detour.Crowd
 			_activeAgents = new List<DtCrowdAgent>();
 			_activeAgentTasks = new List<Task>();
 			_grid = new DtProximityGrid( _config.maxAgentRadius * 3 );
+			_partitionedAgents = new List<DtCrowdAgent>();
+			_telemetry = new DtCrowdTelemetry();
 
 			// The navQuery is mostly used for local searches, no need for large node pool.
 			SetNavMesh( nav );
@@ -165,6 +177,13 @@ namespace DotRecast.Detour.Crowd
 		{
 			_navMesh = nav;
 			_navQuery = new DtNavMeshQuery( nav );
+
+			_workerNavQueries = new DtNavMeshQuery[_obstacleQueries.Length];
+			_workerNavQueries[0] = _navQuery;
+			for ( int i = 1; i < _workerNavQueries.Length; ++i )
+			{
+				_workerNavQueries[i] = new DtNavMeshQuery( nav );
+			}
 		}
 
 		public DtNavMesh GetNavMesh()
@@ -391,82 +410,127 @@ namespace DotRecast.Detour.Crowd
 			return _config;
 		}
 
+		/// Gets how long each phase of the last #Update took.
+		public DtCrowdTelemetry Telemetry()
+		{
+			return _telemetry;
+		}
+
 		public void Update( float dt, DtCrowdAgentDebugInfo debug )
 		{
 			IList<DtCrowdAgent> agents = GetActiveAgents();
 
 			if ( agents.Count == 0 ) return;
 
-			// Not really worth parallizing on it's own
-			foreach ( var agent in agents )
-			{
-				// Check that all agents still have valid paths.
-				CheckPathValidity( agent, dt );
-			}
+			_telemetry.Start();
+
+			// Check that all agents still have valid paths.
+			ForEachAgent( agents, ( ag, worker ) => CheckPathValidity( ag, dt, _workerNavQueries[worker] ) );
+			_telemetry.Mark( DtCrowdTimerLabel.CheckPathValidity );
 
 			// Update async move request and path finder.
 			UpdateMoveRequest( agents, dt );
+			_telemetry.Mark( DtCrowdTimerLabel.UpdateMoveRequest );
 
 			// Optimize path topology.
 			UpdateTopologyOptimization( agents, dt );
+			_telemetry.Mark( DtCrowdTimerLabel.UpdateTopologyOptimization );
 
 			// Register agents to proximity grid.
 			BuildProximityGrid( agents );
+			_telemetry.Mark( DtCrowdTimerLabel.BuildProximityGrid );
+
+			// From here on the parallel phases work through the agents an area at a time.
+			// Each phase only writes to the agent it's updating and only reads what other agents
+			// wrote in earlier phases, so the results don't depend on how the agents are split up.
+			var partitioned = _partitionedAgents;
 
 			// Get nearby navmesh segments and agents to collide with.
-			BuildNeighbours( agents );
+			ForEachAgent( partitioned, ( ag, worker ) => BuildNeighbours( ag, _workerNavQueries[worker] ) );
+			_telemetry.Mark( DtCrowdTimerLabel.BuildNeighbours );
 
 			// Find next corner to steer to.
-			FindCorners( agents );
+			ForEachAgent( partitioned, ( ag, worker ) => FindCorners( ag, _workerNavQueries[worker] ) );
+			_telemetry.Mark( DtCrowdTimerLabel.FindCorners );
 
 			// Trigger off-mesh connections (depends on corners).
 			TriggerOffMeshConnections( agents );
+			_telemetry.Mark( DtCrowdTimerLabel.TriggerOffMeshConnections );
 
-			_activeAgentTasks.Clear();
+			// We don't want to do any of this if a navlink took over control over the agent.
+			// Steering reads neighbour positions, planning reads neighbour velocities and integrating
+			// writes both, so they're run as separate phases.
+			ForEachAgent( partitioned, ( ag, worker ) =>
+			{
+				if ( ag.state != DtCrowdAgentState.DT_CROWDAGENT_STATE_OFFMESH ) CalculateSteering( ag );
+			} );
+			_telemetry.Mark( DtCrowdTimerLabel.CalculateSteering );
 
-			int numThreads = Math.Min( Config().obstacleAvoidanceParallelism, agents.Count + 1 );
-			var chunkSize = (agents.Count + numThreads - 1) / numThreads;
+			ForEachAgent( partitioned, ( ag, worker ) =>
+			{
+				if ( ag.state != DtCrowdAgentState.DT_CROWDAGENT_STATE_OFFMESH ) PlanVelocity( ag, _obstacleQueries[worker] );
+			} );
+			_telemetry.Mark( DtCrowdTimerLabel.PlanVelocity );
 
-			for ( int threadId = 0; threadId < numThreads; ++threadId )
+			ForEachAgent( partitioned, ( ag, worker ) =>
 			{
-				var threadIdCopy = threadId;
-				_activeAgentTasks.Add(
-					Task.Run( () =>
-					{
-						// Process agents for this thread
-						int startIdx = threadIdCopy * chunkSize;
-						int endIdx = Math.Min( (threadIdCopy + 1) * chunkSize, agents.Count );
+				if ( ag.state != DtCrowdAgentState.DT_CROWDAGENT_STATE_OFFMESH ) Integrate( ag, dt );
+			} );
+			_telemetry.Mark( DtCrowdTimerLabel.Integrate );
 
-						for ( int agentIdx = startIdx; agentIdx < endIdx; ++agentIdx )
-						{
-							var agent = agents[agentIdx];
+			// Handle collisions.
+			HandleCollisions( partitioned );
+			_telemetry.Mark( DtCrowdTimerLabel.HandleCollisions );
 
-							// We don't want to do any of this if a navlink took over control over the agent
-							if ( agent.state == DtCrowdAgentState.DT_CROWDAGENT_STATE_OFFMESH ) continue;
+			ForEachAgent( partitioned, ( ag, worker ) => MoveAgent( ag, _workerNavQueries[worker] ) );
+			_telemetry.Mark( DtCrowdTimerLabel.MoveAgents );
 
-							// Calculate steering.
-							CalculateSteering( agent );
-							// Velocity planning.
-							PlanVelocity( agent, _obstacleQueries[threadIdCopy] );
-							// Integrate.
-							Integrate( agent, dt );
-						}
-					} )
-				);
+			// Update agents using off-mesh connection.
+			UpdateOffMeshConnections( agents, dt );
+			_telemetry.Mark( DtCrowdTimerLabel.UpdateOffMeshConnections );
+		}
+
+		/// Runs @p action on every agent, split into one contiguous chunk per worker thread.
+		/// The action is given the index of the worker running it, to pick its own queries.
+		private void ForEachAgent( IList<DtCrowdAgent> agents, Action<DtCrowdAgent, int> action )
+		{
+			int numThreads = Math.Clamp( agents.Count / Math.Max( _config.minAgentsPerThread, 1 ), 1, _obstacleQueries.Length );
+
+			if ( numThreads == 1 )
+			{
+				RunChunk( agents, action, 0, agents.Count );
+				return;
 			}
-			Task.WaitAll( _activeAgentTasks );
 
-			// Handle collisions.
-			HandleCollisions( agents );
+			var chunkSize = (agents.Count + numThreads - 1) / numThreads;
 
-			MoveAgents( agents );
+			_activeAgentTasks.Clear();
 
-			// Update agents using off-mesh connection.
-			UpdateOffMeshConnections( agents, dt );
+			for ( int threadId = 1; threadId < numThreads; ++threadId )
+			{
+				var threadIdCopy = threadId;
+				_activeAgentTasks.Add( Task.Run( () => RunChunk( agents, action, threadIdCopy, chunkSize ) ) );
+			}
+
+			// This thread takes the first chunk rather than sitting waiting
+			RunChunk( agents, action, 0, chunkSize );
+
+			Task.WaitAll( _activeAgentTasks );
+		}
+
+		private static void RunChunk( IList<DtCrowdAgent> agents, Action<DtCrowdAgent, int> action, int threadId, int chunkSize )
+		{
+			int startIdx = threadId * chunkSize;
+			int endIdx = Math.Min( startIdx + chunkSize, agents.Count );
+
+			for ( int agentIdx = startIdx; agentIdx < endIdx; ++agentIdx )
+			{
+				action( agents[agentIdx], threadId );
+			}
 		}
 
 
-		private void CheckPathValidity( DtCrowdAgent ag, float dt )
+		private void CheckPathValidity( DtCrowdAgent ag, float dt, DtNavMeshQuery navQuery )
 		{
 			ag.timeSinceLastRecoveryCheck += dt;
 
@@ -483,7 +547,7 @@ namespace DotRecast.Detour.Crowd
 			{
 				if ( isDriftedFromCorridor ) ag.timeSinceLastRecoveryCheck = 0;
 
-				var status = _navQuery.FindNearestPoly( ag.npos, new Vector3( ag.option.radius ), DtQueryNoOpFilter.Shared, out var refs, out var nearestPt, out var _ );
+				var status = navQuery.FindNearestPoly( ag.npos, new Vector3( ag.option.radius ), DtQueryNoOpFilter.Shared, out var refs, out var nearestPt, out var _ );
 				if ( status.Succeeded() && refs != 0 )
 				{
 					// we come from an invalid state so we reset most of the agent's state
@@ -525,11 +589,11 @@ namespace DotRecast.Detour.Crowd
 			Vector3 agentPos = ag.npos;
 			long agentRef = ag.corridor.GetFirstPoly();
 
-			if ( !_navQuery.IsValidPolyRef( agentRef, ag.option.filter ) )
+			if ( !navQuery.IsValidPolyRef( agentRef, ag.option.filter ) )
 			{
 				// Current location is not valid, try to reposition.
 				// TODO: this can snap agents, how to handle that?
-				_navQuery.FindNearestPoly( ag.npos, _agentPlacementHalfExtents, ag.option.filter, out agentRef, out var nearestPt, out var _ );
+				navQuery.FindNearestPoly( ag.npos, _agentPlacementHalfExtents, ag.option.filter, out agentRef, out var nearestPt, out var _ );
 				agentPos = nearestPt;
 
 				if ( agentRef == 0 )
@@ -564,10 +628,10 @@ namespace DotRecast.Detour.Crowd
 			if ( ag.targetState != DtMoveRequestState.DT_CROWDAGENT_TARGET_NONE
 				&& ag.targetState != DtMoveRequestState.DT_CROWDAGENT_TARGET_FAILED )
 			{
-				if ( !_navQuery.IsValidPolyRef( ag.targetRef, ag.option.filter ) )
+				if ( !navQuery.IsValidPolyRef( ag.targetRef, ag.option.filter ) )
 				{
 					// Current target is not valid, try to reposition.
-					_navQuery.FindNearestPoly( ag.targetPos, _agentPlacementHalfExtents, ag.option.filter, out ag.targetRef, out var nearestPt, out var _ );
+					navQuery.FindNearestPoly( ag.targetPos, _agentPlacementHalfExtents, ag.option.filter, out ag.targetRef, out var nearestPt, out var _ );
 					ag.targetPos = nearestPt;
 					replan = true;
 				}
@@ -582,7 +646,7 @@ namespace DotRecast.Detour.Crowd
 			}
 
 			// If nearby corridor is not valid, replan.
-			if ( !ag.corridor.IsValid( _config.checkLookAhead, _navQuery, ag.option.filter ) )
+			if ( !ag.corridor.IsValid( _config.checkLookAhead, navQuery, ag.option.filter ) )
 			{
 				replan = true;
 			}
@@ -888,38 +952,47 @@ namespace DotRecast.Detour.Crowd
 		{
 			_grid.Clear();
 
+			if ( _partitionKeys.Length < agents.Count )
+			{
+				_partitionKeys = new long[Math.Max( agents.Count, _partitionKeys.Length * 2 )];
+			}
+
+			_partitionedAgents.Clear();
+
 			for ( var i = 0; i < agents.Count; i++ )
 			{
 				var ag = agents[i];
 				Vector3 p = ag.npos;
 				float r = ag.option.radius;
 				_grid.AddItem( ag, p.x - r, p.z - r, p.x + r, p.z + r );
+
+				_partitionKeys[i] = _grid.GetCellKey( p.x, p.z );
+				_partitionedAgents.Add( ag );
 			}
+
+			// Agents in the same cell end up in the same chunk, and so do most of their neighbours
+			_partitionKeys.AsSpan( 0, agents.Count ).Sort( CollectionsMarshal.AsSpan( _partitionedAgents ) );
 		}
 
-		private void BuildNeighbours( IList<DtCrowdAgent> agents )
+		private void BuildNeighbours( DtCrowdAgent ag, DtNavMeshQuery navQuery )
 		{
-			for ( var i = 0; i < agents.Count; i++ )
+			if ( ag.state != DtCrowdAgentState.DT_CROWDAGENT_STATE_WALKING )
 			{
-				var ag = agents[i];
-				if ( ag.state != DtCrowdAgentState.DT_CROWDAGENT_STATE_WALKING )
-				{
-					continue;
-				}
-
-				// Update the collision boundary after certain distance has been passed or
-				// if it has become invalid.
-				float updateThr = ag.option.collisionQueryRange * 0.25f;
-				float updateThrSqr = updateThr * updateThr;
-				if ( DtUtils.DistanceBetween2DSqr( ag.npos, ag.boundary.GetCenter() ) > updateThrSqr
-					|| !ag.boundary.IsValid( _navQuery, ag.option.filter ) )
-				{
-					ag.boundary.Update( ag.corridor.GetFirstPoly(), ag.npos, ag.option.collisionQueryRange, _navQuery, ag.option.filter );
-				}
+				return;
+			}
 
-				// Query neighbour agents
-				ag.nneis = GetNeighbours( ag.npos, ag.option.height, ag.option.collisionQueryRange, ag, ag.neis, DtCrowdConst.DT_CROWDAGENT_MAX_NEIGHBOURS, _grid );
+			// Update the collision boundary after certain distance has been passed or
+			// if it has become invalid.
+			float updateThr = ag.option.collisionQueryRange * 0.25f;
+			float updateThrSqr = updateThr * updateThr;
+			if ( DtUtils.DistanceBetween2DSqr( ag.npos, ag.boundary.GetCenter() ) > updateThrSqr
+				|| !ag.boundary.IsValid( navQuery, ag.option.filter ) )
+			{
+				ag.boundary.Update( ag.corridor.GetFirstPoly(), ag.npos, ag.option.collisionQueryRange, navQuery, ag.option.filter );
 			}
+
+			// Query neighbour agents
+			ag.nneis = GetNeighbours( ag.npos, ag.option.height, ag.option.collisionQueryRange, ag, ag.neis, DtCrowdConst.DT_CROWDAGENT_MAX_NEIGHBOURS, _grid );
 		}
 
 		public static int AddNeighbour( DtCrowdAgent idx, float dist, Span<DtCrowdNeighbour> neis, int nneis, int maxNeis )
@@ -1004,19 +1077,16 @@ namespace DotRecast.Detour.Crowd
 			return n;
 		}
 
-		private void FindCorners( IList<DtCrowdAgent> agents )
+		private void FindCorners( DtCrowdAgent ag, DtNavMeshQuery navQuery )
 		{
-			foreach ( var ag in agents )
+			if ( ag.targetState == DtMoveRequestState.DT_CROWDAGENT_TARGET_NONE
+			|| ag.targetState == DtMoveRequestState.DT_CROWDAGENT_TARGET_VELOCITY )
 			{
-				if ( ag.targetState == DtMoveRequestState.DT_CROWDAGENT_TARGET_NONE
-				|| ag.targetState == DtMoveRequestState.DT_CROWDAGENT_TARGET_VELOCITY )
-				{
-					continue;
-				}
-
-				// Find corners for steering
-				ag.ncorners = ag.corridor.FindCorners( ag.corners, DtCrowdConst.DT_CROWDAGENT_MAX_CORNERS, _navQuery, ag.option.filter );
+				return;
 			}
+
+			// Find corners for steering
+			ag.ncorners = ag.corridor.FindCorners( ag.corners, DtCrowdConst.DT_CROWDAGENT_MAX_CORNERS, navQuery, ag.option.filter );
 		}
 
 		private void TriggerOffMeshConnections( IList<DtCrowdAgent> agents )
@@ -1235,100 +1305,98 @@ namespace DotRecast.Detour.Crowd
 		{
 			for ( int iter = 0; iter < 4; ++iter )
 			{
+				// Displacements are all worked out from this iteration's positions before any are applied
+				ForEachAgent( agents, ( ag, worker ) => CalculateCollisionDisplacement( ag ) );
+
 				for ( var i = 0; i < agents.Count; i++ )
 				{
 					var ag = agents[i];
-					long idx0 = ag.idx;
 					if ( ag.state != DtCrowdAgentState.DT_CROWDAGENT_STATE_WALKING )
 					{
 						continue;
 					}
 
-					ag.disp = Vector3.Zero;
-
-					float w = 0;
-
-					for ( int j = 0; j < ag.nneis; ++j )
-					{
-						DtCrowdAgent nei = ag.neis[j].agent;
-						long idx1 = nei.idx;
-						Vector3 diff = ag.npos - nei.npos;
-						diff.y = 0;
-
-						float distSqr = diff.LengthSquared;
-						if ( distSqr > (ag.option.radius + nei.option.radius) * (ag.option.radius + nei.option.radius) )
-						{
-							continue;
-						}
+					ag.npos = ag.npos + ag.disp;
+				}
+			}
+		}
 
-						var dist = MathF.Sqrt( distSqr );
-						float pen = (ag.option.radius + nei.option.radius) - dist;
-						if ( dist < 0.0001f )
-						{
-							// Agents on top of each other, try to choose diverging separation directions.
-							if ( idx0 > idx1 )
-							{
-								diff = new Vector3( -ag.dvel.z, 0, ag.dvel.x );
-							}
-							else
-							{
-								diff = new Vector3( ag.dvel.z, 0, -ag.dvel.x );
-							}
+		private void CalculateCollisionDisplacement( DtCrowdAgent ag )
+		{
+			long idx0 = ag.idx;
+			if ( ag.state != DtCrowdAgentState.DT_CROWDAGENT_STATE_WALKING )
+			{
+				return;
+			}
 
-							pen = 0.01f;
-						}
-						else
-						{
-							pen = (1.0f / dist) * (pen * 0.5f) * _config.collisionResolveFactor;
-						}
+			ag.disp = Vector3.Zero;
 
-						ag.disp = ag.disp + diff * pen;
+			float w = 0;
 
-						w += 1.0f;
-					}
+			for ( int j = 0; j < ag.nneis; ++j )
+			{
+				DtCrowdAgent nei = ag.neis[j].agent;
+				long idx1 = nei.idx;
+				Vector3 diff = ag.npos - nei.npos;
+				diff.y = 0;
 
-					if ( w > 0.0001f )
-					{
-						float iw = 1.0f / w;
-						ag.disp = ag.disp * iw;
-					}
+				float distSqr = diff.LengthSquared;
+				if ( distSqr > (ag.option.radius + nei.option.radius) * (ag.option.radius + nei.option.radius) )
+				{
+					continue;
 				}
 
-				for ( var i = 0; i < agents.Count; i++ )
+				var dist = MathF.Sqrt( distSqr );
+				float pen = (ag.option.radius + nei.option.radius) - dist;
+				if ( dist < 0.0001f )
 				{
-					var ag = agents[i];
-					if ( ag.state != DtCrowdAgentState.DT_CROWDAGENT_STATE_WALKING )
+					// Agents on top of each other, try to choose diverging separation directions.
+					if ( idx0 > idx1 )
 					{
-						continue;
+						diff = new Vector3( -ag.dvel.z, 0, ag.dvel.x );
+					}
+					else
+					{
+						diff = new Vector3( ag.dvel.z, 0, -ag.dvel.x );
 					}
 
-					ag.npos = ag.npos + ag.disp;
+					pen = 0.01f;
+				}
+				else
+				{
+					pen = (1.0f / dist) * (pen * 0.5f) * _config.collisionResolveFactor;
 				}
+
+				ag.disp = ag.disp + diff * pen;
+
+				w += 1.0f;
+			}
+
+			if ( w > 0.0001f )
+			{
+				float iw = 1.0f / w;
+				ag.disp = ag.disp * iw;
 			}
 		}
 
-		private void MoveAgents( IList<DtCrowdAgent> agents )
+		private void MoveAgent( DtCrowdAgent ag, DtNavMeshQuery navQuery )
 		{
-			for ( var i = 0; i < agents.Count; i++ )
+			if ( ag.state != DtCrowdAgentState.DT_CROWDAGENT_STATE_WALKING )
 			{
-				var ag = agents[i];
-				if ( ag.state != DtCrowdAgentState.DT_CROWDAGENT_STATE_WALKING )
-				{
-					continue;
-				}
+				return;
+			}
 
-				// Move along navmesh.
-				ag.corridor.MovePosition( ag.npos, _navQuery, ag.option.filter );
-				// Get valid constrained position back.
-				ag.npos = ag.corridor.GetPos();
+			// Move along navmesh.
+			ag.corridor.MovePosition( ag.npos, navQuery, ag.option.filter );
+			// Get valid constrained position back.
+			ag.npos = ag.corridor.GetPos();
 
-				// If not using path, truncate the corridor to just one poly.
-				if ( ag.targetState == DtMoveRequestState.DT_CROWDAGENT_TARGET_NONE
-					|| ag.targetState == DtMoveRequestState.DT_CROWDAGENT_TARGET_VELOCITY )
-				{
-					ag.corridor.Reset( ag.corridor.GetFirstPoly(), ag.npos );
-					ag.partial = false;
-				}
+			// If not using path, truncate the corridor to just one poly.
+			if ( ag.targetState == DtMoveRequestState.DT_CROWDAGENT_TARGET_NONE
+				|| ag.targetState == DtMoveRequestState.DT_CROWDAGENT_TARGET_VELOCITY )
+			{
+				ag.corridor.Reset( ag.corridor.GetFirstPoly(), ag.npos );
+				ag.partial = false;
 			}
 		}
 
@@ -35,7 +35,8 @@ namespace DotRecast.Detour.Crowd
 		public float collisionResolveFactor = 0.7f;
 		public int maxObstacleAvoidanceCircles = 12; // Max number of neighbour agents to consider in obstacle avoidance processing
 		public int maxObstacleAvoidanceSegments = 16; // Max number of neighbour segments to consider in obstacle avoidance processing
-		public int obstacleAvoidanceParallelism = Math.Max( (Environment.ProcessorCount / 2) - 1, 1 ); // Number of parallel obstacle avoidance threads
+		public int obstacleAvoidanceParallelism = Math.Max( (Environment.ProcessorCount / 2) - 1, 1 ); // Number of threads used by the parallel crowd update phases
+		public int minAgentsPerThread = 16; // Min number of agents to give each thread, fewer than this isn't worth the overhead of a task
 		public IDtQueryFilter defaultFilter;
 
 		public DtCrowdConfig( float maxAgentRadius, float maxAgentHeight )
@@ -0,0 +1,52 @@
+using System.Diagnostics;
+
+namespace DotRecast.Detour.Crowd
+{
+	/// The phases of #DtCrowd::Update that are timed.
+	/// @ingroup crowd
+	internal enum DtCrowdTimerLabel
+	{
+		CheckPathValidity,
+		UpdateMoveRequest,
+		UpdateTopologyOptimization,
+		BuildProximityGrid,
+		BuildNeighbours,
+		FindCorners,
+		TriggerOffMeshConnections,
+		CalculateSteering,
+		PlanVelocity,
+		Integrate,
+		HandleCollisions,
+		MoveAgents,
+		UpdateOffMeshConnections,
+	}
+
+	/// How long each phase of the last #DtCrowd::Update took.
+	/// @ingroup crowd
+	internal class DtCrowdTelemetry
+	{
+		public static readonly DtCrowdTimerLabel[] Labels = Enum.GetValues<DtCrowdTimerLabel>();
+
+		private readonly long[] _ticks = new long[Labels.Length];
+		private long _start;
+
+		public void Start()
+		{
+			Array.Clear( _ticks );
+			_start = Stopwatch.GetTimestamp();
+		}
+
+		/// Time everything since the last call to #Start or #Mark against @p label.
+		public void Mark( DtCrowdTimerLabel label )
+		{
+			var now = Stopwatch.GetTimestamp();
+			_ticks[(int)label] += now - _start;
+			_start = now;
+		}
+
+		public double GetMilliseconds( DtCrowdTimerLabel label )
+		{
+			return _ticks[(int)label] * (1_000.0 / Stopwatch.Frequency);
+		}
+	}
+}
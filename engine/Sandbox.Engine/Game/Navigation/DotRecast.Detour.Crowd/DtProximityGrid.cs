@@ -53,6 +53,13 @@ namespace DotRecast.Detour.Crowd
 			y = (int)uy;
 		}
 
+		/// The key of the cell containing the point.
+		[MethodImpl( MethodImplOptions.AggressiveInlining )]
+		public long GetCellKey( float x, float y )
+		{
+			return CombineKey( (int)MathF.Floor( x * _invCellSize ), (int)MathF.Floor( y * _invCellSize ) );
+		}
+
 		[MethodImpl( MethodImplOptions.AggressiveInlining )]
 		public void Clear()
 		{
@@ -3,7 +3,7 @@ namespace DotRecast.Detour
 	internal class DtFindNearestPolyQuery : IDtPolyQuery
 	{
 		private readonly DtNavMeshQuery _query;
-		private readonly Vector3 _center;
+		private Vector3 _center;
 		private float _nearestDistanceSqr;
 		private long _nearestRef;
 		private Vector3 _nearestPoint;
@@ -12,9 +12,17 @@ namespace DotRecast.Detour
 		public DtFindNearestPolyQuery( DtNavMeshQuery query, Vector3 center )
 		{
 			_query = query;
+			Reset( center );
+		}
+
+		/// Start a new search around @p center, so one query can be reused.
+		public void Reset( Vector3 center )
+		{
 			_center = center;
 			_nearestDistanceSqr = float.MaxValue;
+			_nearestRef = 0;
 			_nearestPoint = center;
+			_overPoly = false;
 		}
 
 		public void Process( DtMeshTile tile, Span<long> refs, int count )
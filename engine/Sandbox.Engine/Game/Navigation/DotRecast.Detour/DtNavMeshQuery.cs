@@ -36,6 +36,9 @@ namespace DotRecast.Detour
 		protected readonly DtNodeQueue m_openList; //< Pointer to open list queue. 
 		protected readonly HashSet<int> m_visitedNodesCache;
 
+		private readonly DtFindNearestPolyQuery m_nearestPolyQuery; //< Reused by FindNearestPoly.
+		private readonly DtMeshTile[] m_queryTiles = new DtMeshTile[32]; //< Tile scratch for QueryPolygons.
+
 		//////////////////////////////////////////////////////////////////////////////////////////
 
 		/// @class dtNavMeshQuery
@@ -60,7 +63,7 @@ namespace DotRecast.Detour
 			m_openList = new DtNodeQueue();
 			m_tinyNodePool = new DtNodePool();
 			m_visitedNodesCache = new HashSet<int>();
-
+			m_nearestPolyQuery = new DtFindNearestPolyQuery( this, Vector3.Zero );
 		}
 
 		/// Returns random location on navmesh.
@@ -573,7 +576,8 @@ namespace DotRecast.Detour
 			isOverPoly = false;
 
 			// Get nearby polygons from proximity grid.
-			DtFindNearestPolyQuery query = new DtFindNearestPolyQuery( this, center );
+			DtFindNearestPolyQuery query = m_nearestPolyQuery;
+			query.Reset( center );
 			DtStatus status = QueryPolygons( center, halfExtents, filter, query );
 			if ( status.Failed() )
 			{
@@ -778,8 +782,8 @@ namespace DotRecast.Detour
 			m_nav.CalcTileLoc( bmin, out var minx, out var miny );
 			m_nav.CalcTileLoc( bmax, out var maxx, out var maxy );
 
-			const int MAX_NEIS = 32;
-			DtMeshTile[] neis = new DtMeshTile[MAX_NEIS];
+			DtMeshTile[] neis = m_queryTiles;
+			int MAX_NEIS = neis.Length;
 
 			for ( int y = miny; y <= maxy; ++y )
 			{
@@ -869,8 +873,9 @@ namespace DotRecast.Detour
 			DtNode lastBestNode = startNode;
 			float lastBestNodeCost = startNode.total;
 
+			// Only any-angle searches raycast, so don't allocate the hit path otherwise
 			DtRaycastHit rayHit = new DtRaycastHit();
-			rayHit.path = new List<long>();
+			rayHit.path = (options & DtFindPathOptions.DT_FINDPATH_ANY_ANGLE) != 0 ? new List<long>() : null;
 			while ( !m_openList.IsEmpty() )
 			{
 				// Remove node from open list and put it in closed list.
@@ -1156,8 +1161,9 @@ namespace DotRecast.Detour
 				return DtStatus.DT_FAILURE;
 			}
 
+			// Only any-angle searches raycast, so don't allocate the hit path otherwise
 			var rayHit = new DtRaycastHit();
-			rayHit.path = new List<long>();
+			rayHit.path = (m_query.options & DtFindPathOptions.DT_FINDPATH_ANY_ANGLE) != 0 ? new List<long>() : null;
 
 			int iter = 0;
 			while ( iter < maxIter && !m_openList.IsEmpty() )
@@ -28,14 +28,24 @@ namespace DotRecast.Detour
 		private int m_nodeCount;
 		private readonly List<DtNode> m_nodes;
 
+		// Per-poly node lists from previous searches, reused so a search doesn't allocate once the pool has warmed up.
+		private readonly Stack<List<DtNode>> m_freeLists;
+
 		public DtNodePool()
 		{
 			m_map = new Dictionary<long, List<DtNode>>();
 			m_nodes = new List<DtNode>();
+			m_freeLists = new Stack<List<DtNode>>();
 		}
 
 		public void Clear()
 		{
+			foreach ( var nodes in m_map.Values )
+			{
+				nodes.Clear();
+				m_freeLists.Push( nodes );
+			}
+
 			m_map.Clear();
 			m_nodeCount = 0;
 		}
@@ -82,7 +92,7 @@ namespace DotRecast.Detour
 			}
 			else
 			{
-				nodes = new List<DtNode>();
+				nodes = m_freeLists.Count > 0 ? m_freeLists.Pop() : new List<DtNode>();
 				m_map.Add( id, nodes );
 			}
 
@@ -1,4 +1,5 @@
 ﻿using System.Buffers;
+using System.Numerics;
 
 namespace Sandbox.Navigation.Generation;
 
@@ -19,7 +20,9 @@ internal static class AreaFilter
 
 		using var pooledDistanceToBoundary = new PooledSpan<byte>( compactHeightfield.SpanCount * 2 );
 		Span<byte> distanceToBoundary = pooledDistanceToBoundary.Span;
-		distanceToBoundary.Fill( 0xFF );
+
+		// Null spans are the boundary, everything else starts as far away as possible
+		InitDistanceToBoundary( compactHeightfield.Areas, distanceToBoundary );
 
 		// Mark boundary cells
 		for ( int z = 0; z < zSize; ++z )
@@ -30,11 +33,8 @@ internal static class AreaFilter
 				for ( int spanIndex = cell.Index, maxSpanIndex = (cell.Index + cell.Count);
 					spanIndex < maxSpanIndex; ++spanIndex )
 				{
-					if ( compactHeightfield.Areas[spanIndex] == Constants.NULL_AREA )
-					{
-						distanceToBoundary[spanIndex] = 0;
+					if ( distanceToBoundary[spanIndex] == 0 )
 						continue;
-					}
 
 					CompactSpan span = compactHeightfield.Spans[spanIndex];
 
@@ -207,13 +207,84 @@ internal static class AreaFilter
 
 		// Mark non-walkable areas based on distance
 		byte minBoundaryDistance = (byte)(erosionRadius * 2);
-		for ( int spanIndex = 0; spanIndex < compactHeightfield.SpanCount; ++spanIndex )
+		ClearNearBoundary( distanceToBoundary, compactHeightfield.Areas, minBoundaryDistance );
+	}
+
+	/// <summary>
+	/// Set the distance of null area spans to 0 and all the others to 0xFF, many spans at a time.
+	/// </summary>
+	private static void InitDistanceToBoundary( ReadOnlySpan<int> areas, Span<byte> distanceToBoundary )
+	{
+		int i = 0;
+
+		if ( Vector.IsHardwareAccelerated )
+		{
+			int intLanes = Vector<int>.Count;
+			var nullArea = new Vector<int>( Constants.NULL_AREA );
+
+			for ( ; i <= areas.Length - Vector<byte>.Count; i += Vector<byte>.Count )
+			{
+				// All ones where the area is null, narrowed down to a byte per span
+				var a = Vector.Equals( new Vector<int>( areas[i..] ), nullArea );
+				var b = Vector.Equals( new Vector<int>( areas[(i + intLanes)..] ), nullArea );
+				var c = Vector.Equals( new Vector<int>( areas[(i + intLanes * 2)..] ), nullArea );
+				var d = Vector.Equals( new Vector<int>( areas[(i + intLanes * 3)..] ), nullArea );
+
+				var isNull = Vector.Narrow( Vector.Narrow( a, b ), Vector.Narrow( c, d ) );
+
+				Vector.AsVectorByte( ~isNull ).CopyTo( distanceToBoundary[i..] );
+			}
+		}
+
+		for ( ; i < areas.Length; ++i )
+		{
+			distanceToBoundary[i] = areas[i] == Constants.NULL_AREA ? (byte)0 : (byte)0xFF;
+		}
+	}
+
+	/// <summary>
+	/// Clear the area of every span closer than <paramref name="minDistance"/> to the boundary, many spans at a time.
+	/// </summary>
+	private static void ClearNearBoundary( ReadOnlySpan<byte> distanceToBoundary, Span<int> areas, byte minDistance )
+	{
+		int i = 0;
+
+		if ( Vector.IsHardwareAccelerated )
 		{
-			if ( distanceToBoundary[spanIndex] < minBoundaryDistance )
+			int intLanes = Vector<int>.Count;
+			var min = new Vector<byte>( minDistance );
+			var nullArea = new Vector<int>( Constants.NULL_AREA );
+
+			for ( ; i <= areas.Length - Vector<byte>.Count; i += Vector<byte>.Count )
 			{
-				compactHeightfield.Areas[spanIndex] = Constants.NULL_AREA;
+				var near = Vector.LessThan( new Vector<byte>( distanceToBoundary[i..] ), min );
+				if ( near == Vector<byte>.Zero )
+					continue;
+
+				// Sign extend so every lane is still all ones or all zeros once it's an int
+				Vector.Widen( Vector.AsVectorSByte( near ), out Vector<short> low, out Vector<short> high );
+				Vector.Widen( low, out Vector<int> a, out Vector<int> b );
+				Vector.Widen( high, out Vector<int> c, out Vector<int> d );
+
+				ClearWhere( areas.Slice( i, intLanes ), a, nullArea );
+				ClearWhere( areas.Slice( i + intLanes, intLanes ), b, nullArea );
+				ClearWhere( areas.Slice( i + intLanes * 2, intLanes ), c, nullArea );
+				ClearWhere( areas.Slice( i + intLanes * 3, intLanes ), d, nullArea );
 			}
 		}
+
+		for ( ; i < areas.Length; ++i )
+		{
+			if ( distanceToBoundary[i] < minDistance )
+			{
+				areas[i] = Constants.NULL_AREA;
+			}
+		}
+	}
+
+	private static void ClearWhere( Span<int> areas, Vector<int> mask, Vector<int> nullArea )
+	{
+		Vector.ConditionalSelect( mask, nullArea, new Vector<int>( areas ) ).CopyTo( areas );
 	}
 
 	/// <summary>
@@ -0,0 +1,186 @@
+﻿using NativeEngine;
+using System.Runtime.InteropServices;
+
+namespace Sandbox.Navigation.Generation;
+
+/// <summary>
+/// The navmesh relevant physics geometry for a batch of tiles, triangulated and copied out of the physics world.
+/// Capturing has to happen on the main thread, but tiles can then collect their geometry from it on any thread.
+/// </summary>
+[SkipHotload]
+internal sealed class GeometrySnapshot
+{
+	struct ShapeGeometry
+	{
+		public BBox Bounds;
+		public int FirstVertex;
+		public int VertexCount;
+		public int FirstIndex;
+		public int IndexCount;
+	}
+
+	readonly List<ShapeGeometry> _shapes = new();
+	readonly List<Vector3> _vertices = new();
+	readonly List<int> _indices = new();
+
+	readonly List<BBox> _areas = new();
+	readonly List<List<int>> _areaShapes = new();
+
+	public int ShapeCount => _shapes.Count;
+
+	/// <summary>
+	/// The shapes triangulated for an area passed to <see cref="Capture"/>. Each area has its own triangulation
+	/// of a shape, clipped to that area, so a shape found in several areas is in here several times.
+	/// </summary>
+	public IReadOnlyList<int> GetShapes( BBox area )
+	{
+		var index = _areas.IndexOf( area );
+		if ( index < 0 )
+			throw new ArgumentException( "Area wasn't captured in this snapshot", nameof( area ) );
+
+		return _areaShapes[index];
+	}
+
+	/// <summary>
+	/// World space bounds of a shape's triangulation.
+	/// </summary>
+	public BBox GetBounds( int shape ) => _shapes[shape].Bounds;
+
+	/// <summary>
+	/// World space vertices of a shape.
+	/// </summary>
+	public ReadOnlySpan<Vector3> GetVertices( int shape )
+	{
+		var s = _shapes[shape];
+		return CollectionsMarshal.AsSpan( _vertices ).Slice( s.FirstVertex, s.VertexCount );
+	}
+
+	/// <summary>
+	/// Triangle indices of a shape, relative to its first vertex and already wound the way the generator wants.
+	/// </summary>
+	public ReadOnlySpan<int> GetIndices( int shape )
+	{
+		var s = _shapes[shape];
+		return CollectionsMarshal.AsSpan( _indices ).Slice( s.FirstIndex, s.IndexCount );
+	}
+
+	/// <summary>
+	/// Query the physics world once for every area and triangulate each shape found, clipped to that area.
+	/// </summary>
+	public static GeometrySnapshot Capture( NavMesh navMesh, PhysicsWorld world, IReadOnlyList<BBox> areas )
+	{
+		ThreadSafe.AssertIsMainThread();
+
+		var snapshot = new GeometrySnapshot();
+
+		if ( !world.IsValid() || areas.Count == 0 )
+			return snapshot;
+
+		// Shapes are often found in more than one area, only check each body once
+		var relevant = new Dictionary<PhysicsShape, bool>();
+
+		var vertCache = CUtlVectorVector.Create( 0, 512 );
+		var indexCache = CUtlVectorUInt32.Create( 0, 1024 );
+
+		try
+		{
+			foreach ( var area in areas )
+			{
+				if ( snapshot._areas.Contains( area ) )
+					continue;
+
+				var areaShapes = new List<int>();
+				snapshot._areas.Add( area );
+				snapshot._areaShapes.Add( areaShapes );
+
+				var results = CQueryResult.Create();
+
+				try
+				{
+					world.native.Query( results, area, 0x07 );
+
+					for ( int i = 0; i < results.Count(); i++ )
+					{
+						var shape = results.Element( i );
+						if ( !shape.IsValid() )
+							continue;
+
+						if ( !relevant.TryGetValue( shape, out var isRelevant ) )
+						{
+							var body = shape.Body;
+							isRelevant = body.IsValid() && navMesh.IsBodyRelevantForNavmesh( body );
+							relevant.Add( shape, isRelevant );
+						}
+
+						if ( !isRelevant )
+							continue;
+
+						if ( snapshot.AddShape( shape, area, vertCache, indexCache ) )
+							areaShapes.Add( snapshot._shapes.Count - 1 );
+					}
+				}
+				finally
+				{
+					results.DeleteThis();
+				}
+			}
+		}
+		finally
+		{
+			vertCache.DeleteThis();
+			indexCache.DeleteThis();
+		}
+
+		return snapshot;
+	}
+
+	bool AddShape( PhysicsShape shape, BBox area, CUtlVectorVector vertCache, CUtlVectorUInt32 indexCache )
+	{
+		vertCache.SetCount( 0 );
+		indexCache.SetCount( 0 );
+
+		shape.native.GetTriangulationForNavmesh( vertCache, indexCache, area );
+
+		var vertexCount = vertCache.Count();
+		var indexCount = indexCache.Count();
+
+		if ( vertexCount < 3 || indexCount < 3 )
+			return false;
+
+		var geometry = new ShapeGeometry
+		{
+			FirstVertex = _vertices.Count,
+			VertexCount = vertexCount,
+			FirstIndex = _indices.Count,
+			IndexCount = indexCount,
+		};
+
+		var bodyTransform = shape.Body.Transform;
+		var mins = new Vector3( float.MaxValue );
+		var maxs = new Vector3( float.MinValue );
+
+		for ( int v = 0; v < vertexCount; v++ )
+		{
+			var position = bodyTransform.PointToWorld( vertCache.Element( v ) );
+
+			mins = Vector3.Min( mins, position );
+			maxs = Vector3.Max( maxs, position );
+
+			_vertices.Add( position );
+		}
+
+		for ( int i = 0; i + 2 < indexCount; i += 3 )
+		{
+			// invert winding
+			_indices.Add( (int)indexCache.Element( i + 0 ) );
+			_indices.Add( (int)indexCache.Element( i + 2 ) );
+			_indices.Add( (int)indexCache.Element( i + 1 ) );
+		}
+
+		geometry.IndexCount = _indices.Count - geometry.FirstIndex;
+		geometry.Bounds = new BBox( mins, maxs );
+
+		_shapes.Add( geometry );
+		return true;
+	}
+}
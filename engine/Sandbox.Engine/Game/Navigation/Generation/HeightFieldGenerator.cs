@@ -1,4 +1,5 @@
 ﻿using NativeEngine;
+using Sandbox.Hashing;
 using System.Buffers;
 using System.Runtime.InteropServices;
 
@@ -19,17 +20,11 @@ class HeightFieldGenerator : IDisposable
 
 	Heightfield cachedHeightField;
 
-	CUtlVectorVector triangulationVertArrCache = CUtlVectorVector.Create( 0, 512 );
-	CUtlVectorUInt32 triangulationIndexArrCache = CUtlVectorUInt32.Create( 0, 1024 );
-
 	public void Dispose()
 	{
 		cachedHeightField?.Dispose();
 		cachedHeightField = null;
 
-		triangulationVertArrCache.DeleteThis();
-		triangulationIndexArrCache.DeleteThis();
-
 		if ( inputGeoVertices != null )
 		{
 			ArrayPool<Vector3>.Shared.Return( inputGeoVertices );
@@ -59,80 +54,107 @@ class HeightFieldGenerator : IDisposable
 		if ( !world.IsValid() )
 			return;
 
-		var results = CQueryResult.Create();
-		world.native.Query( results, tileBoundsWorld, 0x07 );
+		CollectGeometry( GeometrySnapshot.Capture( navMesh, world, [tileBoundsWorld] ), tileBoundsWorld );
+	}
 
+	/// <summary>
+	/// Collect the triangles overlapping the tile from a snapshot of the physics world, which has to have been
+	/// captured with <paramref name="tileBoundsWorld"/> as one of its areas.
+	/// Unlike querying the world, this is safe to do from any thread.
+	/// </summary>
+	public void CollectGeometry( GeometrySnapshot snapshot, BBox tileBoundsWorld )
+	{
 		// clear arrays
 		inputGeoVerticesCount = 0;
 		inputGeoIndicesCount = 0;
 
-		for ( int i = 0; i < results.Count(); i++ )
+		var shapes = snapshot.GetShapes( tileBoundsWorld );
+
+		for ( int s = 0; s < shapes.Count; s++ )
 		{
-			var shape = results.Element( i );
-			if ( !shape.IsValid() )
-				continue;
+			var i = shapes[s];
 
-			var body = shape.Body;
-			if ( !body.IsValid() )
+			if ( !snapshot.GetBounds( i ).Overlaps( tileBoundsWorld ) )
 				continue;
 
-			if ( !navMesh.IsBodyRelevantForNavmesh( body ) )
+			AddGeometry( snapshot.GetVertices( i ), snapshot.GetIndices( i ), tileBoundsWorld );
+		}
+	}
+
+	/// <summary>
+	/// Add the triangles of a world space mesh that overlap the bounds, and only the vertices they use.
+	/// </summary>
+	void AddGeometry( ReadOnlySpan<Vector3> vertices, ReadOnlySpan<int> indices, BBox bounds )
+	{
+		EnsureCapacity( vertices.Length, indices.Length );
+
+		using var pooledRemap = new PooledSpan<int>( vertices.Length );
+		var remap = pooledRemap.Span;
+		remap.Fill( -1 );
+
+		for ( int i = 0; i + 2 < indices.Length; i += 3 )
+		{
+			var a = vertices[indices[i + 0]];
+			var b = vertices[indices[i + 1]];
+			var c = vertices[indices[i + 2]];
+
+			var triangleBounds = new BBox( Vector3.Min( a, Vector3.Min( b, c ) ), Vector3.Max( a, Vector3.Max( b, c ) ) );
+			if ( !triangleBounds.Overlaps( bounds ) )
 				continue;
 
-			AddGeometryFromPhysicsShape( shape );
+			for ( int k = 0; k < 3; k++ )
+			{
+				var index = indices[i + k];
 
-		}
+				if ( remap[index] < 0 )
+				{
+					var vertexWorldPos = vertices[index];
 
-		results.DeleteThis();
-	}
+					if ( vertexWorldPos.z > inputGeometryMaxZ ) inputGeometryMaxZ = vertexWorldPos.z;
+					if ( vertexWorldPos.z < inputGeometryMinZ ) inputGeometryMinZ = vertexWorldPos.z;
 
-	internal void AddGeometryFromPhysicsShape( PhysicsShape shape )
-	{
-		triangulationVertArrCache.SetCount( 0 );
-		triangulationIndexArrCache.SetCount( 0 );
+					remap[index] = inputGeoVerticesCount;
+					inputGeoVertices[inputGeoVerticesCount++] = NavMesh.ToNav( vertexWorldPos );
+				}
 
-		shape.native.GetTriangulationForNavmesh( triangulationVertArrCache, triangulationIndexArrCache, cfg.Bounds );
+				inputGeoIndices[inputGeoIndicesCount++] = remap[index];
+			}
+		}
+	}
 
-		if ( inputGeoVerticesCount + triangulationVertArrCache.Count() > inputGeoVertices.Length )
+	void EnsureCapacity( int vertexCount, int indexCount )
+	{
+		if ( inputGeoVerticesCount + vertexCount > inputGeoVertices.Length )
 		{
-			var newVerts = ArrayPool<Vector3>.Shared.Rent( (inputGeoVerticesCount + triangulationVertArrCache.Count()) * 2 );
+			var newVerts = ArrayPool<Vector3>.Shared.Rent( (inputGeoVerticesCount + vertexCount) * 2 );
 			Array.Copy( inputGeoVertices, newVerts, inputGeoVerticesCount );
 			ArrayPool<Vector3>.Shared.Return( inputGeoVertices );
 			inputGeoVertices = newVerts;
 		}
-		if ( inputGeoIndicesCount + triangulationIndexArrCache.Count() > inputGeoIndices.Length )
+		if ( inputGeoIndicesCount + indexCount > inputGeoIndices.Length )
 		{
-			var newIndices = ArrayPool<int>.Shared.Rent( (inputGeoIndicesCount + triangulationIndexArrCache.Count()) * 2 );
+			var newIndices = ArrayPool<int>.Shared.Rent( (inputGeoIndicesCount + indexCount) * 2 );
 			Array.Copy( inputGeoIndices, newIndices, inputGeoIndicesCount );
 			ArrayPool<int>.Shared.Return( inputGeoIndices );
 			inputGeoIndices = newIndices;
 		}
+	}
 
-		int startV = inputGeoVerticesCount;
-
-		for ( int i = 0; i < triangulationIndexArrCache.Count(); i += 3 )
-		{
-			// invert winding and increment by startV
-			var idx0 = triangulationIndexArrCache.Element( i + 0 );
-			var idx1 = triangulationIndexArrCache.Element( i + 1 );
-			var idx2 = triangulationIndexArrCache.Element( i + 2 );
-
-			inputGeoIndices[inputGeoIndicesCount++] = (int)idx0 + startV;
-			inputGeoIndices[inputGeoIndicesCount++] = (int)idx2 + startV;
-			inputGeoIndices[inputGeoIndicesCount++] = (int)idx1 + startV;
-		}
-
-		// Transform positions added to the vertex data
-		var bodyTransform = shape.Body.Transform;
-		for ( int v = 0; v < triangulationVertArrCache.Count(); ++v )
-		{
-			var vertexWorldPos = bodyTransform.PointToWorld( triangulationVertArrCache.Element( v ) );
+	/// <summary>
+	/// Hash of the collected geometry and the generation settings. If two tiles have the same hash
+	/// they'll generate the same navmesh, barring areas and links.
+	/// </summary>
+	public ulong GetGeometryHash()
+	{
+		var hash = new XxHash3();
+		hash.Append( MemoryMarshal.AsBytes( inputGeoVertices.AsSpan( 0, inputGeoVerticesCount ) ) );
+		hash.Append( MemoryMarshal.AsBytes( inputGeoIndices.AsSpan( 0, inputGeoIndicesCount ) ) );
+		hash.Append( MemoryMarshal.AsBytes( new ReadOnlySpan<Config>( in cfg ) ) );
 
-			if ( vertexWorldPos.z > inputGeometryMaxZ ) inputGeometryMaxZ = vertexWorldPos.z;
-			if ( vertexWorldPos.z < inputGeometryMinZ ) inputGeometryMinZ = vertexWorldPos.z;
+		var result = hash.GetCurrentHashAsUInt64();
 
-			inputGeoVertices[inputGeoVerticesCount++] = NavMesh.ToNav( vertexWorldPos );
-		}
+		// 0 means not generated
+		return result == 0 ? 1 : result;
 	}
 
 	public CompactHeightfield Generate()
@@ -1,4 +1,5 @@
-﻿using System.Runtime.CompilerServices;
+﻿using System.Numerics;
+using System.Runtime.CompilerServices;
 
 namespace Sandbox.Navigation.Generation;
 
@@ -14,7 +15,64 @@ internal static class InputFilter
 
 		float walkableThr = MathF.Cos( walkableSlopeAngle / 180.0f * MathF.PI );
 
-		for ( int i = 0; i < tris.Length / 3; i++ )
+		int numTris = tris.Length / 3;
+		int i = 0;
+
+		if ( Vector.IsHardwareAccelerated )
+		{
+			int lanes = Vector<float>.Count;
+
+			// Triangle edges gathered a lane per triangle
+			Span<float> edges = stackalloc float[lanes * 6];
+			var e0x = edges.Slice( lanes * 0, lanes );
+			var e0y = edges.Slice( lanes * 1, lanes );
+			var e0z = edges.Slice( lanes * 2, lanes );
+			var e1x = edges.Slice( lanes * 3, lanes );
+			var e1y = edges.Slice( lanes * 4, lanes );
+			var e1z = edges.Slice( lanes * 5, lanes );
+
+			var threshold = new Vector<float>( walkableThr );
+			var nearZeroLength = new Vector<float>( 1e-8f );
+			var walkable = new Vector<int>( Constants.WALKABLE_AREA );
+
+			for ( ; i <= numTris - lanes; i += lanes )
+			{
+				for ( int lane = 0; lane < lanes; lane++ )
+				{
+					var v0 = verts[tris[(i + lane) * 3 + 0]];
+					var v1 = verts[tris[(i + lane) * 3 + 1]];
+					var v2 = verts[tris[(i + lane) * 3 + 2]];
+
+					e0x[lane] = v1.x - v0.x;
+					e0y[lane] = v1.y - v0.y;
+					e0z[lane] = v1.z - v0.z;
+					e1x[lane] = v2.x - v0.x;
+					e1y[lane] = v2.y - v0.y;
+					e1z[lane] = v2.z - v0.z;
+				}
+
+				var ax = new Vector<float>( e0x );
+				var ay = new Vector<float>( e0y );
+				var az = new Vector<float>( e0z );
+				var bx = new Vector<float>( e1x );
+				var by = new Vector<float>( e1y );
+				var bz = new Vector<float>( e1z );
+
+				// Cross product, then the same normalization as Vector3.Normal, which leaves tiny vectors alone
+				var cx = ay * bz - az * by;
+				var cy = az * bx - ax * bz;
+				var cz = ax * by - ay * bx;
+
+				var lengthSquared = cx * cx + cy * cy + cz * cz;
+				var normalY = Vector.ConditionalSelect( Vector.LessThanOrEqual( lengthSquared, nearZeroLength ), cy, cy / Vector.SquareRoot( lengthSquared ) );
+
+				// Check if the face is walkable based on slope
+				var areas = Vector.ConditionalSelect( Vector.GreaterThan( normalY, threshold ), walkable, new Vector<int>( triAreaIds[i..] ) );
+				areas.CopyTo( triAreaIds[i..] );
+			}
+		}
+
+		for ( ; i < numTris; i++ )
 		{
 			int a = tris[i * 3 + 0];
 			int b = tris[i * 3 + 1];
@@ -1,8 +1,16 @@
-﻿namespace Sandbox.Navigation.Generation;
+﻿using System.Numerics;
+using System.Runtime.CompilerServices;
+
+namespace Sandbox.Navigation.Generation;
 
 [SkipHotload]
 internal static class Rasterization
 {
+	/// <summary>
+	/// 0, 1, 2.. for each SIMD lane, to work out the column boundary each lane is looking at
+	/// </summary>
+	private static readonly float[] LaneOffsets = Enumerable.Range( 0, Vector<float>.Count ).Select( i => (float)i ).ToArray();
+
 	internal enum Axis
 	{
 		X = 0,
@@ -94,7 +102,7 @@ internal static class Rasterization
 									 int areaId, Heightfield heightfield,
 									 Vector3 heightfieldBBMin, Vector3 heightfieldBBMax,
 									 float cellSize, float inverseCellSize, float inverseCellHeight,
-									 int flagMergeThreshold )
+									 int flagMergeThreshold, Span<float> rowScratch )
 	{
 		// Calculate the bounding box of the triangle
 		Vector3 triBBMin = Vector3.Min( Vector3.Min( v0, v1 ), v2 );
@@ -118,11 +126,10 @@ internal static class Rasterization
 		z0 = Math.Clamp( z0, -1, h - 1 );
 		z1 = Math.Clamp( z1, 0, h - 1 );
 
-		// Clip the triangle into all grid cells it touches
+		// Clip the triangle into all grid rows it touches
 		Span<Vector3> inVerts = stackalloc Vector3[7];
 		Span<Vector3> inRow = stackalloc Vector3[7];
 		Span<Vector3> p1 = stackalloc Vector3[7];
-		Span<Vector3> p2 = stackalloc Vector3[7];
 
 		inVerts[0] = v0;
 		inVerts[1] = v1;
@@ -160,59 +167,253 @@ internal static class Rasterization
 			if ( x1 < 0 || x0 >= w )
 				continue;
 
-			x0 = Math.Clamp( x0, -1, w - 1 );
-			x1 = Math.Clamp( x1, 0, w - 1 );
+			// Entirely inside one cell, which is the usual case for small triangles
+			if ( x0 == x1 )
+			{
+				float spanMin = inRow[0].y;
+				float spanMax = inRow[0].y;
+				for ( int vert = 1; vert < nvRow; ++vert )
+				{
+					spanMin = MathF.Min( spanMin, inRow[vert].y );
+					spanMax = MathF.Max( spanMax, inRow[vert].y );
+				}
 
-			int nv;
-			int nv2 = nvRow;
+				AddSpan( x0, z, spanMin, spanMax, areaId, heightfield, heightfieldBBMin, by, inverseCellHeight, flagMergeThreshold );
+				continue;
+			}
 
-			for ( int x = x0; x <= x1; ++x )
-			{
-				// Clip polygon to column. Store the remaining polygon as well
-				float cx = heightfieldBBMin.x + x * cellSize;
-				DividePoly( inRow, nv2, p1, out nv, p2, out nv2, cx + cellSize, Axis.X );
+			// Columns outside the heightfield are cut away. Otherwise the first and last columns take anything
+			// rounding has put past them, the same as the leftovers of clipping would.
+			bool keepLeft = x0 >= 0;
+			bool keepRight = x1 < w;
 
-				// Swap p2 into inRow for next iteration
-				Span<Vector3> swap = inRow;
-				inRow = p2;
-				p2 = swap;
+			x0 = Math.Max( x0, 0 );
+			x1 = Math.Min( x1, w - 1 );
 
-				if ( nv < 3 )
-					continue;
-				if ( x < 0 )
-					continue;
+			// A row ending exactly on a column boundary only touches the next column, it doesn't cover any of it.
+			// Clipping would still leave a sliver there if three or more of its points sit on the boundary, so keep those.
+			float lastBoundary = heightfieldBBMin.x + x1 * cellSize;
+			if ( lastBoundary >= maxX && CountOnBoundary( inRow[..nvRow], lastBoundary ) < 3 )
+				x1--;
+
+			if ( x1 < x0 )
+				continue;
+
+			RasterizeRow( inRow[..nvRow], x0, x1, keepLeft, keepRight, z, areaId, heightfield, heightfieldBBMin, by,
+				cellSize, inverseCellSize, inverseCellHeight, flagMergeThreshold, rowScratch );
+		}
+	}
+
+	/// <summary>
+	/// The column <paramref name="x"/> is in. Checked against the boundary positions everything else compares with,
+	/// since rounding in the division can put a point a hair from a boundary on the wrong side of it.
+	/// </summary>
+	[MethodImpl( MethodImplOptions.AggressiveInlining )]
+	private static int GetColumn( float x, float heightfieldMinX, float cellSize, float inverseCellSize )
+	{
+		int column = (int)MathF.Floor( (x - heightfieldMinX) * inverseCellSize );
+
+		if ( heightfieldMinX + column * cellSize > x )
+			column--;
+		else if ( heightfieldMinX + (column + 1) * cellSize <= x )
+			column++;
+
+		return column;
+	}
+
+	/// <summary>
+	/// How many points of a row lie exactly on a column boundary
+	/// </summary>
+	private static int CountOnBoundary( ReadOnlySpan<Vector3> row, float boundaryX )
+	{
+		int count = 0;
+
+		foreach ( var vert in row )
+		{
+			if ( vert.x == boundaryX )
+				count++;
+		}
+
+		return count;
+	}
+
+	/// <summary>
+	/// Add the spans for a row of a triangle that's already been clipped to the row.
+	/// </summary>
+	/// <remarks>
+	/// Rather than clipping the row polygon again for every column, which has to be done one column at a time,
+	/// the height range of each column comes from where the polygon's edges cross the column boundaries, plus any of
+	/// its vertices inside the column or on its boundaries. The polygon is flat, so its lowest and highest points in a
+	/// column are always one of those. The boundary crossings are independent of each other, so they're worked out a
+	/// SIMD lane per boundary.
+	/// </remarks>
+	private static void RasterizeRow( ReadOnlySpan<Vector3> row, int x0, int x1, bool keepLeft, bool keepRight, int z,
+									 int areaId, Heightfield heightfield, Vector3 heightfieldBBMin, float by,
+									 float cellSize, float inverseCellSize, float inverseCellHeight,
+									 int flagMergeThreshold, Span<float> scratch )
+	{
+		int columns = x1 - x0 + 1;
+		int boundaries = columns + 1;
+
+		var boundaryMin = scratch.Slice( 0, boundaries );
+		var boundaryMax = scratch.Slice( boundaries, boundaries );
+		var columnMin = scratch.Slice( boundaries * 2, columns );
+		var columnMax = scratch.Slice( boundaries * 2 + columns, columns );
+
+		boundaryMin.Fill( float.MaxValue );
+		boundaryMax.Fill( float.MinValue );
+		columnMin.Fill( float.MaxValue );
+		columnMax.Fill( float.MinValue );
+
+		// Boundary j is the left edge of column x0 + j
+		float firstBoundary = heightfieldBBMin.x + x0 * cellSize;
+
+		for ( int a = row.Length - 1, b = 0; b < row.Length; a = b, ++b )
+		{
+			Vector3 p = row[a];
+			Vector3 q = row[b];
+
+			float dx = q.x - p.x;
+
+			// Parallel to the boundaries, its ends are picked up as vertices below
+			if ( dx == 0.0f )
+				continue;
+
+			float edgeMinX = MathF.Min( p.x, q.x );
+			float edgeMaxX = MathF.Max( p.x, q.x );
+
+			// Only look at the boundaries the edge spans, give or take one for rounding
+			int first = Math.Max( (int)MathF.Ceiling( (edgeMinX - firstBoundary) * inverseCellSize ) - 1, 0 );
+			int last = Math.Min( (int)MathF.Floor( (edgeMaxX - firstBoundary) * inverseCellSize ) + 1, boundaries - 1 );
 
-				// Calculate min and max of the span
-				float spanMin = p1[0].y;
-				float spanMax = p1[0].y;
-				for ( int vert = 1; vert < nv; ++vert )
+			float inverseDx = 1.0f / dx;
+			float dy = q.y - p.y;
+			int j = first;
+
+			if ( Vector.IsHardwareAccelerated )
+			{
+				var lanes = new Vector<float>( LaneOffsets );
+				var minX = new Vector<float>( edgeMinX );
+				var maxX = new Vector<float>( edgeMaxX );
+
+				for ( ; j <= last + 1 - Vector<float>.Count; j += Vector<float>.Count )
 				{
-					spanMin = Math.Min( spanMin, p1[vert].y );
-					spanMax = Math.Max( spanMax, p1[vert].y );
+					var boundaryX = new Vector<float>( heightfieldBBMin.x ) + (new Vector<float>( x0 + j ) + lanes) * cellSize;
+					var crosses = Vector.GreaterThanOrEqual( boundaryX, minX ) & Vector.LessThanOrEqual( boundaryX, maxX );
+
+					var t = (boundaryX - new Vector<float>( p.x )) * inverseDx;
+					t = Vector.Min( Vector.Max( t, Vector<float>.Zero ), Vector<float>.One );
+					var y = new Vector<float>( p.y ) + t * dy;
+
+					var min = new Vector<float>( boundaryMin[j..] );
+					var max = new Vector<float>( boundaryMax[j..] );
+
+					Vector.ConditionalSelect( crosses, Vector.Min( min, y ), min ).CopyTo( boundaryMin[j..] );
+					Vector.ConditionalSelect( crosses, Vector.Max( max, y ), max ).CopyTo( boundaryMax[j..] );
 				}
+			}
+
+			for ( ; j <= last; ++j )
+			{
+				float boundaryX = heightfieldBBMin.x + (x0 + j) * cellSize;
+				if ( boundaryX < edgeMinX || boundaryX > edgeMaxX )
+					continue;
+
+				float t = (boundaryX - p.x) * inverseDx;
+				float y = p.y + Math.Clamp( t, 0.0f, 1.0f ) * dy;
+				boundaryMin[j] = MathF.Min( boundaryMin[j], y );
+				boundaryMax[j] = MathF.Max( boundaryMax[j], y );
+			}
+		}
+
+		foreach ( var vert in row )
+		{
+			int column = GetColumn( vert.x, heightfieldBBMin.x, cellSize, inverseCellSize ) - x0;
 
-				spanMin -= heightfieldBBMin.y;
-				spanMax -= heightfieldBBMin.y;
+			// A vertex on a boundary belongs to the columns on both sides of it
+			if ( column > 0 && column <= columns && heightfieldBBMin.x + (x0 + column) * cellSize == vert.x )
+			{
+				columnMin[column - 1] = MathF.Min( columnMin[column - 1], vert.y );
+				columnMax[column - 1] = MathF.Max( columnMax[column - 1], vert.y );
+			}
 
-				// Skip the span if it's completely outside the heightfield bounding box
-				if ( spanMax < 0.0f )
+			if ( column < 0 )
+			{
+				if ( !keepLeft )
 					continue;
-				if ( spanMin > by )
+
+				column = 0;
+			}
+			else if ( column >= columns )
+			{
+				if ( !keepRight )
 					continue;
 
-				// Clamp the span to the heightfield bounding box
-				if ( spanMin < 0.0f )
-					spanMin = 0;
-				if ( spanMax > by )
-					spanMax = by;
+				column = columns - 1;
+			}
+
+			columnMin[column] = MathF.Min( columnMin[column], vert.y );
+			columnMax[column] = MathF.Max( columnMax[column], vert.y );
+		}
 
-				// Snap the span to the heightfield height grid
-				ushort spanMinCellIndex = (ushort)Math.Clamp( (int)MathF.Floor( spanMin * inverseCellHeight ), 0, Constants.SPAN_MAX_HEIGHT );
-				ushort spanMaxCellIndex = (ushort)Math.Clamp( (int)MathF.Ceiling( spanMax * inverseCellHeight ), spanMinCellIndex + 1, Constants.SPAN_MAX_HEIGHT );
+		// Each column covers the boundaries on either side of it
+		int c = 0;
 
-				heightfield.AddOrMergeSpan( x, z, spanMinCellIndex, spanMaxCellIndex, areaId, flagMergeThreshold );
+		if ( Vector.IsHardwareAccelerated )
+		{
+			for ( ; c <= columns - Vector<float>.Count; c += Vector<float>.Count )
+			{
+				var min = Vector.Min( new Vector<float>( columnMin[c..] ), Vector.Min( new Vector<float>( boundaryMin[c..] ), new Vector<float>( boundaryMin[(c + 1)..] ) ) );
+				var max = Vector.Max( new Vector<float>( columnMax[c..] ), Vector.Max( new Vector<float>( boundaryMax[c..] ), new Vector<float>( boundaryMax[(c + 1)..] ) ) );
+
+				min.CopyTo( columnMin[c..] );
+				max.CopyTo( columnMax[c..] );
 			}
 		}
+
+		for ( ; c < columns; ++c )
+		{
+			columnMin[c] = MathF.Min( columnMin[c], MathF.Min( boundaryMin[c], boundaryMin[c + 1] ) );
+			columnMax[c] = MathF.Max( columnMax[c], MathF.Max( boundaryMax[c], boundaryMax[c + 1] ) );
+		}
+
+		for ( c = 0; c < columns; ++c )
+		{
+			// The row doesn't reach into this column
+			if ( columnMin[c] > columnMax[c] )
+				continue;
+
+			AddSpan( x0 + c, z, columnMin[c], columnMax[c], areaId, heightfield, heightfieldBBMin, by, inverseCellHeight, flagMergeThreshold );
+		}
+	}
+
+	/// <summary>
+	/// Snap a height range in a cell to the heightfield and add it
+	/// </summary>
+	[MethodImpl( MethodImplOptions.AggressiveInlining )]
+	private static void AddSpan( int x, int z, float spanMin, float spanMax, int areaId, Heightfield heightfield,
+								Vector3 heightfieldBBMin, float by, float inverseCellHeight, int flagMergeThreshold )
+	{
+		spanMin -= heightfieldBBMin.y;
+		spanMax -= heightfieldBBMin.y;
+
+		// Skip the span if it's completely outside the heightfield bounding box
+		if ( spanMax < 0.0f )
+			return;
+		if ( spanMin > by )
+			return;
+
+		// Clamp the span to the heightfield bounding box
+		if ( spanMin < 0.0f )
+			spanMin = 0;
+		if ( spanMax > by )
+			spanMax = by;
+
+		// Snap the span to the heightfield height grid
+		ushort spanMinCellIndex = (ushort)Math.Clamp( (int)MathF.Floor( spanMin * inverseCellHeight ), 0, Constants.SPAN_MAX_HEIGHT );
+		ushort spanMaxCellIndex = (ushort)Math.Clamp( (int)MathF.Ceiling( spanMax * inverseCellHeight ), spanMinCellIndex + 1, Constants.SPAN_MAX_HEIGHT );
+
+		heightfield.AddOrMergeSpan( x, z, spanMinCellIndex, spanMaxCellIndex, areaId, flagMergeThreshold );
 	}
 
 	/// <summary>
@@ -227,6 +428,10 @@ internal static class Rasterization
 		float inverseCellSize = 1.0f / heightfield.CellSize;
 		float inverseCellHeight = 1.0f / heightfield.CellHeight;
 
+		// Per column working space for each row, the boundaries either side of every column and the columns themselves
+		using var pooledRowScratch = new PooledSpan<float>( (heightfield.Width + 1) * 4 );
+		var rowScratch = pooledRowScratch.Span;
+
 		for ( int triIndex = 0; triIndex < numTris; ++triIndex )
 		{
 			Vector3 v0 = verts[tris[triIndex * 3 + 0]];
@@ -235,7 +440,7 @@ internal static class Rasterization
 
 			RasterizeTri( v0, v1, v2, triAreaIds[triIndex], heightfield,
 							heightfield.BMin, heightfield.BMax, heightfield.CellSize,
-							inverseCellSize, inverseCellHeight, flagMergeThreshold );
+							inverseCellSize, inverseCellHeight, flagMergeThreshold, rowScratch );
 		}
 	}
 }
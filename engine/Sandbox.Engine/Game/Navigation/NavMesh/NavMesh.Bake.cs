@@ -0,0 +1,260 @@
+﻿using DotRecast.Detour;
+
+namespace Sandbox.Navigation;
+
+/// <summary>
+/// Generated tiles are saved with the scene, keyed by a hash of the geometry and settings they were generated
+/// from. When the scene loads, tiles whose geometry hasn't changed use the saved mesh instead of being rasterized
+/// and built again.
+/// </summary>
+public sealed partial class NavMesh
+{
+	/// <summary>
+	/// Bump this if the layout written by <see cref="WriteMeshData"/> changes, old bakes are then ignored.
+	/// </summary>
+	const int BakeVersion = 1;
+
+	/// <summary>
+	/// A saved tile. A null <see cref="Data"/> means the tile generated nothing.
+	/// </summary>
+	record struct BakedTile( ulong GeometryHash, DtMeshData Data );
+
+	Dictionary<Vector2Int, BakedTile> _bakedTiles;
+
+	/// <summary>
+	/// If we have a baked tile at this position that was generated from the same geometry, take it.
+	/// Tiles with areas or links are never baked, because those come from components that aren't part of the geometry.
+	/// Tiles are generated in parallel, so this can be called from any thread.
+	/// </summary>
+	internal bool TryTakeBakedTile( NavMeshTile tile, out DtMeshData data )
+	{
+		data = null;
+
+		var bakedTiles = _bakedTiles;
+
+		if ( bakedTiles is null || tile.GeometryHash == 0 || tile.HasSpatialData )
+			return false;
+
+		BakedTile baked;
+
+		lock ( bakedTiles )
+		{
+			if ( !bakedTiles.Remove( tile.TilePosition, out baked ) || baked.GeometryHash != tile.GeometryHash )
+				return false;
+		}
+
+		data = baked.Data;
+		tile.IsBaked = true;
+		return true;
+	}
+
+	/// <summary>
+	/// Write every generated tile that can be baked, compressed and base64 encoded. Returns null if there's nothing to bake.
+	/// </summary>
+	string SerializeBakedTiles()
+	{
+		var tiles = new List<(NavMeshTile Tile, DtMeshData Data)>();
+
+		foreach ( var tile in tileCache.Tiles )
+		{
+			if ( tile.GeometryHash == 0 || tile.HasSpatialData )
+				continue;
+
+			var data = navmeshInternal.GetTileAt( tile.TilePosition.x, tile.TilePosition.y, 0 )?.data;
+
+			// Links carry user data we can't save, so regenerate these
+			if ( data?.header is not null && data.header.offMeshConCount > 0 )
+				continue;
+
+			tiles.Add( (tile, data) );
+		}
+
+		if ( tiles.Count == 0 )
+			return null;
+
+		var stream = ByteStream.Create( 4096 );
+
+		try
+		{
+			stream.Write( BakeVersion );
+			stream.Write( tiles.Count );
+
+			foreach ( var (tile, data) in tiles )
+			{
+				stream.Write( tile.TilePosition );
+				stream.Write( tile.GeometryHash );
+
+				var hasData = data?.header is not null && data.header.polyCount > 0;
+				stream.Write( hasData );
+
+				if ( hasData )
+				{
+					WriteMeshData( ref stream, data );
+				}
+			}
+
+			using var compressed = stream.Compress();
+			return Convert.ToBase64String( compressed.ToArray() );
+		}
+		finally
+		{
+			stream.Dispose();
+		}
+	}
+
+	/// <summary>
+	/// Read tiles written by <see cref="SerializeBakedTiles"/>. They're kept until the next generation picks them up.
+	/// </summary>
+	void DeserializeBakedTiles( string base64 )
+	{
+		_bakedTiles = null;
+
+		if ( string.IsNullOrEmpty( base64 ) )
+			return;
+
+		try
+		{
+			using var compressed = ByteStream.CreateReader( Convert.FromBase64String( base64 ) );
+			using var stream = compressed.Decompress();
+			var reader = stream;
+
+			if ( reader.Read<int>() != BakeVersion )
+				return;
+
+			var count = reader.Read<int>();
+			var tiles = new Dictionary<Vector2Int, BakedTile>( count );
+
+			for ( int i = 0; i < count; i++ )
+			{
+				var position = reader.Read<Vector2Int>();
+				var hash = reader.Read<ulong>();
+				var data = reader.Read<bool>() ? ReadMeshData( ref reader ) : null;
+
+				tiles[position] = new BakedTile( hash, data );
+			}
+
+			_bakedTiles = tiles;
+		}
+		catch ( Exception e )
+		{
+			Log.Warning( e, $"Navmesh: Couldn't read baked tiles, they'll be regenerated ({e.Message})" );
+		}
+	}
+
+	static void WriteMeshData( ref ByteStream stream, DtMeshData data )
+	{
+		var header = data.header;
+
+		stream.Write( header.magic );
+		stream.Write( header.version );
+		stream.Write( header.x );
+		stream.Write( header.y );
+		stream.Write( header.layer );
+		stream.Write( header.userId );
+		stream.Write( header.polyCount );
+		stream.Write( header.vertCount );
+		stream.Write( header.maxLinkCount );
+		stream.Write( header.bvNodeCount );
+		stream.Write( header.offMeshBase );
+		stream.Write( header.walkableHeight );
+		stream.Write( header.walkableRadius );
+		stream.Write( header.walkableClimb );
+		stream.Write( header.bmin );
+		stream.Write( header.bmax );
+		stream.Write( header.bvQuantFactor );
+
+		stream.WriteArray<Vector3>( data.verts.AsSpan( 0, header.vertCount ) );
+
+		for ( int i = 0; i < header.polyCount; i++ )
+		{
+			var poly = data.polys[i];
+
+			stream.Write( (byte)poly.vertCount );
+			stream.Write( (byte)poly.area );
+			stream.Write( poly.type );
+			stream.Write( (byte)poly.verts.Length );
+			stream.WriteArray<int>( poly.verts.AsSpan() );
+			stream.WriteArray<int>( poly.neis.AsSpan() );
+		}
+
+		var nodeCount = data.bvTree is null ? 0 : header.bvNodeCount;
+		stream.Write( nodeCount );
+
+		for ( int i = 0; i < nodeCount; i++ )
+		{
+			var node = data.bvTree[i];
+
+			stream.Write( node.bmin );
+			stream.Write( node.bmax );
+			stream.Write( node.i );
+		}
+	}
+
+	static DtMeshData ReadMeshData( ref ByteStream stream )
+	{
+		var header = new DtMeshHeader
+		{
+			magic = stream.Read<int>(),
+			version = stream.Read<int>(),
+			x = stream.Read<int>(),
+			y = stream.Read<int>(),
+			layer = stream.Read<int>(),
+			userId = stream.Read<int>(),
+			polyCount = stream.Read<int>(),
+			vertCount = stream.Read<int>(),
+			maxLinkCount = stream.Read<int>(),
+			bvNodeCount = stream.Read<int>(),
+			offMeshBase = stream.Read<int>(),
+			walkableHeight = stream.Read<float>(),
+			walkableRadius = stream.Read<float>(),
+			walkableClimb = stream.Read<float>(),
+			bmin = stream.Read<Vector3>(),
+			bmax = stream.Read<Vector3>(),
+			bvQuantFactor = stream.Read<float>(),
+		};
+
+		var data = new DtMeshData
+		{
+			header = header,
+			verts = stream.ReadArray<Vector3>( 1 << 20 ),
+			polys = new DtPoly[header.polyCount],
+			offMeshCons = [],
+		};
+
+		for ( int i = 0; i < header.polyCount; i++ )
+		{
+			var vertCount = stream.Read<byte>();
+			var area = stream.Read<byte>();
+			var type = stream.Read<byte>();
+			var maxVerts = stream.Read<byte>();
+
+			var poly = new DtPoly( i, maxVerts )
+			{
+				vertCount = vertCount,
+				area = area,
+				type = type,
+				firstLink = DtDetour.DT_NULL_LINK,
+			};
+
+			stream.ReadArraySpan<int>( maxVerts ).CopyTo( poly.verts );
+			stream.ReadArraySpan<int>( maxVerts ).CopyTo( poly.neis );
+
+			data.polys[i] = poly;
+		}
+
+		var nodeCount = stream.Read<int>();
+		data.bvTree = new DtBVNode[nodeCount];
+
+		for ( int i = 0; i < nodeCount; i++ )
+		{
+			data.bvTree[i] = new DtBVNode
+			{
+				bmin = stream.Read<Vector3Int>(),
+				bmax = stream.Read<Vector3Int>(),
+				i = stream.Read<int>(),
+			};
+		}
+
+		return data;
+	}
+}
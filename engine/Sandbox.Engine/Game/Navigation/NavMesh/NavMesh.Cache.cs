@@ -1,6 +1,8 @@
+using DotRecast.Detour;
 using Sandbox.Engine.Resources;
 using Sandbox.Navigation.Generation;
 using Sandbox.Utility;
+using System.Collections.Concurrent;
 
 namespace Sandbox.Navigation;
 
@@ -32,6 +34,8 @@ internal class NavMeshTileCache : IDisposable
 		return areaIdToDefinition[id];
 	}
 
+	public IEnumerable<NavMeshTile> Tiles => tileCache.Values;
+
 	public void RemoveTile( Vector2Int tilePosition )
 	{
 		tileCache.Remove( tilePosition );
@@ -43,6 +47,35 @@ internal class NavMeshTileCache : IDisposable
 	private HashSet<Vector2Int> queuedHeightfieldTiles = new();
 	private HashSet<Vector2Int> queuedNavmeshTiles = new();
 
+	private ConcurrentQueue<(NavMeshTile Tile, DtMeshData Data)> completedNavmeshBuilds = new();
+	private List<NavMeshTile> heightfieldBuildTiles = new();
+	private List<BBox> heightfieldBuildBounds = new();
+
+	/// <summary>
+	/// Called from the build thread when a tile's navmesh is ready. It's swapped in on the next <see cref="Update"/>.
+	/// </summary>
+	public void CompleteNavmeshBuild( NavMeshTile tile, DtMeshData data )
+	{
+		completedNavmeshBuilds.Enqueue( (tile, data) );
+	}
+
+	/// <summary>
+	/// Swap finished tiles into the navmesh until we run out of time for this frame. The rest wait for the next one.
+	/// </summary>
+	private void ApplyCompletedNavmeshBuilds( NavMesh navMesh )
+	{
+		var timer = FastTimer.StartNew();
+
+		while ( completedNavmeshBuilds.TryDequeue( out var completed ) )
+		{
+			navMesh.LoadTileOnMainThread( completed.Tile, completed.Data );
+			completed.Tile.NavmeshBuildComplete();
+
+			if ( timer.ElapsedMilliSeconds > NavMesh.TileApplyBudgetMs )
+				break;
+		}
+	}
+
 	public NavMeshTile GetOrAddTile( Vector2Int tilePosition )
 	{
 		if ( !tileCache.TryGetValue( tilePosition, out NavMeshTile tile ) )
@@ -65,6 +98,8 @@ internal class NavMeshTileCache : IDisposable
 
 	public void Update( NavMesh navMesh, PhysicsWorld physicsWorld )
 	{
+		ApplyCompletedNavmeshBuilds( navMesh );
+
 		UpdateAreas( navMesh );
 
 		var heightfieldBuildsThisUpdate = 0;
@@ -78,6 +113,12 @@ internal class NavMeshTileCache : IDisposable
 			if ( tile.IsHeightfieldBuildInProgress ) heightfieldBuildsInProgress++;
 			if ( tile.IsNavmeshBuildInProgress ) navmeshBuildsInProgress++;
 
+			// Baked tiles have no heightfield to build a navmesh from, so start from the geometry again
+			if ( tile.IsBaked && tile.IsNavmeshBuildRequested && !tile.IsFullRebuildRequested )
+			{
+				tile.RequestFullRebuild();
+			}
+
 			// Only queue if not already queued
 			if ( tile.IsFullRebuildRequested && !tile.IsNavmeshBuildInProgress && !queuedHeightfieldTiles.Contains( tile.TilePosition ) )
 			{
@@ -109,11 +150,26 @@ internal class NavMeshTileCache : IDisposable
 
 			if ( tileCache.TryGetValue( tilePosition, out NavMeshTile tile ) )
 			{
-				tile.DispatchHeightFieldBuild( navMesh, physicsWorld );
+				heightfieldBuildTiles.Add( tile );
+				heightfieldBuildBounds.Add( navMesh.CreateTileGenerationConfig( tilePosition ).Bounds );
 				heightfieldBuildsThisUpdate++;
 			}
 		}
 
+		if ( heightfieldBuildTiles.Count > 0 )
+		{
+			// One query of the physics world for every tile we're building, the rest happens off the main thread
+			var snapshot = GeometrySnapshot.Capture( navMesh, physicsWorld, heightfieldBuildBounds );
+
+			foreach ( var tile in heightfieldBuildTiles )
+			{
+				tile.DispatchHeightFieldBuild( navMesh, snapshot );
+			}
+
+			heightfieldBuildTiles.Clear();
+			heightfieldBuildBounds.Clear();
+		}
+
 		// Process navmesh builds
 		var allowedNavmeshBuildsThisUpdate = Math.Max( 2, NavMesh.NavMeshGenerationThreadCount ) - navmeshBuildsInProgress;
 
@@ -249,7 +305,7 @@ internal class NavMeshTileCache : IDisposable
 public sealed partial class NavMesh
 {
 
-	private NavMeshTileCache tileCache = new();
+	internal NavMeshTileCache tileCache = new();
 
 	internal void AddSpatiaData( NavMeshSpatialAuxiliaryData data )
 	{
@@ -59,6 +59,12 @@ public sealed partial class NavMesh
 	static internal GeneratorPool<HeightFieldGenerator> HeightFieldGeneratorPool = new( HeightFieldGenerationThreadCount );
 	static internal GeneratorPool<NavMeshGenerator> NavMeshGeneratorPool = new( NavMeshGenerationThreadCount );
 
+	/// <summary>
+	/// How long we'll spend swapping generated tiles into the navmesh on the main thread each frame.
+	/// At least one tile is always swapped in, so progress is made however long that takes.
+	/// </summary>
+	internal const double TileApplyBudgetMs = 2.0;
+
 	/// <summary>
 	/// Generates or regenerates the navmesh tile at the given world position.
 	/// This function is thread safe but can only be called from the main thread.
@@ -79,27 +85,9 @@ public sealed partial class NavMesh
 		var tile = tileCache.GetOrAddTile( tilePosition );
 
 		var generatorConfig = CreateTileGenerationConfig( tile.TilePosition );
-		var heightFieldGenerator = HeightFieldGeneratorPool.Get();
-		heightFieldGenerator.Init( generatorConfig );
-		heightFieldGenerator.CollectGeometry( this, world, generatorConfig.Bounds );
-
-		var data = await Task.Run( () =>
-		{
-			var heightField = heightFieldGenerator.Generate();
-			HeightFieldGeneratorPool.Return( heightFieldGenerator );
-
-			if ( heightField == null )
-			{
-				return null;
-			}
-
-			tile.SetCachedHeightField( heightField );
-			tile.HeightfieldBuildComplete();
+		var snapshot = GeometrySnapshot.Capture( this, world, [generatorConfig.Bounds] );
 
-			var tileMesh = tile.BuildNavmesh( heightField, generatorConfig, this );
-
-			return tileMesh;
-		} );
+		var data = await Task.Run( () => GenerateTileData( tile, generatorConfig, snapshot ) );
 
 		if ( data != null )
 		{
@@ -134,6 +122,17 @@ public sealed partial class NavMesh
 			}
 		}
 
+		var configs = new Config[tiles.Count];
+		var tileBounds = new BBox[tiles.Count];
+		for ( int i = 0; i < tiles.Count; i++ )
+		{
+			configs[i] = CreateTileGenerationConfig( tiles[i].TilePosition );
+			tileBounds[i] = configs[i].Bounds;
+		}
+
+		// The only part of collecting geometry that needs the main thread, everything after this is done per tile in parallel
+		var snapshot = GeometrySnapshot.Capture( this, world, tileBounds );
+
 		// Limit parallel generation to a reasonable amount of threads
 		using var concurrency = new SemaphoreSlim( HeightFieldGenerationThreadCount );
 
@@ -147,40 +146,14 @@ public sealed partial class NavMesh
 		{
 			int index = i;
 			var tile = tiles[index];
-			var generatorConfig = CreateTileGenerationConfig( tile.TilePosition );
-
-			var heightFieldGenerator = HeightFieldGeneratorPool.Get();
-			heightFieldGenerator.Init( generatorConfig );
-			heightFieldGenerator.CollectGeometry( this, world, generatorConfig.Bounds );
+			var generatorConfig = configs[index];
 
 			tasks[index] = Task.Run( async () =>
 			{
 				await concurrency.WaitAsync().ConfigureAwait( false );
 				try
 				{
-					CompactHeightfield heightField = null;
-					try
-					{
-						heightField = heightFieldGenerator.Generate();
-					}
-					finally
-					{
-						// Return generator regardless of success/failure
-						HeightFieldGeneratorPool.Return( heightFieldGenerator );
-					}
-
-					if ( heightField == null )
-					{
-						results[index] = null;
-						return;
-					}
-
-					// Cache & mark stage completion
-					tile.SetCachedHeightField( heightField );
-					tile.HeightfieldBuildComplete();
-
-					var tileMesh = tile.BuildNavmesh( heightField, generatorConfig, this );
-					results[index] = tileMesh;
+					results[index] = GenerateTileData( tile, generatorConfig, snapshot );
 				}
 				catch ( Exception e )
 				{
@@ -199,15 +172,65 @@ public sealed partial class NavMesh
 		// Await all background work
 		await Task.WhenAll( tasks );
 
-		// Apply results on main thread
+		// Apply results on main thread, spread over frames if there's a lot of them
+		var timer = FastTimer.StartNew();
+
 		for ( int i = 0; i < tiles.Count; i++ )
 		{
 			var data = results[i];
-			if ( data != null )
+			if ( data == null )
+				continue;
+
+			if ( timer.ElapsedMilliSeconds > TileApplyBudgetMs )
+			{
+				// Task.Yield can resume within the same frame, so wait for the next one
+				await SyncContext.FrameStage.Update.Await();
+				timer.Start();
+			}
+
+			LoadTileOnMainThread( tiles[i], data );
+		}
+	}
+
+	/// <summary>
+	/// Collect a tile's geometry from the snapshot and build its mesh, or take the baked mesh if the geometry
+	/// hasn't changed since it was saved. Safe to call from any thread.
+	/// </summary>
+	DtMeshData GenerateTileData( NavMeshTile tile, Config generatorConfig, GeometrySnapshot snapshot )
+	{
+		CompactHeightfield heightField;
+
+		var heightFieldGenerator = HeightFieldGeneratorPool.Get();
+		try
+		{
+			heightFieldGenerator.Init( generatorConfig );
+			heightFieldGenerator.CollectGeometry( snapshot, generatorConfig.Bounds );
+
+			tile.GeometryHash = heightFieldGenerator.GetGeometryHash();
+
+			// Nothing has changed since this tile was baked, use the saved mesh
+			if ( TryTakeBakedTile( tile, out var baked ) )
 			{
-				LoadTileOnMainThread( tiles[i], data );
+				portalGraph.Prepare( baked );
+				return baked;
 			}
+
+			heightField = heightFieldGenerator.Generate();
 		}
+		finally
+		{
+			// Return generator regardless of success/failure
+			HeightFieldGeneratorPool.Return( heightFieldGenerator );
+		}
+
+		if ( heightField == null )
+			return null;
+
+		// Cache & mark stage completion
+		tile.SetCachedHeightField( heightField );
+		tile.HeightfieldBuildComplete();
+
+		return tile.BuildNavmesh( heightField, generatorConfig, this );
 	}
 
 	internal void LoadTileOnMainThread( NavMeshTile targetTile, DtMeshData data )
@@ -220,6 +243,7 @@ public sealed partial class NavMesh
 		{
 			if ( tileRef != default )
 			{
+				portalGraph.RemoveTile( tileRef );
 				navmeshInternal.RemoveTile( tileRef );
 			}
 			return;
@@ -234,6 +258,8 @@ public sealed partial class NavMesh
 			navmeshInternal.AddTile( data, 0, 0, out var _ );
 		}
 
+		portalGraph.AddTile( navmeshInternal.GetTileRefAt( targetTile.TilePosition.x, targetTile.TilePosition.y, 0 ) );
+
 		targetTile.UpdateLinkStatus( this );
 	}
 
@@ -245,6 +271,7 @@ public sealed partial class NavMesh
 
 		if ( tileRef != default )
 		{
+			portalGraph.RemoveTile( tileRef );
 			navmeshInternal.RemoveTile( tileRef );
 		}
 	}
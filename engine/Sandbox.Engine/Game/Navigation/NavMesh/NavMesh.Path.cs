@@ -1,5 +1,4 @@
 ﻿using DotRecast.Detour;
-using System.Buffers;
 
 namespace Sandbox.Navigation;
 
@@ -9,36 +8,46 @@ namespace Sandbox.Navigation;
 public sealed partial class NavMesh
 {
 	[Obsolete( "Use CalculatePath instead" )]
-	public unsafe List<Vector3> GetSimplePath( Vector3 from, Vector3 to )
+	public List<Vector3> GetSimplePath( Vector3 from, Vector3 to )
 	{
 		var list = new List<Vector3>();
-		int nodeCountMax = 128;
+		var context = RentPathQueryContext();
 
-		// find polys
-		var fromFound = query.FindNearestPoly( ToNav( from ), ToNav( TileSizeWorldSpace * 3 ), DtQueryNoOpFilter.Shared, out var fromPoly, out var fromPoint, out _ );
-		if ( !fromFound.Succeeded() ) return list;
+		try
+		{
+			var query = context.Query;
+
+			// find polys
+			var fromFound = query.FindNearestPoly( ToNav( from ), ToNav( TileSizeWorldSpace * 3 ), DtQueryNoOpFilter.Shared, out var fromPoly, out var fromPoint, out _ );
+			if ( !fromFound.Succeeded() ) return list;
 
-		var toFound = query.FindNearestPoly( ToNav( to ), ToNav( TileSizeWorldSpace * 3 ), DtQueryNoOpFilter.Shared, out var toPoly, out var toPoint, out _ );
+			var toFound = query.FindNearestPoly( ToNav( to ), ToNav( TileSizeWorldSpace * 3 ), DtQueryNoOpFilter.Shared, out var toPoly, out var toPoint, out _ );
 
-		if ( toFound.Failed() ) return list;
+			if ( toFound.Failed() ) return list;
 
-		// find path
-		List<long> polyPath = new List<long>( 128 );
-		var polyPathFound = query.FindPath( fromPoly, toPoly, fromPoint, toPoint, DtQueryNoOpFilter.Shared, ref polyPath, DtFindPathOption.NoOption );
+			// find path
+			var polyPath = context.Polygons;
+			var polyPathFound = query.FindPath( fromPoly, toPoly, fromPoint, toPoint, DtQueryNoOpFilter.Shared, ref polyPath, DtFindPathOption.NoOption );
+			context.Polygons = polyPath;
 
-		if ( polyPathFound.Failed() ) return list;
+			if ( polyPathFound.Failed() ) return list;
 
-		Span<DtStraightPath> outNodes = stackalloc DtStraightPath[nodeCountMax];
-		var straightPathFound = query.FindStraightPath( fromPoint, toPoint, polyPath, polyPath.Count, outNodes, out var straightPathCount, 128, 0 );
+			var outNodes = context.StraightPath;
+			var straightPathFound = query.FindStraightPath( fromPoint, toPoint, polyPath, polyPath.Count, outNodes, out var straightPathCount, 128, 0 );
 
-		if ( straightPathFound.Failed() ) return list;
+			if ( straightPathFound.Failed() ) return list;
 
-		for ( int i = 0; i < straightPathCount; i++ )
+			for ( int i = 0; i < straightPathCount; i++ )
+			{
+				list.Add( FromNav( outNodes[i].pos ) );
+			}
+
+			return list;
+		}
+		finally
 		{
-			list.Add( FromNav( outNodes[i].pos ) );
+			ReturnPathQueryContext( context );
 		}
-
-		return list;
 	}
 
 	/// <summary>
@@ -50,76 +59,122 @@ public sealed partial class NavMesh
 	public NavMeshPath CalculatePath( CalculatePathRequest request )
 	{
 		NavMeshPath result = new();
+		CalculatePath( request, ref result );
+		return result;
+	}
 
-		// In navspace
-		var searchRadius = request.Agent != null ? new Vector3( request.Agent.Radius * 2.01f, request.Agent.Height * 1.51f, request.Agent.Radius * 2.01f ) : crowd._agentPlacementHalfExtents;
+	/// <summary>
+	/// The same as <see cref="CalculatePath(CalculatePathRequest)"/>, but the result is written into <paramref name="path"/>,
+	/// reusing the lists it already has. Keep a path around and pass it in every time you re-path, and once its lists
+	/// are big enough this doesn't allocate anything. Anything still holding the old <see cref="NavMeshPath.Points"/>
+	/// will see them change.
+	/// </summary>
+	public void CalculatePath( CalculatePathRequest request, ref NavMeshPath path )
+	{
+		var input = GetPathQueryInput( request );
+		var context = RentPathQueryContext();
 
-		var startFound = query.FindNearestPoly( ToNav( request.Start ), searchRadius, DtQueryNoOpFilter.Shared, out var startPoly, out var startLocation, out _ );
-		if ( !startFound.Succeeded() )
+		try
 		{
-			result.Status = NavMeshPathStatus.StartNotFound;
-			return result;
+			CalculatePath( context, input, ref path, out _ );
 		}
-
-		var targetFound = query.FindNearestPoly( ToNav( request.Target ), searchRadius, DtQueryNoOpFilter.Shared, out var targetPoly, out var targetLocation, out _ );
-		if ( !targetFound.Succeeded() )
+		finally
 		{
-			result.Status = NavMeshPathStatus.TargetNotFound;
-			return result;
+			ReturnPathQueryContext( context );
 		}
+	}
 
-		var filter = request.Agent != null ? request.Agent.agentInternal.option.filter : crowd.GetDefaultFilter();
-
-		// Quick search towards the goal.
-		var dtStatus = query.InitSlicedFindPath( startPoly, targetPoly, startLocation, targetLocation, filter, 0 );
-		if ( dtStatus.Failed() )
-		{
-			result.Status = NavMeshPathStatus.PathNotFound;
-			return result;
-		}
-		dtStatus = query.UpdateSlicedFindPath( crowd.Config().maxFindPathIterations, out var _ );
-		if ( dtStatus.Failed() )
-		{
-			result.Status = NavMeshPathStatus.PathNotFound;
-			return result;
-		}
+	/// <summary>
+	/// Compute a path using a worker's own query, so this can run on any thread as long as the navmesh
+	/// isn't being changed. <paramref name="iterations"/> is how many search iterations it took.
+	/// </summary>
+	NavMeshPath CalculatePath( PathQueryContext context, in PathQueryInput input, out int iterations )
+	{
+		NavMeshPath result = new();
+		CalculatePath( context, input, ref result, out iterations );
+		return result;
+	}
 
-		result.Polygons = new( 128 );
-		dtStatus = query.FinalizeSlicedFindPath( ref result.Polygons );
-		if ( dtStatus.Failed() || result.Polygons.Count == 0 )
-		{
-			result.Status = NavMeshPathStatus.PathNotFound;
-			return result;
-		}
+	/// <summary>
+	/// Compute a path into <paramref name="result"/>, clearing and refilling any lists it already has.
+	/// </summary>
+	void CalculatePath( PathQueryContext context, in PathQueryInput input, ref NavMeshPath result, out int iterations )
+	{
+		var points = result.Points as List<NavMeshPathPoint>;
+		points?.Clear();
+		result.Polygons?.Clear();
 
-		var straightPathCache = ArrayPool<DtStraightPath>.Shared.Rent( 4096 );
-		dtStatus = query.FindStraightPath( startLocation, targetLocation, result.Polygons, result.Polygons.Count, straightPathCache, out var filledPointCount, straightPathCache.Length, 0 );
-		if ( dtStatus.Failed() )
-		{
-			ArrayPool<DtStraightPath>.Shared.Return( straightPathCache );
-			result.Status = NavMeshPathStatus.PathNotFound;
-			return result;
-		}
+		result.Status = FindPath( context, input, out var pointCount, out iterations );
+		if ( !result.IsValid )
+			return;
 
-		var points = new List<NavMeshPathPoint>( filledPointCount );
-		for ( int i = 0; i < filledPointCount; i++ )
+		points ??= new List<NavMeshPathPoint>( pointCount );
+		for ( int i = 0; i < pointCount; i++ )
 		{
-			points.Add( new NavMeshPathPoint { Position = FromNav( straightPathCache[i].pos ) } );
+			points.Add( new NavMeshPathPoint { Position = FromNav( context.StraightPath[i].pos ) } );
 		}
-		ArrayPool<DtStraightPath>.Shared.Return( straightPathCache );
 		result.Points = points;
 
-		if ( result.Polygons[^1] != targetPoly )
+		result.Polygons ??= new List<long>( context.Polygons.Count );
+		result.Polygons.AddRange( context.Polygons );
+	}
+
+	/// <summary>
+	/// Search for a path, leaving its polygons in <see cref="PathQueryContext.Polygons"/> and its
+	/// <paramref name="pointCount"/> points in <see cref="PathQueryContext.StraightPath"/>.
+	/// </summary>
+	NavMeshPathStatus FindPath( PathQueryContext context, in PathQueryInput input, out int pointCount, out int iterations )
+	{
+		pointCount = 0;
+		iterations = 0;
+
+		var query = context.Query;
+
+		var startFound = query.FindNearestPoly( ToNav( input.Start ), input.SearchExtents, DtQueryNoOpFilter.Shared, out var startPoly, out var startLocation, out _ );
+		if ( !startFound.Succeeded() )
+			return NavMeshPathStatus.StartNotFound;
+
+		var targetFound = query.FindNearestPoly( ToNav( input.Target ), input.SearchExtents, DtQueryNoOpFilter.Shared, out var targetPoly, out var targetLocation, out _ );
+		if ( !targetFound.Succeeded() )
+			return NavMeshPathStatus.TargetNotFound;
+
+		var polygons = context.Polygons;
+		DtStatus dtStatus;
+
+		// Long paths go through the portal graph first, so they aren't cut short by the iteration limit
+		if ( !portalGraph.FindPath( context.PortalSearch, query, startPoly, startLocation, targetPoly, targetLocation, input.Filter, input.MaxIterations, ref polygons, out iterations ) )
 		{
-			result.Status = NavMeshPathStatus.Partial;
+			// Quick search towards the goal.
+			dtStatus = query.InitSlicedFindPath( startPoly, targetPoly, startLocation, targetLocation, input.Filter, 0 );
+			if ( dtStatus.Failed() )
+				return NavMeshPathStatus.PathNotFound;
+
+			dtStatus = query.UpdateSlicedFindPath( input.MaxIterations, out var searched );
+			iterations += searched;
+			if ( dtStatus.Failed() )
+				return NavMeshPathStatus.PathNotFound;
+
+			dtStatus = query.FinalizeSlicedFindPath( ref polygons );
 		}
 		else
 		{
-			result.Status = NavMeshPathStatus.Complete;
+			dtStatus = DtStatus.DT_SUCCESS;
 		}
 
+		context.Polygons = polygons;
 
-		return result;
+		if ( dtStatus.Failed() || polygons.Count == 0 )
+			return NavMeshPathStatus.PathNotFound;
+
+		var straightPath = context.StraightPath;
+		dtStatus = query.FindStraightPath( startLocation, targetLocation, polygons, polygons.Count, straightPath, out pointCount, straightPath.Length, 0 );
+		if ( dtStatus.Failed() )
+		{
+			pointCount = 0;
+			return NavMeshPathStatus.PathNotFound;
+		}
+
+		return polygons[^1] != targetPoly ? NavMeshPathStatus.Partial : NavMeshPathStatus.Complete;
 	}
 }
 
@@ -0,0 +1,236 @@
+﻿using DotRecast.Detour;
+using System.Buffers;
+using System.Collections.Concurrent;
+
+namespace Sandbox.Navigation;
+
+/// <summary>
+/// Navigation Mesh - allowing AI to navigate a world
+/// </summary>
+public sealed partial class NavMesh
+{
+	/// <summary>
+	/// A <see cref="DtNavMeshQuery"/> keeps its node pools and sliced search state on itself, so it can't be shared
+	/// between threads. Each worker rents one of these for as long as it's searching.
+	/// </summary>
+	sealed class PathQueryContext
+	{
+		public const int MaxStraightPathPoints = 4096;
+
+		public readonly DtNavMeshQuery Query;
+		public List<long> Polygons = new( 128 );
+		public readonly DtStraightPath[] StraightPath = new DtStraightPath[MaxStraightPathPoints];
+		public readonly NavMeshPortalGraph.Search PortalSearch = new();
+
+		public PathQueryContext( DtNavMesh navmesh )
+		{
+			Query = new DtNavMeshQuery( navmesh );
+		}
+	}
+
+	/// <summary>
+	/// Everything a path search needs from a <see cref="CalculatePathRequest"/>, read up front on the calling
+	/// thread so the search itself doesn't touch the agent.
+	/// </summary>
+	readonly struct PathQueryInput
+	{
+		public readonly Vector3 Start;
+		public readonly Vector3 Target;
+		public readonly Vector3 SearchExtents;
+		public readonly IDtQueryFilter Filter;
+		public readonly int MaxIterations;
+
+		public PathQueryInput( Vector3 start, Vector3 target, Vector3 searchExtents, IDtQueryFilter filter, int maxIterations )
+		{
+			Start = start;
+			Target = target;
+			SearchExtents = searchExtents;
+			Filter = filter;
+			MaxIterations = maxIterations;
+		}
+	}
+
+	record struct PendingPath( PathQueryInput Input, TaskCompletionSource<NavMeshPath> Source );
+
+	readonly ConcurrentBag<PathQueryContext> _pathQueryContexts = new();
+	readonly ConcurrentQueue<PendingPath> _pendingPaths = new();
+
+	/// <summary>
+	/// How many path search iterations queued path requests can use each update, across all workers.
+	/// Requests that don't fit wait for the next update.
+	/// </summary>
+	[Hide]
+	public int PathQueryBudget { get; set; } = 8192;
+
+	/// <summary>
+	/// Number of path requests waiting for <see cref="CalculatePathAsync"/>.
+	/// </summary>
+	[Hide]
+	public int PendingPathCount => _pendingPaths.Count;
+
+	PathQueryInput GetPathQueryInput( in CalculatePathRequest request )
+	{
+		// In navspace
+		var searchExtents = request.Agent != null ? new Vector3( request.Agent.Radius * 2.01f, request.Agent.Height * 1.51f, request.Agent.Radius * 2.01f ) : crowd._agentPlacementHalfExtents;
+		var filter = request.Agent != null ? request.Agent.agentInternal.option.filter : crowd.GetDefaultFilter();
+
+		return new PathQueryInput( request.Start, request.Target, searchExtents, filter, crowd.Config().maxFindPathIterations );
+	}
+
+	PathQueryContext RentPathQueryContext()
+	{
+		if ( _pathQueryContexts.TryTake( out var context ) )
+			return context;
+
+		return new PathQueryContext( navmeshInternal );
+	}
+
+	void ReturnPathQueryContext( PathQueryContext context )
+	{
+		_pathQueryContexts.Add( context );
+	}
+
+	/// <summary>
+	/// Queue a path to be calculated during the next navmesh update. Paths queued in the same frame are
+	/// searched in parallel, up to <see cref="PathQueryBudget"/> iterations per update, so lots of agents
+	/// re-pathing at once don't stall the frame.
+	/// </summary>
+	public Task<NavMeshPath> CalculatePathAsync( CalculatePathRequest request )
+	{
+		if ( crowd is null )
+		{
+			return Task.FromResult( new NavMeshPath { Status = NavMeshPathStatus.PathNotFound } );
+		}
+
+		var source = new TaskCompletionSource<NavMeshPath>( TaskCreationOptions.RunContinuationsAsynchronously );
+		_pendingPaths.Enqueue( new PendingPath( GetPathQueryInput( request ), source ) );
+
+		return source.Task;
+	}
+
+	/// <summary>
+	/// Calculate a batch of paths right now, spread across worker threads. Each result is the same as
+	/// calling <see cref="CalculatePath"/> with the request at the same index.
+	/// </summary>
+	public void CalculatePaths( ReadOnlySpan<CalculatePathRequest> requests, Span<NavMeshPath> results )
+	{
+		if ( results.Length < requests.Length )
+			throw new ArgumentException( "Not enough room for the results", nameof( results ) );
+
+		var count = requests.Length;
+		if ( count == 0 ) return;
+
+		var inputs = ArrayPool<PathQueryInput>.Shared.Rent( count );
+		var outputs = ArrayPool<NavMeshPath>.Shared.Rent( count );
+
+		try
+		{
+			for ( int i = 0; i < count; i++ )
+			{
+				inputs[i] = GetPathQueryInput( requests[i] );
+			}
+
+			RunPathQueries( inputs, outputs, count );
+
+			outputs.AsSpan( 0, count ).CopyTo( results );
+		}
+		finally
+		{
+			ArrayPool<PathQueryInput>.Shared.Return( inputs, true );
+			ArrayPool<NavMeshPath>.Shared.Return( outputs, true );
+		}
+	}
+
+	/// <summary>
+	/// Search <paramref name="count"/> paths in parallel, each worker using its own query.
+	/// Returns the number of search iterations used in total.
+	/// </summary>
+	int RunPathQueries( PathQueryInput[] inputs, NavMeshPath[] outputs, int count )
+	{
+		int iterations = 0;
+
+		Parallel.For( 0, count, () => RentPathQueryContext(), ( i, _, context ) =>
+		{
+			outputs[i] = CalculatePath( context, inputs[i], out var used );
+			Interlocked.Add( ref iterations, used );
+			return context;
+		}, ReturnPathQueryContext );
+
+		return iterations;
+	}
+
+	/// <summary>
+	/// Run queued path requests until they're all done or the update's budget is used up.
+	/// Called from the main thread while nothing else is changing the navmesh.
+	/// </summary>
+	internal void ProcessPathQueue()
+	{
+		if ( _pendingPaths.IsEmpty )
+			return;
+
+		// Each request can use up to maxFindPathIterations, so take waves of roughly what's left of the budget
+		var maxIterations = Math.Max( 1, crowd.Config().maxFindPathIterations );
+		var waveSize = Math.Max( Environment.ProcessorCount, 1 ) * 4;
+		var budget = PathQueryBudget;
+
+		var pending = ArrayPool<PendingPath>.Shared.Rent( waveSize );
+		var inputs = ArrayPool<PathQueryInput>.Shared.Rent( waveSize );
+		var outputs = ArrayPool<NavMeshPath>.Shared.Rent( waveSize );
+
+		try
+		{
+			while ( budget > 0 )
+			{
+				var take = Math.Clamp( budget / maxIterations, 1, waveSize );
+				var count = 0;
+
+				while ( count < take && _pendingPaths.TryDequeue( out var request ) )
+				{
+					pending[count] = request;
+					inputs[count] = request.Input;
+					count++;
+				}
+
+				if ( count == 0 )
+					break;
+
+				try
+				{
+					budget -= RunPathQueries( inputs, outputs, count );
+				}
+				catch ( Exception e )
+				{
+					for ( int i = 0; i < count; i++ )
+					{
+						pending[i].Source.TrySetException( e );
+					}
+
+					Log.Warning( e, $"Error calculating paths: {e.Message}" );
+					continue;
+				}
+
+				for ( int i = 0; i < count; i++ )
+				{
+					pending[i].Source.TrySetResult( outputs[i] );
+				}
+			}
+		}
+		finally
+		{
+			ArrayPool<PendingPath>.Shared.Return( pending, true );
+			ArrayPool<PathQueryInput>.Shared.Return( inputs, true );
+			ArrayPool<NavMeshPath>.Shared.Return( outputs, true );
+		}
+	}
+
+	/// <summary>
+	/// Finish every queued path request without searching, for when the navmesh is going away or being rebuilt.
+	/// </summary>
+	void CancelPendingPaths()
+	{
+		while ( _pendingPaths.TryDequeue( out var request ) )
+		{
+			request.Source.TrySetResult( new NavMeshPath { Status = NavMeshPathStatus.PathNotFound } );
+		}
+	}
+}
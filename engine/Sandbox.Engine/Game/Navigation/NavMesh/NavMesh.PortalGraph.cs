@@ -0,0 +1,673 @@
+﻿using DotRecast.Detour;
+using Sandbox.Navigation.Generation;
+using System.Runtime.CompilerServices;
+using static DotRecast.Detour.DtDetour;
+
+namespace Sandbox.Navigation;
+
+/// <summary>
+/// A coarse graph over the navmesh for long paths. Each tile is a cluster, and the nodes are portals: runs of
+/// polygon edges on a tile's border that lead into the next tile. Costs between the portals of a tile are worked
+/// out on the build thread, along with the tile's mesh. Crossing into the next tile follows the live navmesh links,
+/// so neighbouring tiles don't need rebuilding when one changes.
+/// <para>
+/// The worked out costs are plain distances. Queries with a filter that cares about areas work costs out again
+/// for tiles that have any areas in them, so cost multipliers and allowed or forbidden areas still shape the route.
+/// </para>
+/// <para>
+/// A long path is searched on this graph first, then refined with regular searches between consecutive portals,
+/// which each only cover a tile or so.
+/// </para>
+/// </summary>
+internal sealed class NavMeshPortalGraph
+{
+	/// <summary>
+	/// Paths between tiles closer than this are searched directly, the graph wouldn't save anything.
+	/// </summary>
+	public const int MinTileDistance = 2;
+
+	/// <summary>
+	/// Give up on the graph search after this many portals and fall back to a direct search.
+	/// </summary>
+	const int MaxExpansions = 16384;
+
+	const long StartKey = -1;
+	const long GoalKey = -2;
+
+	struct Portal
+	{
+		/// <summary>
+		/// The polygon in the middle of the portal, which refined paths go through
+		/// </summary>
+		public int PolyIndex;
+
+		/// <summary>
+		/// Middle of the portal's edge on <see cref="Poly"/>
+		/// </summary>
+		public Vector3 Position;
+
+		/// <summary>
+		/// Which side of the tile the portal is on, as a Detour link side (0, 2, 4 or 6)
+		/// </summary>
+		public int Side;
+
+		/// <summary>
+		/// Every polygon in the tile with an edge in this portal
+		/// </summary>
+		public int[] Members;
+	}
+
+	sealed class Cluster
+	{
+		public int Salt;
+		public long PolyBase;
+
+		/// <summary>
+		/// True if every polygon is in the default area, so area filters treat the whole tile the same
+		/// </summary>
+		public bool Uniform;
+
+		public Vector3[] Centers;
+		public Portal[] Portals;
+
+		/// <summary>
+		/// Cost of getting from one portal to another inside the tile, [from * count + to].
+		/// Infinity if they aren't connected inside the tile.
+		/// </summary>
+		public float[] Costs;
+
+		/// <summary>
+		/// Polygon index * 8 + side to the portal that polygon's edge on that side belongs to
+		/// </summary>
+		public Dictionary<int, int> PolyPortals;
+	}
+
+	/// <summary>
+	/// A polygon edge on the tile border, measured along the border
+	/// </summary>
+	record struct BorderEdge( int Side, int PolyIndex, float Min, float Max, float MinHeight, float MaxHeight, Vector3 Middle );
+
+	/// <summary>
+	/// Working space for one search. Searches only read the graph, so each thread can use its own of these at once.
+	/// </summary>
+	internal sealed class Search
+	{
+		internal readonly Dictionary<long, (float Cost, long Parent, bool Closed)> Nodes = new();
+		internal readonly PriorityQueue<long, float> Open = new();
+		internal readonly PriorityQueue<int, float> TileOpen = new();
+		internal readonly List<long> Route = new();
+		internal List<long> Segment = new( 64 );
+		internal float[] Distances = [];
+		internal float[] StartCosts = [];
+		internal float[] GoalCosts = [];
+		internal float[] TileCosts = [];
+	}
+
+	readonly DtNavMesh _navmesh;
+	Cluster[] _clusters = [];
+
+	/// <summary>
+	/// Clusters built from tile meshes before they're added, see <see cref="Prepare"/>
+	/// </summary>
+	readonly ConditionalWeakTable<DtMeshData, Cluster> _prepared = new();
+
+	public NavMeshPortalGraph( DtNavMesh navmesh )
+	{
+		_navmesh = navmesh;
+	}
+
+	/// <summary>
+	/// Forget every tile, for when the navmesh is initialized again
+	/// </summary>
+	public void Clear()
+	{
+		_clusters = new Cluster[_navmesh.GetMaxTiles()];
+	}
+
+	/// <summary>
+	/// Build the portals of a tile's mesh ahead of it being added to the navmesh. Safe to call from any thread,
+	/// so tile build tasks do this to keep it off the main thread.
+	/// </summary>
+	public void Prepare( DtMeshData data )
+	{
+		if ( data?.header is null )
+			return;
+
+		_prepared.AddOrUpdate( data, Build( data ) );
+	}
+
+	/// <summary>
+	/// Add the portals of a tile that's just been added to the navmesh, or replaced. They're built here
+	/// if the tile's mesh wasn't passed to <see cref="Prepare"/> first.
+	/// </summary>
+	public void AddTile( long tileRef )
+	{
+		var tile = _navmesh.GetTileByRef( tileRef );
+		if ( tile?.data?.header is null )
+			return;
+
+		if ( _clusters.Length != _navmesh.GetMaxTiles() )
+			Clear();
+
+		var cluster = _prepared.GetValue( tile.data, Build );
+		cluster.Salt = tile.salt;
+		cluster.PolyBase = _navmesh.GetPolyRefBase( tile );
+
+		_clusters[tile.index] = cluster;
+	}
+
+	/// <summary>
+	/// Forget a tile before it's removed from the navmesh
+	/// </summary>
+	public void RemoveTile( long tileRef )
+	{
+		var index = DecodePolyIdTile( tileRef );
+		if ( index < _clusters.Length )
+		{
+			_clusters[index] = null;
+		}
+	}
+
+	Cluster GetCluster( int tileIndex )
+	{
+		if ( tileIndex >= _clusters.Length )
+			return null;
+
+		var cluster = _clusters[tileIndex];
+		if ( cluster is null || cluster.Salt != _navmesh.GetTile( tileIndex ).salt )
+			return null;
+
+		return cluster;
+	}
+
+	Cluster Build( DtMeshData data )
+	{
+		var polyCount = data.header.polyCount;
+
+		var cluster = new Cluster
+		{
+			Uniform = true,
+			Centers = new Vector3[polyCount],
+			PolyPortals = new(),
+		};
+
+		var edges = new List<BorderEdge>();
+
+		for ( int ip = 0; ip < polyCount; ip++ )
+		{
+			var poly = data.polys[ip];
+
+			var center = Vector3.Zero;
+			for ( int i = 0; i < poly.vertCount; i++ )
+			{
+				center += data.verts[poly.verts[i]];
+			}
+			cluster.Centers[ip] = center / poly.vertCount;
+
+			if ( poly.type != DtPolyTypes.DT_POLYTYPE_GROUND )
+				continue;
+
+			if ( poly.area != Constants.WALKABLE_AREA )
+				cluster.Uniform = false;
+
+			for ( int j = 0; j < poly.vertCount; j++ )
+			{
+				if ( (poly.neis[j] & DT_EXT_LINK) == 0 )
+					continue;
+
+				var side = poly.neis[j] & 0xff;
+				var a = data.verts[poly.verts[j]];
+				var b = data.verts[poly.verts[(j + 1) % poly.vertCount]];
+
+				// Sides 0 and 4 are the x borders, so the edge runs along z
+				var alongA = side is 0 or 4 ? a.z : a.x;
+				var alongB = side is 0 or 4 ? b.z : b.x;
+
+				edges.Add( alongA < alongB
+					? new BorderEdge( side, ip, alongA, alongB, a.y, b.y, (a + b) * 0.5f )
+					: new BorderEdge( side, ip, alongB, alongA, b.y, a.y, (a + b) * 0.5f ) );
+			}
+		}
+
+		var portals = new List<Portal>();
+		var maxWidth = _navmesh.GetParams().tileWidth * 0.25f;
+		var climb = data.header.walkableClimb;
+
+		foreach ( var run in GroupEdges( edges, climb ) )
+		{
+			// Long runs are split, so the middle of a portal is never too far from where a path crosses it
+			var start = 0;
+			for ( int i = 1; i <= run.Count; i++ )
+			{
+				if ( i < run.Count && run[i].Max - run[start].Min <= maxWidth )
+					continue;
+
+				AddPortal( portals, cluster, run, start, i );
+				start = i;
+			}
+		}
+
+		cluster.Portals = portals.ToArray();
+
+		var count = portals.Count;
+		cluster.Costs = new float[count * count];
+
+		var distances = new float[polyCount];
+		var open = new PriorityQueue<int, float>();
+
+		for ( int i = 0; i < count; i++ )
+		{
+			FindTileDistances( data, cluster, portals[i].PolyIndex, portals[i].Position, null, distances, open );
+
+			for ( int j = 0; j < count; j++ )
+			{
+				cluster.Costs[i * count + j] = i == j ? 0 : ExitCost( cluster, portals[j], null, distances );
+			}
+		}
+
+		return cluster;
+	}
+
+	/// <summary>
+	/// Split the border edges into runs on the same side that touch each other, at about the same height
+	/// </summary>
+	static IEnumerable<List<BorderEdge>> GroupEdges( List<BorderEdge> edges, float climb )
+	{
+		const float tolerance = 0.01f;
+
+		var group = new int[edges.Count];
+		for ( int i = 0; i < group.Length; i++ ) group[i] = i;
+
+		int Find( int i )
+		{
+			while ( group[i] != i ) i = group[i] = group[group[i]];
+			return i;
+		}
+
+		for ( int i = 0; i < edges.Count; i++ )
+		{
+			for ( int j = i + 1; j < edges.Count; j++ )
+			{
+				var a = edges[i];
+				var b = edges[j];
+
+				if ( a.Side != b.Side )
+					continue;
+
+				bool joined;
+				if ( a.Max <= b.Min + tolerance ) joined = b.Min - a.Max <= tolerance && MathF.Abs( a.MaxHeight - b.MinHeight ) <= climb;
+				else if ( b.Max <= a.Min + tolerance ) joined = a.Min - b.Max <= tolerance && MathF.Abs( b.MaxHeight - a.MinHeight ) <= climb;
+				else joined = MathF.Abs( a.Middle.y - b.Middle.y ) <= climb;
+
+				if ( joined )
+				{
+					group[Find( i )] = Find( j );
+				}
+			}
+		}
+
+		return Enumerable.Range( 0, edges.Count )
+			.GroupBy( Find )
+			.Select( x => x.Select( i => edges[i] ).OrderBy( e => e.Min ).ToList() );
+	}
+
+	static void AddPortal( List<Portal> portals, Cluster cluster, List<BorderEdge> run, int start, int end )
+	{
+		var middle = (run[start].Min + run[end - 1].Max) * 0.5f;
+
+		var best = start;
+		for ( int i = start + 1; i < end; i++ )
+		{
+			if ( MathF.Abs( (run[i].Min + run[i].Max) * 0.5f - middle ) < MathF.Abs( (run[best].Min + run[best].Max) * 0.5f - middle ) )
+				best = i;
+		}
+
+		var side = run[start].Side;
+		var members = new List<int>();
+
+		for ( int i = start; i < end; i++ )
+		{
+			var ip = run[i].PolyIndex;
+			if ( members.Contains( ip ) )
+				continue;
+
+			members.Add( ip );
+			cluster.PolyPortals.TryAdd( ip * 8 + side, portals.Count );
+		}
+
+		portals.Add( new Portal
+		{
+			PolyIndex = run[best].PolyIndex,
+			Position = run[best].Middle,
+			Side = side,
+			Members = members.ToArray(),
+		} );
+	}
+
+	/// <summary>
+	/// Dijkstra from a polygon out to the rest of the tile, going from polygon centre to polygon centre.
+	/// Only needs the tile's mesh, not the navmesh links, so it works before the tile is added.
+	/// With a <paramref name="filter"/>, polygons it doesn't pass are avoided and steps cost what it says.
+	/// </summary>
+	static void FindTileDistances( DtMeshData data, Cluster cluster, int startPoly, Vector3 startPosition, IDtQueryFilter filter, float[] distances, PriorityQueue<int, float> open )
+	{
+		var centers = cluster.Centers;
+
+		Array.Fill( distances, float.PositiveInfinity, 0, centers.Length );
+
+		if ( !Passes( cluster, startPoly, filter ) )
+			return;
+
+		distances[startPoly] = StepCost( cluster, startPoly, startPosition, centers[startPoly], filter );
+
+		open.Clear();
+		open.Enqueue( startPoly, distances[startPoly] );
+
+		while ( open.TryDequeue( out var ip, out var distance ) )
+		{
+			if ( distance > distances[ip] )
+				continue;
+
+			var poly = data.polys[ip];
+
+			for ( int j = 0; j < poly.vertCount; j++ )
+			{
+				// Neighbours inside the tile are stored as index + 1
+				var nei = poly.neis[j];
+				if ( nei == 0 || (nei & DT_EXT_LINK) != 0 )
+					continue;
+
+				var next = nei - 1;
+				if ( !Passes( cluster, next, filter ) )
+					continue;
+
+				var nextDistance = distance + StepCost( cluster, next, centers[ip], centers[next], filter );
+
+				if ( nextDistance < distances[next] )
+				{
+					distances[next] = nextDistance;
+					open.Enqueue( next, nextDistance );
+				}
+			}
+		}
+	}
+
+	static float ExitCost( Cluster cluster, in Portal portal, IDtQueryFilter filter, float[] distances )
+	{
+		return distances[portal.PolyIndex] + StepCost( cluster, portal.PolyIndex, cluster.Centers[portal.PolyIndex], portal.Position, filter );
+	}
+
+	static bool Passes( Cluster cluster, int polyIndex, IDtQueryFilter filter )
+	{
+		return filter is null || filter.PassFilter( cluster.PolyBase | (long)polyIndex );
+	}
+
+	/// <summary>
+	/// Cost of moving between two points in a polygon, plain distance without a filter
+	/// </summary>
+	static float StepCost( Cluster cluster, int polyIndex, Vector3 from, Vector3 to, IDtQueryFilter filter )
+	{
+		return filter is null
+			? (to - from).Length
+			: filter.GetCost( from, to, 0, cluster.PolyBase | (long)polyIndex, 0 );
+	}
+
+	static long PortalKey( int tileIndex, int portal ) => ((long)tileIndex << 16) | (long)portal;
+
+	/// <summary>
+	/// Find a path between two polygons through the portal graph, then refine it with <paramref name="query"/>.
+	/// Returns false if the polygons are too close together for the graph to help, or if the graph couldn't
+	/// find a full path, in which case the caller should search directly.
+	/// </summary>
+	public bool FindPath( Search search, DtNavMeshQuery query, long startRef, Vector3 startPos, long endRef, Vector3 endPos, IDtQueryFilter filter, int maxIterations, ref List<long> path, out int iterations )
+	{
+		iterations = 0;
+
+		if ( _navmesh.GetTileAndPolyByRef( startRef, out var startTile, out _ ).Failed() ) return false;
+		if ( _navmesh.GetTileAndPolyByRef( endRef, out var endTile, out _ ).Failed() ) return false;
+
+		var startHeader = startTile.data.header;
+		var endHeader = endTile.data.header;
+
+		if ( Math.Max( Math.Abs( startHeader.x - endHeader.x ), Math.Abs( startHeader.y - endHeader.y ) ) < MinTileDistance )
+			return false;
+
+		var startCluster = GetCluster( startTile.index );
+		var endCluster = GetCluster( endTile.index );
+
+		if ( startCluster is null || endCluster is null )
+			return false;
+
+		// Filters that treat every polygon the same can use the costs worked out when the tiles were built
+		var costFilter = filter is null or DtQueryNoOpFilter or DtQueryDefaultFilter ? null : filter;
+
+		// How far it is from each end to the portals of its tile
+		FindEndCosts( search, startTile, startCluster, DecodePolyIdPoly( startRef ), startPos, costFilter, ref search.StartCosts );
+		FindEndCosts( search, endTile, endCluster, DecodePolyIdPoly( endRef ), endPos, costFilter, ref search.GoalCosts );
+
+		if ( !FindRoute( search, startTile.index, startCluster, endTile.index, endCluster, endPos, costFilter, ref iterations ) )
+			return false;
+
+		return Refine( search, query, startRef, startPos, endRef, endPos, filter, maxIterations, ref path, ref iterations );
+	}
+
+	void FindEndCosts( Search search, DtMeshTile tile, Cluster cluster, int polyIndex, Vector3 position, IDtQueryFilter filter, ref float[] costs )
+	{
+		if ( costs.Length < cluster.Portals.Length )
+			costs = new float[cluster.Portals.Length];
+
+		FindPortalCosts( search, tile, cluster, polyIndex, position, filter, costs );
+	}
+
+	/// <summary>
+	/// Cost from a point in the tile out to each of its portals
+	/// </summary>
+	static void FindPortalCosts( Search search, DtMeshTile tile, Cluster cluster, int polyIndex, Vector3 position, IDtQueryFilter filter, float[] costs )
+	{
+		if ( search.Distances.Length < cluster.Centers.Length )
+			search.Distances = new float[cluster.Centers.Length];
+
+		FindTileDistances( tile.data, cluster, polyIndex, position, filter, search.Distances, search.TileOpen );
+
+		for ( int i = 0; i < cluster.Portals.Length; i++ )
+		{
+			costs[i] = ExitCost( cluster, cluster.Portals[i], filter, search.Distances );
+		}
+	}
+
+	/// <summary>
+	/// A* over the portals, leaving the portals to go through in <see cref="Search.Route"/>
+	/// </summary>
+	bool FindRoute( Search search, int startTile, Cluster startCluster, int endTile, Cluster endCluster, Vector3 endPos, IDtQueryFilter filter, ref int iterations )
+	{
+		var nodes = search.Nodes;
+		var open = search.Open;
+
+		nodes.Clear();
+		open.Clear();
+		search.Route.Clear();
+
+		void Visit( long key, long parent, float cost, Vector3 position )
+		{
+			if ( nodes.TryGetValue( key, out var node ) && (node.Closed || node.Cost <= cost) )
+				return;
+
+			nodes[key] = (cost, parent, false);
+			open.Enqueue( key, cost + (endPos - position).Length );
+		}
+
+		for ( int i = 0; i < startCluster.Portals.Length; i++ )
+		{
+			if ( float.IsFinite( search.StartCosts[i] ) )
+			{
+				Visit( PortalKey( startTile, i ), StartKey, search.StartCosts[i], startCluster.Portals[i].Position );
+			}
+		}
+
+		while ( open.TryDequeue( out var key, out _ ) )
+		{
+			if ( ++iterations > MaxExpansions )
+				return false;
+
+			if ( key == GoalKey )
+			{
+				for ( var k = nodes[GoalKey].Parent; k != StartKey; k = nodes[k].Parent )
+				{
+					search.Route.Add( k );
+				}
+
+				search.Route.Reverse();
+				return true;
+			}
+
+			var node = nodes[key];
+			if ( node.Closed )
+				continue;
+
+			nodes[key] = node with { Closed = true };
+
+			var tileIndex = (int)(key >> 16);
+			var portalIndex = (int)(key & 0xffff);
+			var cluster = GetCluster( tileIndex );
+			if ( cluster is null )
+				continue;
+
+			ref readonly var portal = ref cluster.Portals[portalIndex];
+			var count = cluster.Portals.Length;
+			var tile = _navmesh.GetTile( tileIndex );
+
+			if ( tileIndex == endTile && float.IsFinite( search.GoalCosts[portalIndex] ) )
+			{
+				Visit( GoalKey, key, node.Cost + search.GoalCosts[portalIndex], endPos );
+			}
+
+			// Across the tile
+			if ( filter is null || cluster.Uniform )
+			{
+				for ( int i = 0; i < count; i++ )
+				{
+					var cost = cluster.Costs[portalIndex * count + i];
+					if ( i == portalIndex || !float.IsFinite( cost ) || !Passes( cluster, cluster.Portals[i].PolyIndex, filter ) )
+						continue;
+
+					Visit( PortalKey( tileIndex, i ), key, node.Cost + cost, cluster.Portals[i].Position );
+				}
+			}
+			else
+			{
+				// The filter could treat areas in this tile differently, so the built costs don't apply
+				if ( search.TileCosts.Length < count )
+					search.TileCosts = new float[count];
+
+				FindPortalCosts( search, tile, cluster, portal.PolyIndex, portal.Position, filter, search.TileCosts );
+
+				for ( int i = 0; i < count; i++ )
+				{
+					var cost = search.TileCosts[i];
+					if ( i == portalIndex || !float.IsFinite( cost ) )
+						continue;
+
+					Visit( PortalKey( tileIndex, i ), key, node.Cost + cost, cluster.Portals[i].Position );
+				}
+			}
+
+			// Into the next tile, through whatever the navmesh has linked this portal's polygons to
+			var oppositeSide = (portal.Side + 4) & 0x7;
+
+			foreach ( var ip in portal.Members )
+			{
+				var poly = tile.data.polys[ip];
+
+				for ( int i = poly.firstLink; i != DT_NULL_LINK; i = tile.links[i].next )
+				{
+					var link = tile.links[i];
+					if ( link.refs == 0 || link.side != portal.Side )
+						continue;
+
+					var nextTile = DecodePolyIdTile( link.refs );
+					var nextCluster = GetCluster( nextTile );
+
+					if ( nextCluster is null || !nextCluster.PolyPortals.TryGetValue( DecodePolyIdPoly( link.refs ) * 8 + oppositeSide, out var next ) )
+						continue;
+
+					var nextPortal = nextCluster.Portals[next];
+					if ( !Passes( nextCluster, nextPortal.PolyIndex, filter ) )
+						continue;
+
+					var cost = StepCost( nextCluster, nextPortal.PolyIndex, portal.Position, nextPortal.Position, filter );
+					Visit( PortalKey( nextTile, next ), key, node.Cost + cost, nextPortal.Position );
+				}
+			}
+		}
+
+		return false;
+	}
+
+	/// <summary>
+	/// Search between each pair of portals on the route and join up the polygons
+	/// </summary>
+	bool Refine( Search search, DtNavMeshQuery query, long startRef, Vector3 startPos, long endRef, Vector3 endPos, IDtQueryFilter filter, int maxIterations, ref List<long> path, ref int iterations )
+	{
+		path.Clear();
+
+		var fromRef = startRef;
+		var fromPos = startPos;
+
+		for ( int i = 0; i <= search.Route.Count; i++ )
+		{
+			long toRef;
+			Vector3 toPos;
+
+			if ( i < search.Route.Count )
+			{
+				var key = search.Route[i];
+				var cluster = _clusters[(int)(key >> 16)];
+				ref readonly var portal = ref cluster.Portals[(int)(key & 0xffff)];
+
+				toRef = cluster.PolyBase | (long)portal.PolyIndex;
+				toPos = portal.Position;
+			}
+			else
+			{
+				toRef = endRef;
+				toPos = endPos;
+			}
+
+			if ( toRef == fromRef )
+				continue;
+
+			if ( query.InitSlicedFindPath( fromRef, toRef, fromPos, toPos, filter, 0 ).Failed() )
+				return false;
+
+			query.UpdateSlicedFindPath( maxIterations, out var used );
+			iterations += used;
+
+			var segment = search.Segment;
+			var status = query.FinalizeSlicedFindPath( ref segment );
+			search.Segment = segment;
+
+			if ( status.Failed() || segment.Count == 0 || segment[^1] != toRef )
+				return false;
+
+			// Each segment starts where the last one finished
+			var first = path.Count > 0 && path[^1] == segment[0] ? 1 : 0;
+
+			for ( int j = first; j < segment.Count; j++ )
+			{
+				// Don't step back into the polygon we just came from
+				if ( path.Count > 1 && path[^2] == segment[j] )
+				{
+					path.RemoveAt( path.Count - 1 );
+					continue;
+				}
+
+				path.Add( segment[j] );
+			}
+
+			fromRef = toRef;
+			fromPos = toPos;
+		}
+
+		return path.Count > 0 && path[^1] == endRef;
+	}
+}
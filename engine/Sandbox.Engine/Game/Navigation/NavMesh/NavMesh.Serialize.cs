@@ -7,7 +7,8 @@ public sealed partial class NavMesh
 	/// <summary>
 	/// Data saved in a Scene file
 	/// </summary>
-	internal JsonObject Serialize()
+	/// <param name="includeTiles">Bake the generated tiles into the data, see <see cref="SerializeBakedTiles"/></param>
+	internal JsonObject Serialize( bool includeTiles = false )
 	{
 		JsonObject jso = new JsonObject();
 
@@ -22,6 +23,11 @@ public sealed partial class NavMesh
 		jso["ExcludedBodies"] = Json.ToNode( ExcludedBodies, typeof( TagSet ) );
 		jso["IncludedBodies"] = Json.ToNode( IncludedBodies, typeof( TagSet ) );
 
+		if ( includeTiles && IsEnabled && !IsGenerating && SerializeBakedTiles() is { } tiles )
+		{
+			jso["Tiles"] = tiles;
+		}
+
 		return jso;
 	}
 
@@ -44,5 +50,7 @@ public sealed partial class NavMesh
 
 		ExcludedBodies = Json.FromNode( jso["ExcludedBodies"], typeof( TagSet ) ) as TagSet ?? ExcludedBodies;
 		IncludedBodies = Json.FromNode( jso["IncludedBodies"], typeof( TagSet ) ) as TagSet ?? IncludedBodies;
+
+		DeserializeBakedTiles( (string)jso["Tiles"] );
 	}
 }
@@ -14,6 +14,28 @@ internal class NavMeshTile : IDisposable
 
 	public bool IsHeightFieldValid => _cachedHeightField != null;
 
+	/// <summary>
+	/// Hash of the geometry and settings this tile was last generated from, or 0 if it hasn't been.
+	/// </summary>
+	public ulong GeometryHash;
+
+	/// <summary>
+	/// The tile's mesh was loaded from the scene rather than generated, so it doesn't have a heightfield to
+	/// rebuild the navmesh from. Anything that needs the navmesh rebuilt has to do a full rebuild instead.
+	/// </summary>
+	public bool IsBaked;
+
+	public bool HasSpatialData
+	{
+		get
+		{
+			lock ( _spatialData )
+			{
+				return _spatialData.Count > 0;
+			}
+		}
+	}
+
 	public void HeightfieldBuildComplete()
 	{
 		IsHeightfieldBuildInProgress = false;
@@ -72,6 +94,7 @@ internal class NavMeshTile : IDisposable
 			_cachedHeightField.Dispose();
 		}
 		_cachedHeightField = chf;
+		IsBaked = false;
 	}
 
 	public void DispatchNavmeshBuild( NavMesh navMesh )
@@ -83,37 +106,67 @@ internal class NavMeshTile : IDisposable
 
 		Task.Run( () =>
 		{
-			var chf = _cachedHeightField;
-			var navMeshData = BuildNavmesh( chf, generatorConfig, navMesh );
+			DtMeshData navMeshData;
 
-			MainThread.Queue( () =>
+			try
+			{
+				var chf = _cachedHeightField;
+				navMeshData = BuildNavmesh( chf, generatorConfig, navMesh );
+			}
+			catch ( Exception e )
 			{
-				navMesh.LoadTileOnMainThread( this, navMeshData );
+				Log.Warning( $"Navmesh: Exception while building navmesh for tile {TilePosition.x},{TilePosition.y}" );
+				Log.Warning( e );
 
-				NavmeshBuildComplete();
-			} );
+				// Keep whatever mesh the tile already had, but let it be rebuilt
+				MainThread.Queue( NavmeshBuildComplete );
+				return;
+			}
+
+			// Swapped in by the tile cache on the main thread, a few per frame
+			navMesh.tileCache.CompleteNavmeshBuild( this, navMeshData );
 		} );
 
 	}
 
-	public void DispatchHeightFieldBuild( NavMesh navMesh, PhysicsWorld physicsWorld )
+	/// <summary>
+	/// Collect this tile's geometry from the snapshot and build its heightfield, all off the main thread.
+	/// </summary>
+	public void DispatchHeightFieldBuild( NavMesh navMesh, GeometrySnapshot snapshot )
 	{
-		ThreadSafe.AssertIsMainThread();
-
 		var generatorConfig = navMesh.CreateTileGenerationConfig( TilePosition );
 
 		IsHeightfieldBuildInProgress = true;
 		IsFullRebuildRequested = false;
 
-		var heightFieldGenerator = NavMesh.HeightFieldGeneratorPool.Get();
-		heightFieldGenerator.Init( generatorConfig );
-		heightFieldGenerator.CollectGeometry( navMesh, physicsWorld, generatorConfig.Bounds );
-
 		Task.Run( () =>
 		{
-			var heightFieldData = heightFieldGenerator.Generate();
+			CompactHeightfield heightFieldData;
+
+			var heightFieldGenerator = NavMesh.HeightFieldGeneratorPool.Get();
+			try
+			{
+				heightFieldGenerator.Init( generatorConfig );
+				heightFieldGenerator.CollectGeometry( snapshot, generatorConfig.Bounds );
+
+				GeometryHash = heightFieldGenerator.GetGeometryHash();
+
+				heightFieldData = heightFieldGenerator.Generate();
+			}
+			catch ( Exception e )
+			{
+				Log.Warning( $"Navmesh: Exception while building heightfield for tile {TilePosition.x},{TilePosition.y}" );
+				Log.Warning( e );
 
-			NavMesh.HeightFieldGeneratorPool.Return( heightFieldGenerator );
+				// Leave the tile as it was, but let it be rebuilt
+				MainThread.Queue( HeightfieldBuildComplete );
+				return;
+			}
+			finally
+			{
+				// Return generator regardless of success/failure
+				NavMesh.HeightFieldGeneratorPool.Return( heightFieldGenerator );
+			}
 
 			MainThread.Queue( () =>
 			{
@@ -212,6 +265,9 @@ internal class NavMeshTile : IDisposable
 
 			var result = DtNavMeshBuilder.CreateNavMeshData( createParams );
 
+			// Work out the tile's portals here too, rather than on the main thread when it's swapped in
+			navMesh.portalGraph.Prepare( result );
+
 			return result;
 		}
 		finally
@@ -16,12 +16,15 @@ public sealed partial class NavMesh : IDisposable
 
 	internal DtNavMeshQuery query;
 
+	internal NavMeshPortalGraph portalGraph;
+
 	// Making this only work from Scene.NavMesh for now. There's no real reason we can't let
 	// then create these and manage them themselves. But for now, early days, I want to lock
 	// it down to only required functionality.
 	internal NavMesh()
 	{
 		navmeshInternal = new DtNavMesh();
+		portalGraph = new NavMeshPortalGraph( navmeshInternal );
 	}
 
 	~NavMesh()
@@ -32,6 +35,7 @@ public sealed partial class NavMesh : IDisposable
 	public void Dispose()
 	{
 		tileCache.Dispose();
+		CancelPendingPaths();
 
 		GC.SuppressFinalize( this );
 	}
@@ -173,6 +177,7 @@ public sealed partial class NavMesh : IDisposable
 		};
 
 		navmeshInternal.Init( navMeshParams, 6 );
+		portalGraph.Clear();
 
 		DtCrowdConfig crowdConfig = new DtCrowdConfig( AgentRadius, AgentHeight );
 		crowdConfig.topologyOptimizationTimeThreshold = 1f;
@@ -202,6 +207,34 @@ public sealed partial class NavMesh : IDisposable
 		OnInit?.Invoke();
 	}
 
+	/// <summary>
+	/// Per phase timings of the crowd update, listed alongside <see cref="PerformanceStats.Timings.NavMesh"/>.
+	/// Only registered once a crowd has actually been updated, so they don't show up for games without agents.
+	/// </summary>
+	static PerformanceStats.Timings[] CrowdTimings;
+
+	/// <summary>
+	/// Move every agent in the crowd and record how long each part of it took
+	/// </summary>
+	internal void UpdateCrowd( float delta )
+	{
+		if ( crowd.GetActiveAgents().Count == 0 )
+			return;
+
+		crowd.Update( delta, new DtCrowdAgentDebugInfo() );
+
+		CrowdTimings ??= DtCrowdTelemetry.Labels
+			.Select( x => PerformanceStats.Timings.Get( $"NavMesh/Crowd/{x}", PerformanceStats.Timings.NavMesh.Color ) )
+			.ToArray();
+
+		var telemetry = crowd.Telemetry();
+
+		foreach ( var label in DtCrowdTelemetry.Labels )
+		{
+			CrowdTimings[(int)label].AddMilliseconds( telemetry.GetMilliseconds( label ) );
+		}
+	}
+
 	internal void HandleEditorAutoUpdate( PhysicsWorld world )
 	{
 		WorldBounds = CalculateWorldBounds( world );
@@ -239,6 +272,9 @@ public sealed partial class NavMesh : IDisposable
 			WorldBounds = CalculateWorldBounds( world );
 
 			await GenerateTiles( world, WorldBounds );
+
+			// Anything left over no longer lines up with a tile
+			_bakedTiles = null;
 		}
 		finally
 		{
@@ -272,6 +272,14 @@ public abstract partial class GameResource : Resource, ISourceLineProvider
 
 		_jsonHash = json.FastHash();
 
+		LoadFromJson( ParseJson( json ) );
+	}
+
+	/// <summary>
+	/// Parse resource json into an object. This doesn't touch the resource, so it can run on any thread.
+	/// </summary>
+	internal static JsonObject ParseJson( string json )
+	{
 		var docOptions = new JsonDocumentOptions();
 		docOptions.MaxDepth = 512;
 
@@ -285,6 +293,11 @@ public abstract partial class GameResource : Resource, ISourceLineProvider
 			throw new ArgumentException( "Couldn't load json" );
 		}
 
+		return jso;
+	}
+
+	void LoadFromJson( JsonObject jso )
+	{
 		JsonUpgrade( jso );
 		jso.Remove( "__version" );
 
@@ -328,6 +341,25 @@ public abstract partial class GameResource : Resource, ISourceLineProvider
 		return true;
 	}
 
+	/// <summary>
+	/// Like <see cref="TryLoadFromData(Span{byte})"/>, but with the json already read out and parsed by
+	/// <see cref="ResourceSystem.ReadGameResource"/>, which can happen on another thread.
+	/// </summary>
+	internal bool TryLoadFromData( in ResourceSystem.GameResourceData read )
+	{
+		if ( read.Json is null )
+			return false;
+
+		if ( read.JsonHash == _jsonHash )
+			return false;
+
+		_jsonHash = read.JsonHash;
+
+		LoadFromJson( read.Node ?? ParseJson( read.Json ) );
+		LoadFromResource( read.Data );
+		return true;
+	}
+
 	internal virtual bool LoadFromResource( Span<byte> data )
 	{
 		return false;
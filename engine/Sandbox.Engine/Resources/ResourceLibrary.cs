@@ -2,6 +2,7 @@
 using Sandbox.Engine;
 using System.Reflection;
 using System.Runtime.InteropServices;
+using System.Text.Json.Nodes;
 using static Sandbox.ResourceLibrary;
 
 namespace Sandbox;
@@ -10,6 +11,17 @@ public class ResourceSystem
 {
 	private Dictionary<int, Resource> ResourceIndex { get; } = new();
 
+	/// <summary>
+	/// Where to find a GameResource that's been indexed by <see cref="AddPendingGameResource"/> but not loaded yet.
+	/// </summary>
+	private record struct PendingGameResource( AssetTypeAttribute Type, string File, BaseFileSystem FileSystem );
+
+	/// <summary>
+	/// Indexed GameResources, by <see cref="Resource.ResourceId"/>, that will be loaded the first time they're asked for.
+	/// Like <see cref="ResourceIndex"/>, this is only changed on the main thread.
+	/// </summary>
+	private Dictionary<int, PendingGameResource> PendingIndex { get; } = new();
+
 	internal void Register( Resource resource )
 	{
 		Log.Trace( $"Registering {resource.GetType()} ( {resource.ResourcePath} ) as {resource.ResourceId}" );
@@ -35,6 +47,7 @@ public class ResourceSystem
 			// so just remove it from the index to ensure we don't retrieve it anymore
 
 			ResourceIndex.Remove( resource.ResourceId );
+			PendingIndex.Remove( resource.ResourceId );
 		}
 		else
 		{
@@ -59,6 +72,7 @@ public class ResourceSystem
 		var toDispose = ResourceIndex.Values.ToArray();
 
 		ResourceIndex.Clear();
+		PendingIndex.Clear();
 
 		foreach ( var resource in toDispose.OfType<GameResource>() )
 		{
@@ -74,7 +88,7 @@ public class ResourceSystem
 			return null;
 
 		if ( resource.GetType().IsAssignableTo( t ) )
-			return resource;
+			return Materialize( resource );
 
 		return null;
 	}
@@ -96,7 +110,7 @@ public class ResourceSystem
 		if ( !ResourceIndex.TryGetValue( identifier, out var resource ) )
 			return default;
 
-		return resource as T;
+		return Materialize( resource as T );
 	}
 
 	/// <summary>
@@ -130,7 +144,17 @@ public class ResourceSystem
 	/// <typeparam name="T">Resource type to get.</typeparam>
 	public IEnumerable<T> GetAll<T>()
 	{
-		return ResourceIndex.Values.OfType<T>().Distinct();
+		var all = ResourceIndex.Values.OfType<T>().Distinct();
+
+		if ( PendingIndex.Count == 0 )
+			return all;
+
+		// Loading a pending resource can add more promises to the index, so walk a copy
+		return all.ToArray().Select( x =>
+		{
+			if ( x is Resource r ) Materialize( r );
+			return x;
+		} );
 	}
 
 	/// <summary>
@@ -143,7 +167,7 @@ public class ResourceSystem
 	{
 		filepath = filepath.Replace( '\\', '/' );
 		if ( !filepath.EndsWith( "/" ) ) filepath += "/";
-		return ResourceIndex.Values.OfType<T>().Distinct().Where( x =>
+		var all = ResourceIndex.Values.OfType<T>().Distinct().Where( x =>
 		{
 			if ( x.ResourcePath.StartsWith( filepath ) )
 			{
@@ -152,6 +176,70 @@ public class ResourceSystem
 			}
 			return false;
 		} );
+
+		if ( PendingIndex.Count == 0 )
+			return all;
+
+		return all.ToArray().Select( Materialize );
+	}
+
+	/// <summary>
+	/// Index a GameResource without reading it. A promise is registered straight away so it can be found
+	/// and referenced, and the file is only read and deserialized the first time something gets it.
+	/// If it's already indexed or loaded, it'll be read again from <paramref name="fs"/> the next time
+	/// something gets it, like loading it straight away would have done.
+	/// On a dedicated server, the packages it references are installed when it's loaded, not when it's indexed.
+	/// </summary>
+	internal void AddPendingGameResource( AssetTypeAttribute type, string file, BaseFileSystem fs )
+	{
+		ThreadSafe.AssertIsMainThread();
+
+		if ( !file.EndsWith( "_c" ) ) file += "_c";
+
+		var id = Resource.FixPath( file ).FastHash();
+
+		// Look in the index directly, getting it would load whatever was indexed before
+		if ( !ResourceIndex.TryGetValue( id, out var existing ) || !existing.GetType().IsAssignableTo( type.TargetType ) )
+		{
+			if ( GameResource.GetPromise( type.TargetType, file ) is null )
+				return;
+		}
+
+		PendingIndex[id] = new PendingGameResource( type, file, fs );
+	}
+
+	/// <summary>
+	/// Whether <paramref name="filepath"/> has been indexed but not loaded yet, and which filesystem it'll be loaded from.
+	/// </summary>
+	internal bool IsPending( string filepath, out BaseFileSystem fileSystem )
+	{
+		var found = PendingIndex.TryGetValue( Resource.FixPath( filepath ).FastHash(), out var pending );
+		fileSystem = pending.FileSystem;
+		return found;
+	}
+
+	/// <summary>
+	/// If <paramref name="resource"/> was only indexed by <see cref="AddPendingGameResource"/>, load it now.
+	/// Anything it references is loaded as it deserializes, so their PostLoad runs before its own.
+	/// Loading reads the file through native code and registers resources, so the first get of a pending
+	/// resource has to happen on the main thread. Getting resources that are already loaded is fine anywhere.
+	/// </summary>
+	private T Materialize<T>( T resource ) where T : Resource
+	{
+		if ( resource is null || PendingIndex.Count == 0 )
+			return resource;
+
+		if ( !PendingIndex.ContainsKey( resource.ResourceId ) )
+			return resource;
+
+		ThreadSafe.AssertIsMainThread();
+
+		// Take it out first, so resources that reference each other don't keep loading each other
+		if ( !PendingIndex.Remove( resource.ResourceId, out var pending ) )
+			return resource;
+
+		LoadGameResource( pending.Type, pending.File, pending.FileSystem );
+		return resource;
 	}
 
 	/// <summary>
@@ -284,16 +372,84 @@ public class ResourceSystem
 
 		if ( !file.EndsWith( "_c" ) ) file += "_c";
 
-		Span<byte> data = null;
+		GameResourceData read;
 
 		try
 		{
-			if ( fs.FileExists( file ) )
+			read = ReadGameResource( file, fs );
+		}
+		catch ( System.Exception ex )
+		{
+			Log.Warning( ex, $"		Error when deserializing {file} ({ex.Message})" );
+			return null;
+		}
+
+		return LoadGameResource( type, file, read, deferPostload );
+	}
+
+	/// <summary>
+	/// A compiled GameResource read from disk with its json pulled out, ready to be loaded into the resource by
+	/// <see cref="LoadGameResource(AssetTypeAttribute, string, in GameResourceData, bool)"/>. <see cref="Node"/> is
+	/// only set if the json has already been parsed, see <see cref="ParseGameResource"/>.
+	/// </summary>
+	internal readonly record struct GameResourceData( byte[] Data, string Json, int JsonHash, JsonObject Node, int? SourceHash );
+
+	/// <summary>
+	/// Read a compiled GameResource and pull its json out. This goes through native code, so keep it on the main thread.
+	/// </summary>
+	internal GameResourceData ReadGameResource( string file, BaseFileSystem fs )
+	{
+		if ( !fs.FileExists( file ) )
+			return default;
+
+		byte[] data;
+
+		using ( var stream = fs.OpenRead( file ) )
+		{
+			data = new byte[stream.Length];
+			stream.ReadExactly( data );
+		}
+
+		if ( data.Length <= 3 )
+			return default;
+
+		var json = ReadCompiledResourceJson( data );
+
+		int? sourceHash = null;
+
+		if ( Application.IsEditor )
+		{
+			var sourceFilePath = file.Substring( 0, file.Length - 2 );
+			if ( fs.FileExists( sourceFilePath ) )
 			{
-				data = fs.ReadAllBytes( file );
+				sourceHash = fs.ReadAllText( sourceFilePath ).FastHash();
 			}
+		}
 
-			if ( data.Length <= 3 )
+		return new GameResourceData( data, json, json?.FastHash() ?? 0, null, sourceHash );
+	}
+
+	/// <summary>
+	/// Parse the json of a resource read by <see cref="ReadGameResource"/>. This is managed only and doesn't touch
+	/// the resource or the library, so lots of these can run in parallel. Throws if the json can't be parsed.
+	/// </summary>
+	internal static GameResourceData ParseGameResource( in GameResourceData read )
+	{
+		if ( read.Json is null || read.Node is not null )
+			return read;
+
+		return read with { Node = GameResource.ParseJson( read.Json ) };
+	}
+
+	/// <summary>
+	/// Create or update and register a GameResource from data that's already been read by <see cref="ReadGameResource"/>.
+	/// Must be called on the main thread.
+	/// </summary>
+	internal GameResource LoadGameResource( AssetTypeAttribute type, string file, in GameResourceData read, bool deferPostload = false )
+	{
+		try
+		{
+			if ( read.Data is null || read.Data.Length <= 3 )
 			{
 				Log.Warning( $"		Skipping {file} (is null)" );
 				return null;
@@ -302,16 +458,11 @@ public class ResourceSystem
 			var se = GameResource.GetPromise( type.TargetType, file );
 			if ( se is null ) return null;
 
-			se.TryLoadFromData( data );
+			se.TryLoadFromData( read );
 
-			if ( Application.IsEditor )
+			if ( read.SourceHash is { } sourceHash )
 			{
-				var sourceFilePath = file.Substring( 0, file.Length - 2 );
-				if ( fs.FileExists( sourceFilePath ) )
-				{
-					var jsonBlob = fs.ReadAllText( sourceFilePath );
-					se.LastSavedSourceHash = jsonBlob.FastHash();
-				}
+				se.LastSavedSourceHash = sourceHash;
 			}
 
 			//
@@ -319,7 +470,7 @@ public class ResourceSystem
 			//
 			if ( Application.IsDedicatedServer )
 			{
-				InstallReferences( se );
+				InstallReferences( se.GetReferencedPackages() );
 			}
 
 			Register( se );
@@ -340,9 +491,10 @@ public class ResourceSystem
 	/// <summary>
 	/// Installs all references for a GameResource 
 	/// </summary>
-	private void InstallReferences( GameResource se )
+	private void InstallReferences( IEnumerable<string> references )
 	{
-		var references = se.GetReferencedPackages();
+		if ( references is null )
+			return;
 
 		foreach ( var r in references )
 		{
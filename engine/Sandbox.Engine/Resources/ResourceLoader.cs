@@ -5,34 +5,113 @@ namespace Sandbox;
 
 internal static class ResourceLoader
 {
-
-
-	internal static void LoadAllGameResource( BaseFileSystem fileSystem )
+	/// <summary>
+	/// Only index GameResources when loading them all, and read each one the first time it's used.
+	/// Worth turning on for servers running games with lots of content they'll never touch.
+	/// The first get of each resource has to be on the main thread, and a dedicated server only installs
+	/// the packages a resource references once it's been used.
+	/// </summary>
+	[ConVar( "resource_lazyload", ConVarFlags.Protected, Help = "Index GameResources at startup and only load each one the first time it's used" )]
+	internal static bool LazyLoad { get; set; }
+
+	/// <summary>
+	/// How many files we read before parsing them all at once. Keeps only this many parsed but unloaded
+	/// resources around at a time.
+	/// </summary>
+	const int ParseBatchSize = 64;
+
+	/// <summary>
+	/// Load every GameResource in <paramref name="fileSystem"/>. If the caller already knows which files it
+	/// has, like a downloaded package's manifest, pass them as <paramref name="files"/> to skip walking
+	/// every directory.
+	/// </summary>
+	internal static void LoadAllGameResource( BaseFileSystem fileSystem, IEnumerable<string> files = null )
 	{
 		var sw = Stopwatch.StartNew();
 		var types = Game.TypeLibrary.GetAttributes<AssetTypeAttribute>().DistinctBy( x => x.Extension )
 			.ToDictionary( x => $".{x.Extension}_c", x => x, StringComparer.OrdinalIgnoreCase );
 
-		var allFiles = fileSystem.FindFile( "/", "*", true ).ToArray();
+		var allFiles = (files ?? fileSystem.FindFile( "/", "*", true ))
+			.Select( x => (File: x, Type: types.GetValueOrDefault( System.IO.Path.GetExtension( x ) )) )
+			.Where( x => x.Type is not null )
+			.ToArray();
+
+		if ( LazyLoad )
+		{
+			Clear();
+			foreach ( var (file, type) in allFiles )
+			{
+				Game.Resources.AddPendingGameResource( type, file, fileSystem );
+			}
 
-		var allResources = new List<GameResource>();
+			AddWatchers( types.Values );
+			return;
+		}
+
+		//
+		// Reading the files and pulling the json out goes through native code, so that stays on this thread.
+		// Parsing the json is all managed and doesn't touch anything shared, so each batch gets parsed in
+		// parallel. Creating, deserializing and registering the resources stays on this thread.
+		//
+		var batch = new ResourceSystem.GameResourceData[ParseBatchSize];
+		var failed = new bool[ParseBatchSize];
+
+		var allResources = new List<GameResource>( allFiles.Length );
 
 		Clear();
-		foreach ( var file in allFiles )
+		for ( int start = 0; start < allFiles.Length; start += ParseBatchSize )
 		{
-			var extension = System.IO.Path.GetExtension( file );
-
-			if ( !types.TryGetValue( extension, out var type ) )
-				continue;
+			var count = Math.Min( ParseBatchSize, allFiles.Length - start );
 
-			try
+			for ( int i = 0; i < count; i++ )
 			{
-				var se = Game.Resources.LoadGameResource( type, file, fileSystem, true );
-				if ( se != null ) allResources.Add( se );
+				failed[i] = false;
+
+				try
+				{
+					batch[i] = Game.Resources.ReadGameResource( allFiles[start + i].File, fileSystem );
+				}
+				catch ( Exception ex )
+				{
+					failed[i] = true;
+					Log.Warning( ex, $"Exception when trying to load {allFiles[start + i].File}" );
+				}
 			}
-			catch ( Exception ex )
+
+			Parallel.For( 0, count, i =>
+			{
+				if ( failed[i] )
+					return;
+
+				try
+				{
+					batch[i] = ResourceSystem.ParseGameResource( batch[i] );
+				}
+				catch ( Exception ex )
+				{
+					failed[i] = true;
+					Log.Warning( ex, $"Exception when trying to load {allFiles[start + i].File}" );
+				}
+			} );
+
+			for ( int i = 0; i < count; i++ )
 			{
-				Log.Warning( ex, $"Exception when trying to load {file}" );
+				if ( failed[i] )
+					continue;
+
+				var (file, type) = allFiles[start + i];
+
+				try
+				{
+					var se = Game.Resources.LoadGameResource( type, file, batch[i], true );
+					if ( se != null ) allResources.Add( se );
+				}
+				catch ( Exception ex )
+				{
+					Log.Warning( ex, $"Exception when trying to load {file}" );
+				}
+
+				batch[i] = default;
 			}
 		}
 
@@ -46,10 +125,7 @@ internal static class ResourceLoader
 			resource.PostLoadInternal();
 		}
 
-		foreach ( var type in types )
-		{
-			AddWatcherForType( type.Value );
-		}
+		AddWatchers( types.Values );
 
 		// TODO: Check for edited but not saved OR recompiled assets and load in their values on server/client
 		// like editing an asset while the gamemode is running would?
@@ -61,6 +137,14 @@ internal static class ResourceLoader
 
 	static Dictionary<string, FileWatch> Watchers = new();
 
+	static void AddWatchers( IEnumerable<AssetTypeAttribute> types )
+	{
+		foreach ( var type in types )
+		{
+			AddWatcherForType( type );
+		}
+	}
+
 	static void AddWatcherForType( AssetTypeAttribute type )
 	{
 		if ( Watchers.TryGetValue( type.Name, out var watcher ) )
@@ -0,0 +1,236 @@
+﻿using System.Buffers;
+using System.IO;
+
+namespace Sandbox;
+
+public partial class TerrainStorage
+{
+	/// <summary>
+	/// Past this many separate dirty regions they all get merged into one.
+	/// </summary>
+	const int MaxDirtyRegions = 16;
+
+	/// <summary>
+	/// How many edits we remember. Anyone further behind than this just gets the whole map.
+	/// </summary>
+	const int MaxDirtyLog = 256;
+
+	const byte EditVersion = 1;
+
+	/// <summary>
+	/// Every region marked dirty, tagged with an increasing version. Each <see cref="Terrain"/> using this storage
+	/// remembers the last version it synced, so they all see every edit no matter which of them updates first.
+	/// Only touched on the main thread, so there's no lock.
+	/// </summary>
+	readonly List<(long Version, Terrain.SyncFlags Flags, RectInt Region)> _dirtyLog = new();
+
+	/// <summary>
+	/// The newest version that has been dropped from <see cref="_dirtyLog"/>.
+	/// </summary>
+	long _droppedDirtyVersion;
+
+	/// <summary>
+	/// The version of the last region marked dirty.
+	/// </summary>
+	internal long DirtyVersion { get; private set; }
+
+	/// <summary>
+	/// Mark a region of the maps as changed after editing them on the CPU. Any <see cref="Terrain"/> using this
+	/// storage uploads just the changed texels and refreshes just the collider cells under them on its next update,
+	/// so lots of small edits in a frame only cost one sync.
+	/// </summary>
+	/// <remarks>
+	/// Has to be called on the main thread, the same as the terrain components that read the dirty regions.
+	/// </remarks>
+	public void MarkDirty( Terrain.SyncFlags flags, RectInt region )
+	{
+		ThreadSafe.AssertIsMainThread();
+
+		region = ClampRegion( region );
+
+		if ( flags == 0 || region.Width <= 0 || region.Height <= 0 )
+			return;
+
+		_dirtyLog.Add( (++DirtyVersion, flags, region) );
+
+		if ( _dirtyLog.Count <= MaxDirtyLog )
+			return;
+
+		var dropped = _dirtyLog.Count - MaxDirtyLog / 2;
+		_droppedDirtyVersion = _dirtyLog[dropped - 1].Version;
+		_dirtyLog.RemoveRange( 0, dropped );
+	}
+
+	/// <summary>
+	/// Add everything marked dirty after <paramref name="version"/> to <paramref name="regions"/>, merged together,
+	/// and move <paramref name="version"/> up to <see cref="DirtyVersion"/>.
+	/// </summary>
+	internal void GetDirtyRegions( ref long version, List<(Terrain.SyncFlags Flags, RectInt Region)> regions )
+	{
+		ThreadSafe.AssertIsMainThread();
+
+		if ( version >= DirtyVersion )
+			return;
+
+		if ( version < _droppedDirtyVersion )
+		{
+			// Missed some edits, so sync the lot
+			AddDirtyRegion( regions, Terrain.SyncFlags.Height | Terrain.SyncFlags.Control | Terrain.SyncFlags.Holes, new RectInt( 0, 0, Resolution, Resolution ) );
+			version = DirtyVersion;
+			return;
+		}
+
+		foreach ( var (entryVersion, flags, region) in _dirtyLog )
+		{
+			if ( entryVersion > version )
+				AddDirtyRegion( regions, flags, region );
+		}
+
+		version = DirtyVersion;
+	}
+
+	static void AddDirtyRegion( List<(Terrain.SyncFlags Flags, RectInt Region)> regions, Terrain.SyncFlags flags, RectInt region )
+	{
+		// Merge with any region it touches, which might then touch another
+
+		for ( var i = regions.Count - 1; i >= 0; i-- )
+		{
+			var other = regions[i];
+
+			if ( other.Region.Left > region.Right || region.Left > other.Region.Right ) continue;
+			if ( other.Region.Top > region.Bottom || region.Top > other.Region.Bottom ) continue;
+
+			region = Union( region, other.Region );
+			flags |= other.Flags;
+
+			regions.RemoveAt( i );
+			i = regions.Count;
+		}
+
+		regions.Add( (flags, region) );
+
+		if ( regions.Count <= MaxDirtyRegions )
+			return;
+
+		foreach ( var other in regions )
+		{
+			region = Union( region, other.Region );
+			flags |= other.Flags;
+		}
+
+		regions.Clear();
+		regions.Add( (flags, region) );
+	}
+
+	RectInt ClampRegion( RectInt region )
+	{
+		region.Left = Math.Clamp( region.Left, 0, Resolution );
+		region.Top = Math.Clamp( region.Top, 0, Resolution );
+		region.Right = Math.Clamp( region.Right, region.Left, Resolution );
+		region.Bottom = Math.Clamp( region.Bottom, region.Top, Resolution );
+
+		return region;
+	}
+
+	static RectInt Union( RectInt a, RectInt b )
+	{
+		var left = Math.Min( a.Left, b.Left );
+		var top = Math.Min( a.Top, b.Top );
+
+		return new RectInt( left, top, Math.Max( a.Right, b.Right ) - left, Math.Max( a.Bottom, b.Bottom ) - top );
+	}
+
+	/// <summary>
+	/// Pack what's currently in a region of the maps into a compressed edit, small enough to send to clients after
+	/// a runtime edit like a crater. Apply it on the other end with <see cref="ApplyEdit"/>.
+	/// </summary>
+	public byte[] CreateEdit( Terrain.SyncFlags flags, RectInt region )
+	{
+		region = ClampRegion( region );
+
+		using var stream = ByteStream.Create( 32 + region.Width * region.Height * 7 );
+
+		stream.Write( EditVersion );
+		stream.Write( (int)flags );
+		stream.Write( region.Left );
+		stream.Write( region.Top );
+		stream.Write( region.Width );
+		stream.Write( region.Height );
+
+		if ( flags.HasFlag( Terrain.SyncFlags.Height ) )
+			WriteRegion( ref stream, HeightMap, region );
+		if ( flags.HasFlag( Terrain.SyncFlags.Control ) )
+			WriteRegion( ref stream, ControlMap, region );
+		if ( flags.HasFlag( Terrain.SyncFlags.Holes ) )
+			WriteRegion( ref stream, HolesMap, region );
+
+		using var compressed = stream.Compress();
+		return compressed.ToArray();
+	}
+
+	/// <summary>
+	/// Write an edit from <see cref="CreateEdit"/> into the maps and mark it dirty, returning which maps changed and where.
+	/// Has to be called on the main thread.
+	/// </summary>
+	public (Terrain.SyncFlags Flags, RectInt Region) ApplyEdit( ReadOnlySpan<byte> edit )
+	{
+		using var compressed = ByteStream.CreateReader( edit );
+		using var stream = compressed.Decompress();
+
+		if ( stream.Read<byte>() != EditVersion )
+			throw new InvalidDataException( "Unknown terrain edit version" );
+
+		var flags = (Terrain.SyncFlags)stream.Read<int>();
+		var region = new RectInt( stream.Read<int>(), stream.Read<int>(), stream.Read<int>(), stream.Read<int>() );
+
+		if ( region.Left < 0 || region.Top < 0 || region.Width < 0 || region.Height < 0 || region.Right > Resolution || region.Bottom > Resolution )
+			throw new InvalidDataException( "Terrain edit is outside of the terrain" );
+
+		if ( flags.HasFlag( Terrain.SyncFlags.Height ) )
+			ReadRegion( ref stream, HeightMap, region );
+		if ( flags.HasFlag( Terrain.SyncFlags.Control ) )
+			ReadRegion( ref stream, ControlMap, region );
+		if ( flags.HasFlag( Terrain.SyncFlags.Holes ) )
+			ReadRegion( ref stream, HolesMap, region );
+
+		MarkDirty( flags, region );
+
+		return (flags, region);
+	}
+
+	void WriteRegion<T>( ref ByteStream stream, T[] map, RectInt region ) where T : unmanaged
+	{
+		var count = region.Width * region.Height;
+		var buffer = ArrayPool<T>.Shared.Rent( count );
+
+		try
+		{
+			for ( var y = 0; y < region.Height; y++ )
+			{
+				map.AsSpan( (region.Top + y) * Resolution + region.Left, region.Width )
+					.CopyTo( buffer.AsSpan( y * region.Width ) );
+			}
+
+			stream.WriteArray( new ReadOnlySpan<T>( buffer, 0, count ) );
+		}
+		finally
+		{
+			ArrayPool<T>.Shared.Return( buffer );
+		}
+	}
+
+	void ReadRegion<T>( ref ByteStream stream, T[] map, RectInt region ) where T : unmanaged
+	{
+		var count = region.Width * region.Height;
+		var texels = stream.ReadArraySpan<T>( Math.Max( count, 1 ) );
+
+		if ( texels.Length != count )
+			throw new InvalidDataException( "Terrain edit is the wrong size" );
+
+		for ( var y = 0; y < region.Height; y++ )
+		{
+			texels.Slice( y * region.Width, region.Width )
+				.CopyTo( map.AsSpan( (region.Top + y) * Resolution + region.Left ) );
+		}
+	}
+}
@@ -0,0 +1,346 @@
+﻿using System.Buffers;
+using System.IO;
+using System.IO.Compression;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using System.Text.Json;
+
+namespace Sandbox;
+
+public partial class TerrainStorage
+{
+	/// <summary>
+	/// A square terrain map split into tiles that are each compressed on their own, so they can be
+	/// decompressed in parallel, straight into the final map, or just the ones covering a region.
+	/// Heights are stored as the difference from a prediction made from their neighbours, anything else
+	/// as the difference from the texel to the left. Either way the bytes of each texel are split into
+	/// planes before compressing, so the mostly zero high bytes end up together.
+	/// </summary>
+	private sealed class TerrainTiles
+	{
+		public const int DefaultTileSize = 256;
+
+		/// <summary>
+		/// Width and height of the whole map.
+		/// </summary>
+		public int Size { get; }
+
+		/// <summary>
+		/// Width and height of each tile, apart from ones along the far edges if the size doesn't divide evenly.
+		/// </summary>
+		public int TileSize { get; }
+
+		/// <summary>
+		/// Deflate compressed tiles, row by row.
+		/// </summary>
+		public byte[][] Tiles { get; }
+
+		int TilesPerRow => (Size + TileSize - 1) / TileSize;
+
+		TerrainTiles( int size, int tileSize, byte[][] tiles )
+		{
+			if ( size < 0 || tileSize <= 0 )
+				throw new InvalidDataException( $"Invalid terrain map size {size} with tile size {tileSize}" );
+
+			Size = size;
+			TileSize = tileSize;
+			Tiles = tiles;
+
+			if ( tiles.Length != TilesPerRow * TilesPerRow )
+				throw new InvalidDataException( $"Expected {TilesPerRow * TilesPerRow} tiles for a {size}x{size} terrain map, got {tiles.Length}" );
+		}
+
+		/// <summary>
+		/// Split up and compress a map, or returns null if it isn't square.
+		/// </summary>
+		public static TerrainTiles Encode<T>( T[] map, int tileSize = DefaultTileSize ) where T : unmanaged
+		{
+			if ( map is null || map.Length == 0 )
+				return null;
+
+			var size = (int)Math.Sqrt( map.Length );
+			if ( size * size != map.Length )
+				return null;
+
+			var tilesPerRow = (size + tileSize - 1) / tileSize;
+			var tiles = new byte[tilesPerRow * tilesPerRow][];
+			var result = new TerrainTiles( size, tileSize, tiles );
+
+			Parallel.For( 0, tiles.Length, i =>
+			{
+				result.GetTileRect( i, out var x, out var y, out var w, out var h );
+				tiles[i] = EncodeTile<T>( map.AsSpan( y * size + x ), size, w, h );
+			} );
+
+			return result;
+		}
+
+		/// <summary>
+		/// Decompress every tile into a new map.
+		/// </summary>
+		public T[] Decode<T>() where T : unmanaged
+		{
+			var map = new T[Size * Size];
+
+			Parallel.For( 0, Tiles.Length, i =>
+			{
+				GetTileRect( i, out var x, out var y, out var w, out var h );
+				DecodeTile<T>( Tiles[i], map.AsSpan( y * Size + x ), Size, w, h );
+			} );
+
+			return map;
+		}
+
+		/// <summary>
+		/// Decompress only the tiles overlapping a region, copying the region into <paramref name="result"/> row by row.
+		/// </summary>
+		public void DecodeRegion<T>( int x, int y, int w, int h, Span<T> result ) where T : unmanaged
+		{
+			if ( x < 0 || y < 0 || w < 0 || h < 0 || x + w > Size || y + h > Size )
+				throw new ArgumentOutOfRangeException( nameof( x ), "Region is outside of the terrain map" );
+
+			if ( result.Length < w * h )
+				throw new ArgumentException( "Not enough room for the region", nameof( result ) );
+
+			if ( w == 0 || h == 0 )
+				return;
+
+			var scratch = ArrayPool<T>.Shared.Rent( TileSize * TileSize );
+
+			try
+			{
+				for ( var tileY = y / TileSize; tileY <= (y + h - 1) / TileSize; tileY++ )
+				{
+					for ( var tileX = x / TileSize; tileX <= (x + w - 1) / TileSize; tileX++ )
+					{
+						GetTileRect( tileY * TilesPerRow + tileX, out var x0, out var y0, out var tileW, out var tileH );
+						DecodeTile<T>( Tiles[tileY * TilesPerRow + tileX], scratch, tileW, tileW, tileH );
+
+						var minX = Math.Max( x, x0 );
+						var maxX = Math.Min( x + w, x0 + tileW );
+
+						for ( var row = Math.Max( y, y0 ); row < Math.Min( y + h, y0 + tileH ); row++ )
+						{
+							scratch.AsSpan( (row - y0) * tileW + minX - x0, maxX - minX )
+								.CopyTo( result.Slice( (row - y) * w + minX - x ) );
+						}
+					}
+				}
+			}
+			finally
+			{
+				ArrayPool<T>.Shared.Return( scratch );
+			}
+		}
+
+		void GetTileRect( int index, out int x, out int y, out int w, out int h )
+		{
+			x = index % TilesPerRow * TileSize;
+			y = index / TilesPerRow * TileSize;
+			w = Math.Min( TileSize, Size - x );
+			h = Math.Min( TileSize, Size - y );
+		}
+
+		static byte[] EncodeTile<T>( ReadOnlySpan<T> src, int stride, int w, int h ) where T : unmanaged
+		{
+			var length = w * h * Unsafe.SizeOf<T>();
+			var planes = ArrayPool<byte>.Shared.Rent( length );
+
+			try
+			{
+				if ( typeof( T ) == typeof( ushort ) )
+					EncodeHeights( MemoryMarshal.Cast<T, ushort>( src ), stride, w, h, planes );
+				else
+					EncodeTexels( MemoryMarshal.AsBytes( src ), stride, Unsafe.SizeOf<T>(), w, h, planes );
+
+				using var stream = new MemoryStream();
+				using ( var deflate = new DeflateStream( stream, CompressionMode.Compress ) )
+				{
+					deflate.Write( planes, 0, length );
+				}
+
+				return stream.ToArray();
+			}
+			finally
+			{
+				ArrayPool<byte>.Shared.Return( planes );
+			}
+		}
+
+		static void DecodeTile<T>( byte[] tile, Span<T> dst, int stride, int w, int h ) where T : unmanaged
+		{
+			var length = w * h * Unsafe.SizeOf<T>();
+			var planes = ArrayPool<byte>.Shared.Rent( length );
+
+			try
+			{
+				using ( var deflate = new DeflateStream( new MemoryStream( tile ), CompressionMode.Decompress ) )
+				{
+					deflate.ReadExactly( planes, 0, length );
+				}
+
+				if ( typeof( T ) == typeof( ushort ) )
+					DecodeHeights( planes, MemoryMarshal.Cast<T, ushort>( dst ), stride, w, h );
+				else
+					DecodeTexels( planes, MemoryMarshal.AsBytes( dst ), stride, Unsafe.SizeOf<T>(), w, h );
+			}
+			finally
+			{
+				ArrayPool<byte>.Shared.Return( planes );
+			}
+		}
+
+		/// <summary>
+		/// Predict a height from the ones already seen to its left and above, using the median edge detector
+		/// from LOCO-I: across a slope it's the plane through the three neighbours, and at a ridge or cliff
+		/// it's whichever neighbour is on the same side.
+		/// </summary>
+		static int PredictHeight( ReadOnlySpan<ushort> map, int index, int stride, int row, int column )
+		{
+			if ( column == 0 ) return row == 0 ? 0 : map[index - stride];
+			if ( row == 0 ) return map[index - 1];
+
+			int left = map[index - 1];
+			int up = map[index - stride];
+			int upLeft = map[index - stride - 1];
+
+			if ( upLeft >= Math.Max( left, up ) ) return Math.Min( left, up );
+			if ( upLeft <= Math.Min( left, up ) ) return Math.Max( left, up );
+
+			return left + up - upLeft;
+		}
+
+		static void EncodeHeights( ReadOnlySpan<ushort> src, int stride, int w, int h, Span<byte> planes )
+		{
+			var low = planes[..(w * h)];
+			var high = planes.Slice( w * h, w * h );
+
+			for ( var row = 0; row < h; row++ )
+			{
+				for ( var column = 0; column < w; column++ )
+				{
+					var index = row * stride + column;
+					var residual = (short)(src[index] - PredictHeight( src, index, stride, row, column ));
+					var zigzag = (ushort)((residual << 1) ^ (residual >> 15));
+
+					low[row * w + column] = (byte)zigzag;
+					high[row * w + column] = (byte)(zigzag >> 8);
+				}
+			}
+		}
+
+		static void DecodeHeights( ReadOnlySpan<byte> planes, Span<ushort> dst, int stride, int w, int h )
+		{
+			var low = planes[..(w * h)];
+			var high = planes.Slice( w * h, w * h );
+
+			for ( var row = 0; row < h; row++ )
+			{
+				for ( var column = 0; column < w; column++ )
+				{
+					var index = row * stride + column;
+					var zigzag = low[row * w + column] | (high[row * w + column] << 8);
+					var residual = (zigzag >> 1) ^ -(zigzag & 1);
+
+					dst[index] = (ushort)(PredictHeight( dst, index, stride, row, column ) + residual);
+				}
+			}
+		}
+
+		static void EncodeTexels( ReadOnlySpan<byte> src, int stride, int texelSize, int w, int h, Span<byte> planes )
+		{
+			var rowBytes = stride * texelSize;
+
+			for ( var row = 0; row < h; row++ )
+			{
+				for ( var column = 0; column < w; column++ )
+				{
+					for ( var channel = 0; channel < texelSize; channel++ )
+					{
+						var index = row * rowBytes + column * texelSize + channel;
+						var previous = column > 0 ? src[index - texelSize] : row > 0 ? src[index - rowBytes] : 0;
+
+						planes[channel * w * h + row * w + column] = (byte)(src[index] - previous);
+					}
+				}
+			}
+		}
+
+		static void DecodeTexels( ReadOnlySpan<byte> planes, Span<byte> dst, int stride, int texelSize, int w, int h )
+		{
+			var rowBytes = stride * texelSize;
+
+			for ( var row = 0; row < h; row++ )
+			{
+				for ( var column = 0; column < w; column++ )
+				{
+					for ( var channel = 0; channel < texelSize; channel++ )
+					{
+						var index = row * rowBytes + column * texelSize + channel;
+						var previous = column > 0 ? dst[index - texelSize] : row > 0 ? dst[index - rowBytes] : 0;
+
+						dst[index] = (byte)(previous + planes[channel * w * h + row * w + column]);
+					}
+				}
+			}
+		}
+
+		public void JsonWrite( Utf8JsonWriter writer, string name )
+		{
+			writer.WriteStartObject( name );
+			writer.WriteNumber( "size", Size );
+			writer.WriteNumber( "tilesize", TileSize );
+			writer.WriteStartArray( "tiles" );
+
+			foreach ( var tile in Tiles )
+			{
+				writer.WriteBase64StringValue( tile );
+			}
+
+			writer.WriteEndArray();
+			writer.WriteEndObject();
+		}
+
+		/// <summary>
+		/// Read an object written by <see cref="JsonWrite"/>, leaving the reader on its end.
+		/// </summary>
+		public static TerrainTiles JsonRead( ref Utf8JsonReader reader )
+		{
+			var size = 0;
+			var tileSize = DefaultTileSize;
+			var tiles = new List<byte[]>();
+
+			reader.Read();
+
+			while ( reader.TokenType != JsonTokenType.EndObject )
+			{
+				var name = reader.GetString();
+				reader.Read();
+
+				if ( name == "size" )
+				{
+					size = reader.GetInt32();
+				}
+				else if ( name == "tilesize" )
+				{
+					tileSize = reader.GetInt32();
+				}
+				else if ( name == "tiles" )
+				{
+					while ( reader.Read() && reader.TokenType != JsonTokenType.EndArray )
+					{
+						tiles.Add( reader.GetBytesFromBase64() );
+					}
+				}
+				else
+				{
+					reader.Skip();
+				}
+
+				reader.Read();
+			}
+
+			return new TerrainTiles( size, tileSize, tiles.ToArray() );
+		}
+	}
+}
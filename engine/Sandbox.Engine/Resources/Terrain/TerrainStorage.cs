@@ -3,6 +3,7 @@ using System.IO.Compression;
 using System.Runtime.InteropServices;
 using System.Text.Json;
 using System.Text.Json.Serialization;
+using System.Threading;
 
 namespace Sandbox;
 
@@ -41,6 +42,16 @@ public partial class TerrainStorage : GameResource
 
 	public TerrainMaterialSettings MaterialSettings { get; set; } = new();
 
+	/// <summary>
+	/// Copy a region of the height map into <paramref name="heights"/>, row by row. If nothing has touched
+	/// <see cref="HeightMap"/> since loading, only the tiles covering the region get decompressed.
+	/// The terrain component doesn't use this, the collider and height texture both need the whole map.
+	/// </summary>
+	public void GetHeightMapRegion( int x, int y, int w, int h, Span<ushort> heights )
+	{
+		Maps.ReadHeightMapRegion( Resolution, x, y, w, h, heights );
+	}
+
 	public TerrainStorage()
 	{
 		SetResolution( 512 );
@@ -148,13 +159,78 @@ public partial class TerrainStorage : GameResource
 	}
 
 	/// <summary>
-	/// Contains terrain maps that get compressed
+	/// Contains terrain maps that get compressed. Maps are written as <see cref="TerrainTiles"/>, and loaded
+	/// maps stay compressed until something asks for them.
 	/// </summary>
 	private class TerrainMaps : IJsonConvert
 	{
-		public ushort[] HeightMap { get; set; }
-		public Color32[] SplatMap { get; set; }
-		public byte[] HolesMap { get; set; }
+		ushort[] _heightMap;
+		Color32[] _splatMap;
+		byte[] _holesMap;
+
+		TerrainTiles _heightTiles;
+		TerrainTiles _splatTiles;
+		TerrainTiles _holesTiles;
+
+		readonly Lock _lock = new Lock();
+
+		public ushort[] HeightMap
+		{
+			get => Volatile.Read( ref _heightMap ) ?? Decode( ref _heightMap, ref _heightTiles );
+			set { lock ( _lock ) { _heightMap = value; _heightTiles = null; } }
+		}
+
+		public Color32[] SplatMap
+		{
+			get => Volatile.Read( ref _splatMap ) ?? Decode( ref _splatMap, ref _splatTiles );
+			set { lock ( _lock ) { _splatMap = value; _splatTiles = null; } }
+		}
+
+		public byte[] HolesMap
+		{
+			get => Volatile.Read( ref _holesMap ) ?? Decode( ref _holesMap, ref _holesTiles );
+			set { lock ( _lock ) { _holesMap = value; _holesTiles = null; } }
+		}
+
+		/// <summary>
+		/// Maps can be first asked for from several threads at once (the collider and the renderer), so only
+		/// one of them decodes and the rest wait for it. Once decoded the map can be edited in place, so the
+		/// tiles are out of date from then on and get dropped.
+		/// </summary>
+		T[] Decode<T>( ref T[] map, ref TerrainTiles tiles ) where T : unmanaged
+		{
+			lock ( _lock )
+			{
+				if ( map is null && tiles is not null )
+				{
+					Volatile.Write( ref map, tiles.Decode<T>() );
+					tiles = null;
+				}
+
+				return map;
+			}
+		}
+
+		public void ReadHeightMapRegion( int size, int x, int y, int w, int h, Span<ushort> heights )
+		{
+			// Tiles are never modified, so if we still have them it doesn't matter if someone decodes the
+			// whole map while we read from them
+			var tiles = Volatile.Read( ref _heightTiles );
+
+			if ( tiles is not null )
+			{
+				tiles.DecodeRegion( x, y, w, h, heights );
+				return;
+			}
+
+			if ( x < 0 || y < 0 || w < 0 || h < 0 || x + w > size || y + h > size )
+				throw new ArgumentOutOfRangeException( nameof( x ), "Region is outside of the terrain map" );
+
+			for ( int row = 0; row < h; row++ )
+			{
+				HeightMap.AsSpan( (y + row) * size + x, w ).CopyTo( heights.Slice( row * w ) );
+			}
+		}
 
 		public static object JsonRead( ref Utf8JsonReader reader, Type typeToConvert )
 		{
@@ -172,23 +248,37 @@ public partial class TerrainStorage : GameResource
 					var name = reader.GetString();
 					reader.Read();
 
+					// Older terrain has each map as a single base64 deflated string
+
 					if ( name == "heightmap" )
 					{
-						maps.HeightMap = Decompress<ushort>( reader.GetBytesFromBase64() ).ToArray();
+						if ( reader.TokenType == JsonTokenType.StartObject )
+							maps._heightTiles = TerrainTiles.JsonRead( ref reader );
+						else
+							maps.HeightMap = Decompress<ushort>( reader.GetBytesFromBase64() ).ToArray();
+
 						reader.Read();
 						continue;
 					}
 
 					if ( name == "splatmap" )
 					{
-						maps.SplatMap = Decompress<Color32>( reader.GetBytesFromBase64() ).ToArray();
+						if ( reader.TokenType == JsonTokenType.StartObject )
+							maps._splatTiles = TerrainTiles.JsonRead( ref reader );
+						else
+							maps.SplatMap = Decompress<Color32>( reader.GetBytesFromBase64() ).ToArray();
+
 						reader.Read();
 						continue;
 					}
 
 					if ( name == "holesmap" )
 					{
-						maps.HolesMap = Decompress<byte>( reader.GetBytesFromBase64() ).ToArray();
+						if ( reader.TokenType == JsonTokenType.StartObject )
+							maps._holesTiles = TerrainTiles.JsonRead( ref reader );
+						else
+							maps.HolesMap = Decompress<byte>( reader.GetBytesFromBase64() ).ToArray();
+
 						reader.Read();
 						continue;
 					}
@@ -211,12 +301,34 @@ public partial class TerrainStorage : GameResource
 				throw new NotImplementedException();
 
 			writer.WriteStartObject();
-			writer.WriteBase64String( "heightmap", Compress( maps.HeightMap.AsSpan() ) );
-			writer.WriteBase64String( "splatmap", Compress( maps.SplatMap.AsSpan() ) );
-			writer.WriteBase64String( "holesmap", Compress( maps.HolesMap.AsSpan() ) );
+
+			lock ( maps._lock )
+			{
+				WriteMap( writer, "heightmap", maps._heightMap, maps._heightTiles );
+				WriteMap( writer, "splatmap", maps._splatMap, maps._splatTiles );
+				WriteMap( writer, "holesmap", maps._holesMap, maps._holesTiles );
+			}
+
 			writer.WriteEndObject();
 		}
 
+		/// <summary>
+		/// Maps that were never decoded are written back out as they were loaded. Ones that can't be
+		/// tiled, because they're missing or not square, fall back to a single deflated string.
+		/// </summary>
+		static void WriteMap<T>( Utf8JsonWriter writer, string name, T[] map, TerrainTiles tiles ) where T : unmanaged
+		{
+			tiles ??= TerrainTiles.Encode( map );
+
+			if ( tiles is null )
+			{
+				writer.WriteBase64String( name, Compress( map.AsSpan() ) );
+				return;
+			}
+
+			tiles.JsonWrite( writer, name );
+		}
+
 		internal static Span<T> Decompress<T>( byte[] compressedData ) where T : unmanaged
 		{
 			using var compressedStream = new MemoryStream( compressedData );
@@ -20,6 +20,8 @@ public abstract partial class Component
 
 		_dirty = true;
 
+		MarkPreRenderDirty();
+
 		using ( CallbackBatch.Batch() )
 		{
 			CallbackBatch.Add( CommonCallback.Dirty, OnDirtyInternal, this, "OnDirty" );
@@ -42,6 +44,42 @@ public abstract partial class Component
 	{
 
 	}
+
+	GameTransform _preRenderTransform;
+
+	/// <summary>
+	/// Make sure <see cref="OnPreRender"/> is called before the next frame is rendered. This only matters for
+	/// components that are <see cref="PreRenderOnlyWhenDirty"/>, everything else is pre-rendered every frame anyway.
+	/// </summary>
+	protected void MarkPreRenderDirty()
+	{
+		if ( this is not PreRenderOnlyWhenDirty ) return;
+
+		Scene?.MarkPreRenderDirty( this );
+	}
+
+	/// <summary>
+	/// Start listening for transform changes, for <see cref="PreRenderOnlyWhenDirty"/> components that are in the scene.
+	/// </summary>
+	internal void StartPreRenderTracking()
+	{
+		StopPreRenderTracking();
+
+		_preRenderTransform = Transform;
+		if ( _preRenderTransform is null ) return;
+
+		_preRenderTransform.OnTransformChangedInternal += OnPreRenderTransformChanged;
+	}
+
+	internal void StopPreRenderTracking()
+	{
+		if ( _preRenderTransform is null ) return;
+
+		_preRenderTransform.OnTransformChangedInternal -= OnPreRenderTransformChanged;
+		_preRenderTransform = null;
+	}
+
+	void OnPreRenderTransformChanged( GameTransform root ) => MarkPreRenderDirty();
 }
 
 
@@ -0,0 +1,16 @@
+﻿namespace Sandbox;
+
+public partial class Component
+{
+	/// <summary>
+	/// A component with this interface only has <see cref="OnPreRender"/> called after it has changed, instead of
+	/// every frame. It's changed when it's enabled, its transform moves, a <see cref="MakeDirtyAttribute"/> property
+	/// is set or <see cref="MarkPreRenderDirty"/> is called. Only use it for components that push their state into
+	/// something that keeps it, like a scene object. State the scene resets every tick, like
+	/// <see cref="SceneWorld.GradientFog"/>, still has to be set every frame.
+	/// </summary>
+	public interface PreRenderOnlyWhenDirty
+	{
+
+	}
+}
@@ -210,22 +210,35 @@ public sealed class NavMeshAgent : Component
 	public NavMeshPath GetPath()
 	{
 		NavMeshPath result = new();
+		GetPath( ref result );
+		return result;
+	}
+
+	/// <summary>
+	/// The same as <see cref="GetPath()"/>, but written into <paramref name="result"/>, reusing the lists it already has.
+	/// </summary>
+	public void GetPath( ref NavMeshPath result )
+	{
+		var points = result.Points as List<NavMeshPathPoint>;
+		points?.Clear();
+		result.Polygons?.Clear();
 
 		if ( agentInternal == null ||
 			agentInternal.corridor == null ||
 			agentInternal.targetState != DtMoveRequestState.DT_CROWDAGENT_TARGET_VALID )
 		{
 			result.Status = NavMeshPathStatus.PathNotFound;
-			return result;
+			return;
 		}
 
 		// Get the polygon path from the agent's corridor
-		result.Polygons = [.. agentInternal.corridor.GetPath()];
+		result.Polygons ??= new List<long>();
+		result.Polygons.AddRange( agentInternal.corridor.GetPath() );
 
 		if ( result.Polygons.Count == 0 )
 		{
 			result.Status = NavMeshPathStatus.PathNotFound;
-			return result;
+			return;
 		}
 
 		// Get start and end positions
@@ -248,11 +261,11 @@ public sealed class NavMeshAgent : Component
 		{
 			ArrayPool<DtStraightPath>.Shared.Return( straightPathCache );
 			result.Status = NavMeshPathStatus.PathNotFound;
-			return result;
+			return;
 		}
 
 		// Convert the straight path points to NavMeshPathPoints
-		var points = new List<NavMeshPathPoint>( filledPointCount );
+		points ??= new List<NavMeshPathPoint>( filledPointCount );
 		for ( int i = 0; i < filledPointCount; i++ )
 		{
 			points.Add( new NavMeshPathPoint { Position = NavMesh.FromNav( straightPathCache[i].pos ) } );
@@ -269,8 +282,6 @@ public sealed class NavMeshAgent : Component
 		{
 			result.Status = NavMeshPathStatus.Complete;
 		}
-
-		return result;
 	}
 
 	/// <summary>
@@ -143,43 +143,75 @@ public partial class Particle : IDynamicFloatContext
 
 	public bool MoveWithCollision( in float bounce, in float friction, in float bumpiness, in float push, in bool die, in float dt, float radius, in SceneTrace trace )
 	{
-		const float surfaceOffset = 0.1f;
-
 		// We previously hit something.
 		// Keep the surface normal out of our velocity
 		// Periodically check whether it's still there.
-		if ( HitTime > 0 )
+		if ( NeedsSurfaceCheck() )
 		{
-			// if time passed, or we moved too far, see if it's still there
-			bool recheck = HitTime < Time.Now - 0.1f || HitPos.Distance( Position ) > 16;
-
-			if ( recheck )
-			{
-				var checkTrace = trace.Ray( Position, Position + HitNormal * surfaceOffset * -2.0f )
-								.Radius( radius * Radius )
-								.Run();
-
-				if ( checkTrace.Hit )
-				{
-					HitPos = checkTrace.HitPosition;
-					HitNormal = checkTrace.Normal;
-					HitTime = Time.Now;
-				}
-				else
-				{
-					HitTime = 0;
-					HitPos = 0;
-					HitNormal = 0;
-				}
-			}
-
-			if ( HitTime > 0 )
-			{
-				LastHitTime = Time.Now;
-				// Keep removing the ground velocity
-				Velocity = Velocity.SubtractDirection( HitNormal );
-			}
+			var check = GetSurfaceCheck( radius );
+			UpdateSurface( trace.Ray( check.From, check.To ).Radius( check.Radius ).Run() );
+		}
+
+		var targetPosition = BeginMove( friction, dt );
+
+		var tr = trace.Ray( Position, targetPosition )
+										.Radius( radius * Radius )
+										.Run();
+
+		return EndMove( tr, targetPosition, bounce, bumpiness, push, die );
+	}
+
+	const float SurfaceOffset = 0.1f;
+
+	/// <summary>
+	/// If we're resting on a surface, whether enough time has passed or we've moved far enough that we
+	/// should check it's still there.
+	/// </summary>
+	internal bool NeedsSurfaceCheck()
+	{
+		if ( HitTime <= 0 )
+			return false;
+
+		return HitTime < Time.Now - 0.1f || HitPos.Distance( Position ) > 16;
+	}
+
+	/// <summary>
+	/// The trace that checks whether the surface we're resting on is still there.
+	/// </summary>
+	internal TraceSweep GetSurfaceCheck( float radius )
+	{
+		return new TraceSweep( Position, Position + HitNormal * SurfaceOffset * -2.0f, radius * Radius );
+	}
 
+	/// <summary>
+	/// Keep or forget the surface we're resting on, depending on the result of <see cref="GetSurfaceCheck"/>.
+	/// </summary>
+	internal void UpdateSurface( in SceneTraceResult checkTrace )
+	{
+		if ( checkTrace.Hit )
+		{
+			HitPos = checkTrace.HitPosition;
+			HitNormal = checkTrace.Normal;
+			HitTime = Time.Now;
+		}
+		else
+		{
+			HitTime = 0;
+			HitPos = 0;
+			HitNormal = 0;
+		}
+	}
+
+	/// <summary>
+	/// Apply surface friction and work out where we want to move to this step.
+	/// </summary>
+	internal Vector3 BeginMove( float friction, float dt )
+	{
+		if ( HitTime > 0 )
+		{
+			LastHitTime = Time.Now;
+			// Keep removing the ground velocity
+			Velocity = Velocity.SubtractDirection( HitNormal );
 		}
 
 		if ( LastHitTime > Time.Now - 0.03f )
@@ -187,11 +219,14 @@ public partial class Particle : IDynamicFloatContext
 			ApplyDamping( friction * dt * 5.0f );
 		}
 
-		var targetPosition = Position + Velocity * dt;
+		return Position + Velocity * dt;
+	}
 
-		var tr = trace.Ray( Position, targetPosition )
-										.Radius( radius * Radius )
-										.Run();
+	/// <summary>
+	/// Move to the target position, or respond to whatever the sweep there hit. Returns true if we hit something.
+	/// </summary>
+	internal bool EndMove( in SceneTraceResult tr, Vector3 targetPosition, float bounce, float bumpiness, float push, bool die )
+	{
 		if ( !tr.Hit )
 		{
 			Position = targetPosition;
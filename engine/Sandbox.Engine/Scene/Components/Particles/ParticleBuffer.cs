@@ -0,0 +1,308 @@
+﻿using System.Numerics;
+using System.Runtime.CompilerServices;
+
+namespace Sandbox;
+
+/// <summary>
+/// A structure of arrays copy of a chunk of particles. The simulation stages that are the same for
+/// every particle (damping, forces, integration) are run over these contiguous arrays with SIMD, then
+/// the results are written back to the <see cref="Particle"/>s, which stay the public view of the data.
+/// </summary>
+internal sealed class ParticleBuffer
+{
+	public int Count { get; private set; }
+
+	public float[] PositionX = [];
+	public float[] PositionY = [];
+	public float[] PositionZ = [];
+
+	public float[] VelocityX = [];
+	public float[] VelocityY = [];
+	public float[] VelocityZ = [];
+
+	/// <summary>
+	/// Velocity added after damping, on top of <see cref="ForceDirection"/>, like orbital forces.
+	/// </summary>
+	public float[] AddVelocityX = [];
+	public float[] AddVelocityY = [];
+	public float[] AddVelocityZ = [];
+
+	/// <summary>
+	/// How much simulation time passes for each particle this step.
+	/// </summary>
+	public float[] TimeScale = [];
+
+	/// <summary>
+	/// Damping amount for each particle, already scaled by time.
+	/// </summary>
+	public float[] Damping = [];
+
+	/// <summary>
+	/// How much of <see cref="ForceDirection"/> to apply to each particle, already scaled by time.
+	/// </summary>
+	public float[] ForceScale = [];
+
+	/// <summary>
+	/// Life delta of each particle, or negative if it isn't being simulated this step.
+	/// </summary>
+	public float[] Delta = [];
+
+	/// <summary>
+	/// Per particle random values used to evaluate <see cref="Damping"/> and <see cref="ForceScale"/>.
+	/// </summary>
+	public float[] DampingRandom = [];
+	public float[] ForceScaleRandom = [];
+
+	/// <summary>
+	/// The force applied to every particle, scaled by <see cref="ForceScale"/>.
+	/// </summary>
+	public Vector3 ForceDirection;
+
+	/// <summary>
+	/// Matches the stop speed used by <see cref="Particle.ApplyDamping"/>.
+	/// </summary>
+	const float DampingStopSpeed = 100.0f;
+
+	/// <summary>
+	/// Make room for this many particles. Anything previously in the buffer is undefined.
+	/// </summary>
+	public void Reset( int count )
+	{
+		Count = count;
+		ForceDirection = Vector3.Zero;
+
+		if ( PositionX.Length >= count )
+			return;
+
+		var capacity = (int)BitOperations.RoundUpToPowerOf2( (uint)Math.Max( count, 64 ) );
+
+		PositionX = new float[capacity];
+		PositionY = new float[capacity];
+		PositionZ = new float[capacity];
+		VelocityX = new float[capacity];
+		VelocityY = new float[capacity];
+		VelocityZ = new float[capacity];
+		AddVelocityX = new float[capacity];
+		AddVelocityY = new float[capacity];
+		AddVelocityZ = new float[capacity];
+		TimeScale = new float[capacity];
+		Damping = new float[capacity];
+		ForceScale = new float[capacity];
+		Delta = new float[capacity];
+		DampingRandom = new float[capacity];
+		ForceScaleRandom = new float[capacity];
+	}
+
+	/// <summary>
+	/// Copy a particle's position and velocity into the buffer. The per particle amounts of
+	/// time, damping and force are filled in separately.
+	/// </summary>
+	public void Read( int index, Particle p, in Vector3 addVelocity )
+	{
+		PositionX[index] = p.Position.x;
+		PositionY[index] = p.Position.y;
+		PositionZ[index] = p.Position.z;
+
+		VelocityX[index] = p.Velocity.x;
+		VelocityY[index] = p.Velocity.y;
+		VelocityZ[index] = p.Velocity.z;
+
+		AddVelocityX[index] = addVelocity.x;
+		AddVelocityY[index] = addVelocity.y;
+		AddVelocityZ[index] = addVelocity.z;
+	}
+
+	/// <summary>
+	/// Mark a particle as not being simulated this step. The SIMD stages still run over it,
+	/// but with nothing to apply, and it won't be written back.
+	/// </summary>
+	public void Skip( int index )
+	{
+		PositionX[index] = PositionY[index] = PositionZ[index] = 0.0f;
+		VelocityX[index] = VelocityY[index] = VelocityZ[index] = 0.0f;
+		AddVelocityX[index] = AddVelocityY[index] = AddVelocityZ[index] = 0.0f;
+
+		Delta[index] = -1.0f;
+		TimeScale[index] = 0.0f;
+		DampingRandom[index] = 0.0f;
+		ForceScaleRandom[index] = 0.0f;
+	}
+
+	/// <summary>
+	/// Copy the simulated position and velocity back to the particle.
+	/// </summary>
+	public void Write( int index, Particle p )
+	{
+		p.Position = new Vector3( PositionX[index], PositionY[index], PositionZ[index] );
+		p.Velocity = new Vector3( VelocityX[index], VelocityY[index], VelocityZ[index] );
+	}
+
+	/// <summary>
+	/// Damp, apply forces and integrate every particle in the buffer. Collision integrates
+	/// the particles itself, so it can skip the last stage with <paramref name="integrate"/>.
+	/// </summary>
+	public void Simulate( bool integrate = true )
+	{
+		var count = Count;
+
+		var vx = VelocityX.AsSpan( 0, count );
+		var vy = VelocityY.AsSpan( 0, count );
+		var vz = VelocityZ.AsSpan( 0, count );
+
+		Damp( vx, vy, vz, Damping.AsSpan( 0, count ) );
+
+		if ( !ForceDirection.IsNearlyZero() )
+		{
+			var scale = ForceScale.AsSpan( 0, count );
+
+			MultiplyAdd( vx, scale, ForceDirection.x );
+			MultiplyAdd( vy, scale, ForceDirection.y );
+			MultiplyAdd( vz, scale, ForceDirection.z );
+		}
+
+		Add( vx, AddVelocityX.AsSpan( 0, count ) );
+		Add( vy, AddVelocityY.AsSpan( 0, count ) );
+		Add( vz, AddVelocityZ.AsSpan( 0, count ) );
+
+		if ( !integrate )
+			return;
+
+		var dt = TimeScale.AsSpan( 0, count );
+
+		MultiplyAdd( PositionX.AsSpan( 0, count ), vx, dt );
+		MultiplyAdd( PositionY.AsSpan( 0, count ), vy, dt );
+		MultiplyAdd( PositionZ.AsSpan( 0, count ), vz, dt );
+	}
+
+	/// <summary>
+	/// The same as <see cref="Vector3.WithFriction"/> for each velocity.
+	/// </summary>
+	public static void Damp( Span<float> x, Span<float> y, Span<float> z, ReadOnlySpan<float> amount )
+	{
+		int i = 0;
+
+		if ( Vector.IsHardwareAccelerated )
+		{
+			var stopSpeed = new Vector<float>( DampingStopSpeed );
+			var minSpeed = new Vector<float>( 0.01f );
+
+			for ( ; i <= x.Length - Vector<float>.Count; i += Vector<float>.Count )
+			{
+				var vx = new Vector<float>( x[i..] );
+				var vy = new Vector<float>( y[i..] );
+				var vz = new Vector<float>( z[i..] );
+
+				var speed = Vector.SquareRoot( vx * vx + vy * vy + vz * vz );
+				var control = Vector.Max( speed, stopSpeed );
+				var newSpeed = Vector.Max( speed - control * new Vector<float>( amount[i..] ), Vector<float>.Zero );
+
+				// Too slow to bother, leave it alone rather than dividing by nothing
+				var scale = Vector.ConditionalSelect( Vector.LessThan( speed, minSpeed ), Vector<float>.One, newSpeed / speed );
+
+				(vx * scale).CopyTo( x[i..] );
+				(vy * scale).CopyTo( y[i..] );
+				(vz * scale).CopyTo( z[i..] );
+			}
+		}
+
+		for ( ; i < x.Length; i++ )
+		{
+			var speed = MathF.Sqrt( x[i] * x[i] + y[i] * y[i] + z[i] * z[i] );
+			if ( speed < 0.01f ) continue;
+
+			var control = MathF.Max( speed, DampingStopSpeed );
+			var scale = MathF.Max( speed - control * amount[i], 0.0f ) / speed;
+
+			x[i] *= scale;
+			y[i] *= scale;
+			z[i] *= scale;
+		}
+	}
+
+	/// <summary>
+	/// <c>target[i] += source[i]</c>
+	/// </summary>
+	public static void Add( Span<float> target, ReadOnlySpan<float> source )
+	{
+		int i = 0;
+
+		if ( Vector.IsHardwareAccelerated )
+		{
+			for ( ; i <= target.Length - Vector<float>.Count; i += Vector<float>.Count )
+			{
+				(new Vector<float>( target[i..] ) + new Vector<float>( source[i..] )).CopyTo( target[i..] );
+			}
+		}
+
+		for ( ; i < target.Length; i++ )
+		{
+			target[i] += source[i];
+		}
+	}
+
+	/// <summary>
+	/// <c>target[i] *= scale[i]</c>
+	/// </summary>
+	public static void Multiply( Span<float> target, ReadOnlySpan<float> scale )
+	{
+		int i = 0;
+
+		if ( Vector.IsHardwareAccelerated )
+		{
+			for ( ; i <= target.Length - Vector<float>.Count; i += Vector<float>.Count )
+			{
+				(new Vector<float>( target[i..] ) * new Vector<float>( scale[i..] )).CopyTo( target[i..] );
+			}
+		}
+
+		for ( ; i < target.Length; i++ )
+		{
+			target[i] *= scale[i];
+		}
+	}
+
+	/// <summary>
+	/// <c>target[i] += scale[i] * value</c>
+	/// </summary>
+	public static void MultiplyAdd( Span<float> target, ReadOnlySpan<float> scale, float value )
+	{
+		int i = 0;
+
+		if ( Vector.IsHardwareAccelerated )
+		{
+			var v = new Vector<float>( value );
+
+			for ( ; i <= target.Length - Vector<float>.Count; i += Vector<float>.Count )
+			{
+				(new Vector<float>( target[i..] ) + new Vector<float>( scale[i..] ) * v).CopyTo( target[i..] );
+			}
+		}
+
+		for ( ; i < target.Length; i++ )
+		{
+			target[i] += scale[i] * value;
+		}
+	}
+
+	/// <summary>
+	/// <c>target[i] += source[i] * scale[i]</c>
+	/// </summary>
+	[MethodImpl( MethodImplOptions.AggressiveInlining )]
+	public static void MultiplyAdd( Span<float> target, ReadOnlySpan<float> source, ReadOnlySpan<float> scale )
+	{
+		int i = 0;
+
+		if ( Vector.IsHardwareAccelerated )
+		{
+			for ( ; i <= target.Length - Vector<float>.Count; i += Vector<float>.Count )
+			{
+				(new Vector<float>( target[i..] ) + new Vector<float>( source[i..] ) * new Vector<float>( scale[i..] )).CopyTo( target[i..] );
+			}
+		}
+
+		for ( ; i < target.Length; i++ )
+		{
+			target[i] += source[i] * scale[i];
+		}
+	}
+}
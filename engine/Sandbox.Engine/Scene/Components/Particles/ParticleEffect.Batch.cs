@@ -0,0 +1,217 @@
+﻿namespace Sandbox;
+
+public sealed partial class ParticleEffect
+{
+	[ThreadStatic]
+	static ParticleBuffer _threadBuffer;
+
+	[ThreadStatic]
+	static CollisionBuffer _threadCollisionBuffer;
+
+	/// <summary>
+	/// Update a range of particles. Movement is simulated for the whole range at once in a
+	/// <see cref="ParticleBuffer"/>, and collision traces for the range are run as one batch.
+	/// Everything else is still done per particle.
+	/// </summary>
+	internal void UpdateParticles( int startIndex, int endIndex )
+	{
+		// OnStep needs to see each particle in between the movement stages
+		if ( OnStep is not null )
+		{
+			for ( int i = startIndex; i < endIndex; i++ )
+			{
+				UpdateParticle( i );
+			}
+
+			return;
+		}
+
+		var buffer = _threadBuffer ??= new ParticleBuffer();
+		buffer.Reset( endIndex - startIndex );
+
+		if ( Force && !ForceDirection.IsNearlyZero() )
+		{
+			buffer.ForceDirection = ForceSpace == SimulationSpace.Local ? _worldForce : ForceDirection;
+		}
+
+		var count = buffer.Count;
+
+		for ( int i = 0; i < count; i++ )
+		{
+			var p = Particles[startIndex + i];
+
+			if ( !BeginParticleUpdate( p, out var delta, out var timeScale ) )
+			{
+				buffer.Skip( i );
+				continue;
+			}
+
+			buffer.Delta[i] = delta;
+			buffer.TimeScale[i] = timeScale;
+			buffer.DampingRandom[i] = GetDampingRandom( p );
+			buffer.ForceScaleRandom[i] = GetForceScaleRandom( p );
+		}
+
+		var deltas = buffer.Delta.AsSpan( 0, count );
+		var timeScales = buffer.TimeScale.AsSpan( 0, count );
+		var damping = buffer.Damping.AsSpan( 0, count );
+		var forceScale = buffer.ForceScale.AsSpan( 0, count );
+
+		_damping.Evaluate( deltas, buffer.DampingRandom.AsSpan( 0, count ), damping );
+
+		if ( Force )
+		{
+			_forceScale.Evaluate( deltas, buffer.ForceScaleRandom.AsSpan( 0, count ), forceScale );
+		}
+		else
+		{
+			forceScale.Clear();
+		}
+
+		for ( int i = 0; i < count; i++ )
+		{
+			var delta = deltas[i];
+			if ( delta < 0 ) continue;
+
+			var p = Particles[startIndex + i];
+
+			// Orbital forces depend on position, which damping doesn't change, so work them out now
+			var addVelocity = forceScale[i] != 0.0f ? GetOrbitalVelocity( p, delta, forceScale[i], timeScales[i] ) : Vector3.Zero;
+
+			ApplyConstantMovement( p );
+
+			buffer.Read( i, p, addVelocity );
+		}
+
+		ParticleBuffer.Multiply( damping, timeScales );
+		ParticleBuffer.Multiply( forceScale, timeScales );
+
+		buffer.Simulate( !Collision );
+
+		if ( Collision )
+		{
+			for ( int i = 0; i < count; i++ )
+			{
+				if ( deltas[i] < 0 ) continue;
+
+				buffer.Write( i, Particles[startIndex + i] );
+			}
+
+			MoveWithCollisions( startIndex, deltas, timeScales );
+		}
+
+		for ( int i = 0; i < count; i++ )
+		{
+			var delta = deltas[i];
+			if ( delta < 0 ) continue;
+
+			var p = Particles[startIndex + i];
+
+			if ( !Collision )
+			{
+				buffer.Write( i, p );
+			}
+
+			EndParticleUpdate( p, delta, timeScales[i] );
+		}
+	}
+
+	/// <summary>
+	/// The same as <see cref="Particle.MoveWithCollision"/> for a range of particles, but with the surface
+	/// checks and the movement sweeps each run as a single <see cref="SceneTrace.RunBatch"/>.
+	/// </summary>
+	void MoveWithCollisions( int startIndex, ReadOnlySpan<float> deltas, ReadOnlySpan<float> timeScales )
+	{
+		var count = deltas.Length;
+		var cb = _threadCollisionBuffer ??= new CollisionBuffer();
+		cb.Reset( count );
+
+		var now = Time.Now;
+		int sweepCount = 0;
+
+		for ( int i = 0; i < count; i++ )
+		{
+			if ( deltas[i] < 0 ) continue;
+
+			var p = Particles[startIndex + i];
+
+			cb.Settings[i] = GetCollisionSettings( p );
+			cb.TimeSinceHit[i] = now - p.HitTime;
+
+			if ( !p.NeedsSurfaceCheck() )
+				continue;
+
+			cb.Indices[sweepCount] = i;
+			cb.Sweeps[sweepCount++] = p.GetSurfaceCheck( cb.Settings[i].Radius );
+		}
+
+		if ( sweepCount > 0 )
+		{
+			_trace.RunBatch( cb.Sweeps.AsSpan( 0, sweepCount ), cb.Results.AsSpan( 0, sweepCount ) );
+
+			for ( int j = 0; j < sweepCount; j++ )
+			{
+				Particles[startIndex + cb.Indices[j]].UpdateSurface( cb.Results[j] );
+			}
+		}
+
+		sweepCount = 0;
+
+		for ( int i = 0; i < count; i++ )
+		{
+			if ( deltas[i] < 0 ) continue;
+
+			var p = Particles[startIndex + i];
+			var targetPosition = p.BeginMove( cb.Settings[i].Friction, timeScales[i] );
+
+			cb.Indices[sweepCount] = i;
+			cb.Sweeps[sweepCount++] = new TraceSweep( p.Position, targetPosition, cb.Settings[i].Radius * p.Radius );
+		}
+
+		if ( sweepCount == 0 )
+			return;
+
+		_trace.RunBatch( cb.Sweeps.AsSpan( 0, sweepCount ), cb.Results.AsSpan( 0, sweepCount ) );
+
+		for ( int j = 0; j < sweepCount; j++ )
+		{
+			var i = cb.Indices[j];
+			var p = Particles[startIndex + i];
+			ref readonly var c = ref cb.Settings[i];
+
+			if ( p.EndMove( cb.Results[j], cb.Sweeps[j].To, c.Bounce, c.Bumpiness, c.Push, c.Die ) )
+			{
+				OnParticleCollided( p, deltas[i], cb.TimeSinceHit[i] );
+			}
+		}
+
+		// Don't keep hold of whatever we hit
+		cb.Results.AsSpan( 0, sweepCount ).Clear();
+	}
+
+	/// <summary>
+	/// Per thread working space for <see cref="MoveWithCollisions"/>.
+	/// </summary>
+	sealed class CollisionBuffer
+	{
+		public CollisionSettings[] Settings = [];
+		public float[] TimeSinceHit = [];
+		public int[] Indices = [];
+		public TraceSweep[] Sweeps = [];
+		public SceneTraceResult[] Results = [];
+
+		public void Reset( int count )
+		{
+			if ( Settings.Length >= count )
+				return;
+
+			var capacity = (int)System.Numerics.BitOperations.RoundUpToPowerOf2( (uint)Math.Max( count, 64 ) );
+
+			Settings = new CollisionSettings[capacity];
+			TimeSinceHit = new float[capacity];
+			Indices = new int[capacity];
+			Sweeps = new TraceSweep[capacity];
+			Results = new SceneTraceResult[capacity];
+		}
+	}
+}
@@ -478,6 +478,62 @@ public sealed partial class ParticleEffect : Component, Component.ExecuteInEdito
 		Components.ExecuteEnabledInSelfAndDescendants<ParticleEmitter>( e => e.ResetEmitter() );
 	}
 
+	// Baked copies of the properties we evaluate for every particle, every step.
+	// Each per-particle random is seeded by a number and the line it's evaluated on. The lines are passed in
+	// explicitly, pinned to where these calls used to be, so moving the code around doesn't change how every
+	// existing effect looks.
+	readonly ParticleFloatTable _lifetime = new();
+	readonly ParticleFloatTable _perParticleTimeScale = new();
+	readonly ParticleFloatTable _damping = new();
+	readonly ParticleFloatTable _forceScale = new();
+	readonly ParticleFloatTable _localSpace = new();
+	readonly ParticleFloatTable _orbitalPull = new();
+	readonly ParticleFloatTable _bounce = new();
+	readonly ParticleFloatTable _friction = new();
+	readonly ParticleFloatTable _bumpiness = new();
+	readonly ParticleFloatTable _pushStrength = new();
+	readonly ParticleFloatTable _dieOnCollisionChance = new();
+	readonly ParticleFloatTable _brightness = new();
+	readonly ParticleGradientTable _gradient = new();
+	readonly ParticleFloatTable _alpha = new();
+	readonly ParticleFloatTable _scale = new();
+	readonly ParticleFloatTable _stretch = new();
+	readonly ParticleFloatTable _pitch = new();
+	readonly ParticleFloatTable _yaw = new();
+	readonly ParticleFloatTable _roll = new();
+	readonly ParticleFloatTable _sequenceId = new();
+	readonly ParticleFloatTable _sequenceTime = new();
+	readonly ParticleFloatTable _sequenceSpeed = new();
+
+	/// <summary>
+	/// Rebake any of the per-particle properties that have changed since the last step.
+	/// </summary>
+	void UpdateTables()
+	{
+		_lifetime.Update( Lifetime );
+		_perParticleTimeScale.Update( PerParticleTimeScale );
+		_damping.Update( Damping );
+		_forceScale.Update( ForceScale );
+		_localSpace.Update( LocalSpace );
+		_orbitalPull.Update( OrbitalPull );
+		_bounce.Update( Bounce );
+		_friction.Update( Friction );
+		_bumpiness.Update( Bumpiness );
+		_pushStrength.Update( PushStrength );
+		_dieOnCollisionChance.Update( DieOnCollisionChance );
+		_brightness.Update( Brightness );
+		_gradient.Update( Gradient );
+		_alpha.Update( Alpha );
+		_scale.Update( Scale );
+		_stretch.Update( Stretch );
+		_pitch.Update( Pitch );
+		_yaw.Update( Yaw );
+		_roll.Update( Roll );
+		_sequenceId.Update( SequenceId );
+		_sequenceTime.Update( SequenceTime );
+		_sequenceSpeed.Update( SequenceSpeed );
+	}
+
 	long _maxDistance;
 	long _maxSize;
 	float _timeDelta;
@@ -490,33 +546,11 @@ public sealed partial class ParticleEffect : Component, Component.ExecuteInEdito
 	{
 		var p = Particles[index];
 
-		// keep updating deathtime, incase we're in the editor and they're changing shit
-		p.DeathTime = p.BornTime + Lifetime.Evaluate( p.Rand( 155, 100 ), p.Rand( 145, 100 ) );
-
-		float delta = MathX.Remap( p.BornTime + p.Age, p.BornTime, p.DeathTime );
-		p.LifeDelta = delta;
-
-		var timeScale = PerParticleTimeScale.Evaluate( p, 3355 ) * _timeDelta * p.TimeScale;
-		var frame = p.Frame;
-
-		p.Age += timeScale;
-		p.Frame++;
-
-		// delay - not spawned yet (BornTime is in the future)
-		if ( p.LifeDelta < 0 )
+		if ( !BeginParticleUpdate( p, out var delta, out var timeScale ) )
 			return;
 
-		var damping = Damping.Evaluate( p, 8234 );
-		var forceScale = ForceScale.Evaluate( p, 7723 );
-		var localSpace = LocalSpace.Evaluate( p, 254 ).Clamp( 0, 1 );
-
-		if ( _parentMoved && frame > 0 && localSpace > 0.001f )
-		{
-			var localPos = lastTransform.PointToLocal( p.Position );
-			var worldPos = _worldTx.PointToWorld( localPos );
-
-			p.Position = p.Position.LerpTo( worldPos, localSpace );
-		}
+		var damping = _damping.Evaluate( delta, GetDampingRandom( p ) );
+		var forceScale = _forceScale.Evaluate( delta, GetForceScaleRandom( p ) );
 
 		p.ApplyDamping( damping * timeScale );
 
@@ -529,90 +563,191 @@ public sealed partial class ParticleEffect : Component, Component.ExecuteInEdito
 				p.Velocity += forceScale * (ForceSpace == SimulationSpace.Local ? _worldForce : ForceDirection) * timeScale;
 			}
 
-			if ( !OrbitalForce.IsNearlyZero() )
-			{
-				var force = OrbitalForce.Evaluate( delta, p.Rand( 8363 ), p.Rand( 5216 ), p.Rand( 2323 ) );
-				var localOffset = (_worldTx.Position - p.Position).Normal;
-				var rotatedOffset = localOffset.RotateAround( 0, new Angles( force ) );
-				var rotDelta = localOffset - rotatedOffset;
+			p.Velocity += GetOrbitalVelocity( p, delta, forceScale, timeScale );
+		}
 
-				p.Velocity += forceScale * rotDelta * timeScale;
-			}
+		ApplyConstantMovement( p );
 
-			if ( !OrbitalPull.IsNearlyZero() )
+		if ( Collision )
+		{
+			var c = GetCollisionSettings( p );
+			var hitTime = Time.Now - p.HitTime;
+
+			var collided = p.MoveWithCollision( c.Bounce, c.Friction, c.Bumpiness, c.Push, c.Die, timeScale, c.Radius, _trace );
+
+			if ( collided )
 			{
-				var localOffset = (_worldTx.Position - p.Position) / 100.0f;
-				p.Velocity += forceScale * localOffset * timeScale * OrbitalPull.Evaluate( delta, p.Rand( 4333 ) );
+				OnParticleCollided( p, delta, hitTime );
 			}
 		}
-
-		// Apply constant movement
-		if ( !ConstantMovement.IsNearlyZero() )
+		else
 		{
-			p.Position += ConstantMovement.Evaluate( p, 4395 ) * _timeDelta;
+			p.Position += p.Velocity * timeScale;
 		}
 
-		if ( Collision )
+		EndParticleUpdate( p, delta, timeScale );
+	}
+
+	/// <summary>
+	/// How a particle responds to collisions, evaluated once per step.
+	/// </summary>
+	struct CollisionSettings
+	{
+		public float Bounce;
+		public float Friction;
+		public float Bumpiness;
+		public float Push;
+		public bool Die;
+		public float Radius;
+	}
+
+	CollisionSettings GetCollisionSettings( Particle p )
+	{
+		var c = new CollisionSettings
 		{
-			var bounce = Bounce.Evaluate( p, 3478 );
-			var friction = Friction.Evaluate( p, 7579 );
-			var bumpiness = Bumpiness.Evaluate( p, 2380 );
-			var push = PushStrength.Evaluate( p, 5281 );
-			var die = DieOnCollisionChance.Evaluate( p, 4582 ) > 0.5f;
-			var radius = MathF.Max( 0.01f, CollisionRadius );
+			Bounce = _bounce.Evaluate( p, 3478, 557 ),
+			Friction = _friction.Evaluate( p, 7579, 558 ),
+			Bumpiness = _bumpiness.Evaluate( p, 2380, 559 ),
+			Push = _pushStrength.Evaluate( p, 5281, 560 ),
+			Die = _dieOnCollisionChance.Evaluate( p, 4582, 561 ) > 0.5f,
+			Radius = MathF.Max( 0.01f, CollisionRadius )
+		};
 
-			if ( Scene.IsEditor ) push = 0;
+		if ( Scene.IsEditor ) c.Push = 0;
 
-			var hitTime = Time.Now - p.HitTime;
+		return c;
+	}
 
-			var collided = p.MoveWithCollision( bounce, friction, bumpiness, push, die, timeScale, radius, _trace );
+	/// <summary>
+	/// The particle just hit something, maybe spawn a collision prefab. <paramref name="hitTime"/> is how long
+	/// it had been since it last hit something.
+	/// </summary>
+	void OnParticleCollided( Particle p, float delta, float hitTime )
+	{
+		if ( hitTime <= 0.3f || !UsePrefabFeature )
+			return;
 
-			if ( collided && hitTime > 0.3f && UsePrefabFeature && CollisionPrefabChance.Evaluate( delta, Random.Shared.Float( 0, 1 ) ) > Random.Shared.Float( 0, 1 ) )
-			{
-				var prefabSource = Random.Shared.FromList( CollisionPrefab );
-				if ( prefabSource is not null )
-				{
-					Rotation angle = p.Angles;
-					Vector3 position = p.Position;
+		if ( CollisionPrefabChance.Evaluate( delta, Random.Shared.Float( 0, 1 ) ) <= Random.Shared.Float( 0, 1 ) )
+			return;
 
-					if ( CollisionPrefabAlign )
-					{
-						angle = Rotation.LookAt( p.HitNormal, p.Angles.Forward );
+		var prefabSource = Random.Shared.FromList( CollisionPrefab );
+		if ( prefabSource is null )
+			return;
 
-						var rot = CollisionPrefabRotation.Evaluate( delta, Random.Shared.Float( 0, 1 ) );
-						angle = Rotation.FromYaw( rot ) * angle;
+		Rotation angle = p.Angles;
+		Vector3 position = p.Position;
 
-						position = p.HitPos;
-					}
+		if ( CollisionPrefabAlign )
+		{
+			angle = Rotation.LookAt( p.HitNormal, p.Angles.Forward );
 
-					// Queue the collision prefabs to spawn on the main thread
-					ParticleCollisionPrefabs.Add( new( prefabSource, position, angle ) );
-				}
-			}
+			var rot = CollisionPrefabRotation.Evaluate( delta, Random.Shared.Float( 0, 1 ) );
+			angle = Rotation.FromYaw( rot ) * angle;
+
+			position = p.HitPos;
 		}
-		else
+
+		// Queue the collision prefabs to spawn on the main thread
+		ParticleCollisionPrefabs.Add( new( prefabSource, position, angle ) );
+	}
+
+	/// <summary>
+	/// Advance the particle's age and lifetime, and move it with the emitter if it's in local space.
+	/// Returns false if the particle is delayed and shouldn't be simulated yet.
+	/// </summary>
+	bool BeginParticleUpdate( Particle p, out float delta, out float timeScale )
+	{
+
+		// keep updating deathtime, incase we're in the editor and they're changing shit
+		p.DeathTime = p.BornTime + _lifetime.Evaluate( p.Rand( 155, 100 ), p.Rand( 145, 100 ) );
+
+		delta = MathX.Remap( p.BornTime + p.Age, p.BornTime, p.DeathTime );
+		p.LifeDelta = delta;
+
+		timeScale = _perParticleTimeScale.Evaluate( p, 3355, 499 ) * _timeDelta * p.TimeScale;
+		var frame = p.Frame;
+
+		p.Age += timeScale;
+		p.Frame++;
+
+		// delay - not spawned yet (BornTime is in the future)
+		if ( p.LifeDelta < 0 )
+			return false;
+
+		var localSpace = _localSpace.Evaluate( p, 254, 511 ).Clamp( 0, 1 );
+
+		if ( _parentMoved && frame > 0 && localSpace > 0.001f )
 		{
-			p.Position += p.Velocity * timeScale;
+			var localPos = lastTransform.PointToLocal( p.Position );
+			var worldPos = _worldTx.PointToWorld( localPos );
+
+			p.Position = p.Position.LerpTo( worldPos, localSpace );
 		}
 
+		return true;
+	}
+
+	// Damping and force scale are evaluated in batches, these keep the random values the same for both update paths
+	internal static float GetDampingRandom( Particle p ) => ParticleFloatTable.GetRandom( p, 8234, 509 );
+	internal static float GetForceScaleRandom( Particle p ) => ParticleFloatTable.GetRandom( p, 7723, 510 );
+
+	/// <summary>
+	/// The velocity the orbital force and pull add to this particle this step.
+	/// </summary>
+	Vector3 GetOrbitalVelocity( Particle p, float delta, float forceScale, float timeScale )
+	{
+		var velocity = Vector3.Zero;
+
+		if ( !OrbitalForce.IsNearlyZero() )
+		{
+			var force = OrbitalForce.Evaluate( delta, p.Rand( 8363, 534 ), p.Rand( 5216, 534 ), p.Rand( 2323, 534 ) );
+			var localOffset = (_worldTx.Position - p.Position).Normal;
+			var rotatedOffset = localOffset.RotateAround( 0, new Angles( force ) );
+			var rotDelta = localOffset - rotatedOffset;
+
+			velocity += forceScale * rotDelta * timeScale;
+		}
+
+		if ( !OrbitalPull.IsNearlyZero() )
+		{
+			var localOffset = (_worldTx.Position - p.Position) / 100.0f;
+			velocity += forceScale * localOffset * timeScale * _orbitalPull.Evaluate( delta, p.Rand( 4333, 545 ) );
+		}
+
+		return velocity;
+	}
+
+	void ApplyConstantMovement( Particle p )
+	{
+		if ( ConstantMovement.IsNearlyZero() )
+			return;
+
+		p.Position += ConstantMovement.Evaluate( p, 4395, 552 ) * _timeDelta;
+	}
+
+	/// <summary>
+	/// Everything after the particle has moved - appearance, lifetime end, listeners, followers and bounds.
+	/// </summary>
+	void EndParticleUpdate( Particle p, float delta, float timeScale )
+	{
 		if ( ApplyColor )
 		{
-			var brightness = Brightness.Evaluate( p, 4626 );
+			var brightness = _brightness.Evaluate( p, 4626, 600 );
 
-			p.Color = Tint * Gradient.Evaluate( p, 8752 ); // TODO, gradient, between two gradients etc
+			p.Color = Tint * _gradient.Evaluate( p, 8752, 602 ); // TODO, gradient, between two gradients etc
 			p.Color *= new Color( brightness, 1.0f );
 		}
 
 		if ( ApplyAlpha )
 		{
-			p.Alpha = Alpha.Evaluate( p, 8525 );
+			p.Alpha = _alpha.Evaluate( p, 8525, 608 );
 		}
 
 		if ( ApplyShape )
 		{
-			p.Size = Scale.Evaluate( p, 6211 );
+			p.Size = _scale.Evaluate( p, 6211, 613 );
 
-			var aspect = Stretch.Evaluate( p, 62415 );
+			var aspect = _stretch.Evaluate( p, 62415, 615 );
 			if ( aspect < 0 )
 			{
 				p.Size.x *= aspect.Remap( 0, -1, 1, 2, false );
@@ -625,16 +760,16 @@ public sealed partial class ParticleEffect : Component, Component.ExecuteInEdito
 
 		if ( ApplyRotation )
 		{
-			p.Angles.pitch = Pitch.Evaluate( p, 2363 );
-			p.Angles.yaw = Yaw.Evaluate( p, 8762 );
-			p.Angles.roll = Roll.Evaluate( p, 3675 );
+			p.Angles.pitch = _pitch.Evaluate( p, 2363, 628 );
+			p.Angles.yaw = _yaw.Evaluate( p, 8762, 629 );
+			p.Angles.roll = _roll.Evaluate( p, 3675, 630 );
 		}
 
 		if ( SheetSequence )
 		{
-			p.SequenceTime.x = SequenceTime.Evaluate( p, 7234 );
-			p.SequenceTime.y += SequenceSpeed.Evaluate( p, 1351 ) * timeScale;
-			p.Sequence = (int)SequenceId.Evaluate( p, 1051 );
+			p.SequenceTime.x = _sequenceTime.Evaluate( p, 7234, 635 );
+			p.SequenceTime.y += _sequenceSpeed.Evaluate( p, 1351, 636 ) * timeScale;
+			p.Sequence = (int)_sequenceId.Evaluate( p, 1051, 637 );
 		}
 
 		if ( delta >= 1.0f )
@@ -682,7 +817,10 @@ public sealed partial class ParticleEffect : Component, Component.ExecuteInEdito
 	{
 		PreStep( timeDelta );
 
-		System.Threading.Tasks.Parallel.For( 0, Particles.Count, UpdateParticle );
+		var work = new List<ParticleWork>();
+		CollectWork( work );
+
+		System.Threading.Tasks.Parallel.ForEach( work, x => UpdateParticles( x.startIndex, x.endIndex ) );
 		PostStep();
 	}
 
@@ -691,7 +829,9 @@ public sealed partial class ParticleEffect : Component, Component.ExecuteInEdito
 	internal void CollectWork( List<ParticleWork> work )
 	{
 		int count = Particles.Count;
-		int chunkSize = 16;
+
+		// Big enough that the batched stages get a few full SIMD vectors per chunk
+		int chunkSize = 64;
 
 		for ( int i = 0; i < count; i += chunkSize )
 		{
@@ -733,6 +873,8 @@ public sealed partial class ParticleEffect : Component, Component.ExecuteInEdito
 
 		_trace = Scene.Trace.WithoutTags( CollisionIgnore );
 
+		UpdateTables();
+
 		RunDelayedParticles();
 	}
 
@@ -0,0 +1,214 @@
+﻿using System.Runtime.CompilerServices;
+
+namespace Sandbox;
+
+/// <summary>
+/// A <see cref="ParticleFloat"/> with its curves baked into fixed resolution lookup tables, so evaluating
+/// it for every particle is a couple of array reads instead of a binary search and a spline.
+/// Rebake with <see cref="Update"/>, which does nothing if the value hasn't changed.
+/// </summary>
+internal sealed class ParticleFloatTable
+{
+	/// <summary>
+	/// Number of segments in each baked curve
+	/// </summary>
+	public const int Resolution = 256;
+
+	ParticleFloat _source;
+	bool _baked;
+
+	ParticleFloat.ValueType _type;
+	ParticleFloat.EvaluationType _evaluation;
+	float _constantA;
+	float _constantB;
+
+	/// <summary>
+	/// Curves we can't bake accurately (stepped frames) are evaluated directly
+	/// </summary>
+	bool _exact;
+
+	readonly float[] _curveA = new float[Resolution + 1];
+	readonly float[] _curveB = new float[Resolution + 1];
+
+	/// <summary>
+	/// Bake the value if it's different to what we baked last time. Returns true if it was rebaked.
+	/// </summary>
+	public bool Update( in ParticleFloat value )
+	{
+		if ( _baked && IsSame( _source, value ) )
+			return false;
+
+		_source = value;
+		_baked = true;
+
+		_type = value.Type;
+		_evaluation = value.Evaluation;
+		_constantA = value.ConstantA;
+		_constantB = value.ConstantB;
+		_exact = false;
+
+		if ( _type == ParticleFloat.ValueType.Curve || _type == ParticleFloat.ValueType.CurveRange )
+		{
+			_exact = HasSteppedFrames( value.CurveA ) || (_type == ParticleFloat.ValueType.CurveRange && HasSteppedFrames( value.CurveB ));
+
+			Bake( value.CurveA, _curveA );
+
+			if ( _type == ParticleFloat.ValueType.CurveRange )
+			{
+				Bake( value.CurveB, _curveB );
+			}
+		}
+
+		return true;
+	}
+
+	/// <summary>
+	/// Same as <see cref="ParticleFloat.Evaluate(in float, in float)"/>
+	/// </summary>
+	[MethodImpl( MethodImplOptions.AggressiveInlining )]
+	public float Evaluate( float delta, float randomFixed )
+	{
+		if ( _exact )
+			return _source.Evaluate( delta, randomFixed );
+
+		float d = _evaluation switch
+		{
+			ParticleFloat.EvaluationType.Life => delta,
+			ParticleFloat.EvaluationType.Frame => Random.Shared.Float( 0, 1 ),
+			ParticleFloat.EvaluationType.Seed => randomFixed,
+			_ => delta,
+		};
+
+		return _type switch
+		{
+			ParticleFloat.ValueType.Constant => _constantA,
+			ParticleFloat.ValueType.Range => MathX.Lerp( _constantA, _constantB, d ),
+			ParticleFloat.ValueType.Curve => Sample( _curveA, d ),
+			ParticleFloat.ValueType.CurveRange => MathX.Lerp( Sample( _curveA, d ), Sample( _curveB, d ), randomFixed ),
+			_ => _constantA,
+		};
+	}
+
+	/// <summary>
+	/// Same as <see cref="ParticleFloat.Evaluate(IDynamicFloatContext, int, int)"/>
+	/// </summary>
+	[MethodImpl( MethodImplOptions.AggressiveInlining )]
+	public float Evaluate( IDynamicFloatContext context, int seed, [CallerLineNumber] int line = 0 )
+	{
+		return Evaluate( context.LifetimeDelta, GetRandom( context, seed, line ) );
+	}
+
+	/// <summary>
+	/// The random value <see cref="ParticleFloat.Evaluate(IDynamicFloatContext, int, int)"/> would use for this context, seed and line.
+	/// </summary>
+	[MethodImpl( MethodImplOptions.AggressiveInlining )]
+	public static float GetRandom( IDynamicFloatContext context, int seed, [CallerLineNumber] int line = 0 )
+	{
+		int randomFloatIndex = unchecked(context.RandomSeed ^ (line * 73856093) ^ seed);
+		return Game.Random.FloatDeterministic( randomFloatIndex );
+	}
+
+	/// <summary>
+	/// Evaluate for a batch of particles. The value type and evaluation mode are only checked once,
+	/// so each loop is just the lookup.
+	/// </summary>
+	public void Evaluate( ReadOnlySpan<float> delta, ReadOnlySpan<float> randomFixed, Span<float> output )
+	{
+		var count = output.Length;
+
+		if ( _exact || _evaluation == ParticleFloat.EvaluationType.Frame )
+		{
+			for ( int i = 0; i < count; i++ )
+			{
+				output[i] = Evaluate( delta[i], randomFixed[i] );
+			}
+
+			return;
+		}
+
+		var d = _evaluation == ParticleFloat.EvaluationType.Seed ? randomFixed : delta;
+
+		switch ( _type )
+		{
+			case ParticleFloat.ValueType.Range:
+				{
+					for ( int i = 0; i < count; i++ )
+					{
+						output[i] = MathX.Lerp( _constantA, _constantB, d[i] );
+					}
+					break;
+				}
+
+			case ParticleFloat.ValueType.Curve:
+				{
+					for ( int i = 0; i < count; i++ )
+					{
+						output[i] = Sample( _curveA, d[i] );
+					}
+					break;
+				}
+
+			case ParticleFloat.ValueType.CurveRange:
+				{
+					for ( int i = 0; i < count; i++ )
+					{
+						output[i] = MathX.Lerp( Sample( _curveA, d[i] ), Sample( _curveB, d[i] ), randomFixed[i] );
+					}
+					break;
+				}
+
+			default:
+				{
+					output.Fill( _constantA );
+					break;
+				}
+		}
+	}
+
+	[MethodImpl( MethodImplOptions.AggressiveInlining )]
+	static float Sample( float[] table, float d )
+	{
+		var x = Math.Clamp( d, 0.0f, 1.0f ) * Resolution;
+		var i = Math.Min( (int)x, Resolution - 1 );
+
+		return MathX.Lerp( table[i], table[i + 1], x - i, false );
+	}
+
+	static void Bake( in Curve curve, float[] table )
+	{
+		for ( int i = 0; i <= Resolution; i++ )
+		{
+			table[i] = curve.Evaluate( i / (float)Resolution );
+		}
+	}
+
+	static bool HasSteppedFrames( in Curve curve )
+	{
+		if ( curve.Frames.IsDefaultOrEmpty ) return false;
+
+		foreach ( var frame in curve.Frames )
+		{
+			if ( frame.Mode == Curve.HandleMode.Stepped ) return true;
+		}
+
+		return false;
+	}
+
+	/// <summary>
+	/// Cheap check for whether a value has changed. Curve frames are immutable, so comparing
+	/// the frame arrays by reference is enough.
+	/// </summary>
+	static bool IsSame( in ParticleFloat a, in ParticleFloat b )
+	{
+		return a.Type == b.Type
+			&& a.Evaluation == b.Evaluation
+			&& a.Constants == b.Constants
+			&& IsSame( a.CurveA, b.CurveA )
+			&& IsSame( a.CurveB, b.CurveB );
+	}
+
+	static bool IsSame( in Curve a, in Curve b )
+	{
+		return a.Frames == b.Frames && a.TimeRange == b.TimeRange && a.ValueRange == b.ValueRange;
+	}
+}
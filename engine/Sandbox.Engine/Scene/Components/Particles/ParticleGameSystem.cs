@@ -60,9 +60,6 @@ sealed class ParticleGameSystem : GameObjectSystem
 	/// <param name="work"></param>
 	private void ProcessWork( ParticleEffect.ParticleWork work )
 	{
-		for ( int i = work.startIndex; i < work.endIndex; i++ )
-		{
-			work.effect.UpdateParticle( i );
-		}
+		work.effect.UpdateParticles( work.startIndex, work.endIndex );
 	}
 }
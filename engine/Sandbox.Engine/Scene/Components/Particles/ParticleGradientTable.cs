@@ -0,0 +1,110 @@
+﻿using System.Runtime.CompilerServices;
+
+namespace Sandbox;
+
+/// <summary>
+/// A <see cref="ParticleGradient"/> with its gradient baked into a fixed resolution lookup table.
+/// Rebake with <see cref="Update"/>, which does nothing if the value hasn't changed.
+/// </summary>
+internal sealed class ParticleGradientTable
+{
+	/// <summary>
+	/// Number of segments in the baked gradient
+	/// </summary>
+	public const int Resolution = 256;
+
+	ParticleGradient _source;
+	bool _baked;
+
+	/// <summary>
+	/// Stepped gradients can't be baked accurately, so they're evaluated directly
+	/// </summary>
+	bool _exact;
+
+	readonly Color[] _gradient = new Color[Resolution + 1];
+
+	/// <summary>
+	/// Bake the value if it's different to what we baked last time. Returns true if it was rebaked.
+	/// </summary>
+	public bool Update( in ParticleGradient value )
+	{
+		if ( _baked && IsSame( _source, value ) )
+			return false;
+
+		_source = value;
+		_baked = true;
+		_exact = value.GradientA.Blending == Gradient.BlendMode.Stepped;
+
+		if ( value.Type == ParticleGradient.ValueType.Gradient )
+		{
+			for ( int i = 0; i <= Resolution; i++ )
+			{
+				_gradient[i] = value.GradientA.Evaluate( i / (float)Resolution );
+			}
+		}
+
+		return true;
+	}
+
+	/// <summary>
+	/// Same as <see cref="ParticleGradient.Evaluate(in float, in float)"/>
+	/// </summary>
+	[MethodImpl( MethodImplOptions.AggressiveInlining )]
+	public Color Evaluate( float delta, float randomFixed )
+	{
+		if ( _exact || _source.Type != ParticleGradient.ValueType.Gradient )
+			return _source.Evaluate( delta, randomFixed );
+
+		var d = _source.Evaluation switch
+		{
+			ParticleGradient.EvaluationType.Life => delta,
+			ParticleGradient.EvaluationType.Frame => Random.Shared.Float( 0, 1 ),
+			ParticleGradient.EvaluationType.Particle => randomFixed,
+			_ => delta,
+		};
+
+		var x = Math.Clamp( d, 0.0f, 1.0f ) * Resolution;
+		var i = Math.Min( (int)x, Resolution - 1 );
+
+		return Color.Lerp( _gradient[i], _gradient[i + 1], x - i, false );
+	}
+
+	/// <summary>
+	/// Same as <see cref="ParticleGradient.Evaluate(Particle, int, int)"/>
+	/// </summary>
+	[MethodImpl( MethodImplOptions.AggressiveInlining )]
+	public Color Evaluate( Particle p, int seed, [CallerLineNumber] int line = 0 )
+	{
+		return Evaluate( p.LifeDelta, p.Rand( seed, line ) );
+	}
+
+	/// <summary>
+	/// Evaluate for a batch of particles
+	/// </summary>
+	public void Evaluate( ReadOnlySpan<float> delta, ReadOnlySpan<float> randomFixed, Span<Color> output )
+	{
+		for ( int i = 0; i < output.Length; i++ )
+		{
+			output[i] = Evaluate( delta[i], randomFixed[i] );
+		}
+	}
+
+	static bool IsSame( in ParticleGradient a, in ParticleGradient b )
+	{
+		return a.Type == b.Type
+			&& a.Evaluation == b.Evaluation
+			&& a.ConstantA == b.ConstantA
+			&& a.ConstantB == b.ConstantB
+			&& IsSame( a.GradientA, b.GradientA );
+	}
+
+	/// <summary>
+	/// Gradient frames are immutable lists, so comparing them by reference is enough
+	/// </summary>
+	static bool IsSame( in Gradient a, in Gradient b )
+	{
+		return a.Blending == b.Blending
+			&& ReferenceEquals( a.Colors, b.Colors )
+			&& ReferenceEquals( a.Alphas, b.Alphas );
+	}
+}
@@ -10,7 +10,36 @@
 public class VolumetricFogController : Component, Component.ExecuteInEditor
 {
 	public Texture BakedFogTexture { get; set; }
-	public float GlobalScale { get; set; } = 1.0f;
+
+	float _globalScale = 1.0f;
+
+	public float GlobalScale
+	{
+		get => _globalScale;
+		set
+		{
+			if ( _globalScale == value ) return;
+
+			_globalScale = value;
+			UpdateVolumes();
+		}
+	}
+
+	protected override void OnEnabled() => UpdateVolumes();
+	protected override void OnDisabled() => UpdateVolumes();
+
+	/// <summary>
+	/// Map fog volumes scale their strength by ours, and only pre-render when something changes
+	/// </summary>
+	void UpdateVolumes()
+	{
+		if ( Scene is null ) return;
+
+		foreach ( var volume in Scene.GetAll<VolumetricFogVolume>() )
+		{
+			volume.OnControllerChanged();
+		}
+	}
 
 	internal static void InitializeFromLegacy( GameObject go, Sandbox.MapLoader.ObjectEntry kv )
 	{
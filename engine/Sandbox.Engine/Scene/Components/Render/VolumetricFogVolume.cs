@@ -7,13 +7,13 @@ namespace Sandbox;
 [Category( "Rendering" )]
 [Icon( "visibility" )]
 [EditorHandle( "materials/gizmo/VolumetricFogVolume.png" )]
-public class VolumetricFogVolume : Component, Component.ExecuteInEditor
+public class VolumetricFogVolume : Component, Component.ExecuteInEditor, Component.PreRenderOnlyWhenDirty
 {
 	SceneFogVolume sceneObject;
 
-	[Property] public BBox Bounds { get; set; } = BBox.FromPositionAndSize( 0, 300 );
-	[Property, Range( 0, 1 )] public float Strength { get; set; } = 1.0f;
-	[Property, Range( 0, 1 )] public float FalloffExponent { get; set; } = 1.0f;
+	[Property, MakeDirty] public BBox Bounds { get; set; } = BBox.FromPositionAndSize( 0, 300 );
+	[Property, MakeDirty, Range( 0, 1 )] public float Strength { get; set; } = 1.0f;
+	[Property, MakeDirty, Range( 0, 1 )] public float FalloffExponent { get; set; } = 1.0f;
 
 	bool isFromMap;
 
@@ -51,8 +51,7 @@ public class VolumetricFogVolume : Component, Component.ExecuteInEditor
 
 		if ( isFromMap )
 		{
-			// this is a legacy thing, not too much of a big deal yet but we shouldn't really be looking
-			// up every frame. Should really have VolumetricFogController
+			// this is a legacy thing, the controller tells us when it changes, see OnControllerChanged
 			strength *= Scene.GetAll<VolumetricFogController>().FirstOrDefault()?.GlobalScale ?? 1.0f;
 		}
 
@@ -62,6 +61,14 @@ public class VolumetricFogVolume : Component, Component.ExecuteInEditor
 		sceneObject.FalloffExponent = FalloffExponent;
 	}
 
+	/// <summary>
+	/// The scene's <see cref="VolumetricFogController"/> was added, removed or changed its scale
+	/// </summary>
+	internal void OnControllerChanged()
+	{
+		if ( isFromMap ) MarkPreRenderDirty();
+	}
+
 	internal static void InitializeFromLegacy( GameObject go, Sandbox.MapLoader.ObjectEntry kv )
 	{
 		var component = go.Components.Create<VolumetricFogVolume>();
@@ -1,4 +1,6 @@
-﻿namespace Sandbox;
+﻿using System.Buffers;
+
+namespace Sandbox;
 
 public partial class Terrain
 {
@@ -64,4 +66,91 @@ public partial class Terrain
 		ControlMap.Update( new ReadOnlySpan<Color32>( Storage.ControlMap ) );
 		HolesMap.Update( new ReadOnlySpan<byte>( Storage.HolesMap ) );
 	}
+
+	/// <summary>
+	/// Updates a region of the GPU texture maps with the CPU data
+	/// </summary>
+	public void SyncGPUTexture( SyncFlags flags, RectInt region )
+	{
+		if ( Storage is null || Application.IsHeadless )
+			return;
+
+		if ( flags.HasFlag( SyncFlags.Height ) )
+			UploadRegion( HeightMap, Storage.HeightMap, region );
+		if ( flags.HasFlag( SyncFlags.Control ) )
+			UploadRegion( ControlMap, Storage.ControlMap, region );
+		if ( flags.HasFlag( SyncFlags.Holes ) )
+			UploadRegion( HolesMap, Storage.HolesMap, region );
+	}
+
+	void UploadRegion<T>( Texture texture, T[] map, RectInt region ) where T : unmanaged
+	{
+		if ( texture is null || region.Width <= 0 || region.Height <= 0 )
+			return;
+
+		var resolution = Storage.Resolution;
+
+		if ( region.Width == resolution && region.Height == resolution )
+		{
+			texture.Update( new ReadOnlySpan<T>( map ) );
+			return;
+		}
+
+		// Texture updates want the rows packed together
+		var count = region.Width * region.Height;
+		var buffer = ArrayPool<T>.Shared.Rent( count );
+
+		try
+		{
+			for ( int y = 0; y < region.Height; y++ )
+			{
+				map.AsSpan( (region.Top + y) * resolution + region.Left, region.Width )
+					.CopyTo( buffer.AsSpan( y * region.Width ) );
+			}
+
+			texture.Update( new ReadOnlySpan<T>( buffer, 0, count ), region.Left, region.Top, region.Width, region.Height );
+		}
+		finally
+		{
+			ArrayPool<T>.Shared.Return( buffer );
+		}
+	}
+
+	readonly List<(SyncFlags Flags, RectInt Region)> _dirtyRegions = new();
+
+	/// <summary>
+	/// The <see cref="TerrainStorage.DirtyVersion"/> we've synced up to.
+	/// </summary>
+	long _syncedDirtyVersion;
+
+	protected override void OnUpdate()
+	{
+		SyncDirtyRegions();
+	}
+
+	/// <summary>
+	/// Uploads and updates the collider for everything marked with <see cref="TerrainStorage.MarkDirty"/> since
+	/// the last update, merging edits that touch each other so a frame of brush strokes only costs one upload.
+	/// </summary>
+	private void SyncDirtyRegions()
+	{
+		if ( Storage is null )
+			return;
+
+		Storage.GetDirtyRegions( ref _syncedDirtyVersion, _dirtyRegions );
+
+		foreach ( var (flags, region) in _dirtyRegions )
+		{
+			SyncGPUTexture( flags, region );
+
+			if ( flags.HasFlag( SyncFlags.Height ) || flags.HasFlag( SyncFlags.Holes ) )
+				UpdateColliderHeights( region.Left, region.Top, region.Width, region.Height );
+			if ( flags.HasFlag( SyncFlags.Control ) )
+				UpdateColliderMaterials( region.Left, region.Top, region.Width, region.Height );
+
+			OnTerrainModified?.Invoke( flags, region );
+		}
+
+		_dirtyRegions.Clear();
+	}
 }
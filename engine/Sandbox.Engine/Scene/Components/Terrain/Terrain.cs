@@ -85,6 +85,9 @@ public sealed partial class Terrain : Collider, Component.ExecuteInEditor
 		if ( Storage is null )
 			return;
 
+		// Everything gets uploaded and the collider rebuilt, so any earlier edits are already in
+		_syncedDirtyVersion = Storage.DirtyVersion;
+
 		if ( !Application.IsHeadless )
 		{
 			CreateTextureMaps();
@@ -194,6 +194,16 @@ public class ComponentList
 		return results;
 	}
 
+	/// <summary>
+	/// Add components to <paramref name="results"/> instead of making a new list.
+	/// </summary>
+	internal void GetAll<T>( FindMode find, List<T> results )
+	{
+		if ( go.IsDestroyed ) return;
+
+		CollectAll( results, find );
+	}
+
 	// This is an incredibly hot code path, even the slightest change should be verified with benchmarks.
 	private void CollectAll<T>( List<T> results, FindMode find )
 	{
@@ -0,0 +1,25 @@
+﻿namespace Sandbox;
+
+public partial class GameObject
+{
+	/// <summary>
+	/// Our handle in the scene's spatial index, or -1 if we're not in it.
+	/// </summary>
+	internal int SpatialHandle = -1;
+
+	/// <summary>
+	/// How many of our components are active. We're only in the spatial index while this is above zero.
+	/// </summary>
+	internal int SpatialRefs;
+
+	/// <summary>
+	/// We've moved, or been added or removed, since the spatial index last looked at us.
+	/// </summary>
+	internal bool SpatialDirty;
+
+	/// <summary>
+	/// One of our components has become active or inactive since the spatial index last looked at us, so the
+	/// components it keeps for us need taking again.
+	/// </summary>
+	internal bool SpatialComponentsDirty;
+}
@@ -23,6 +23,11 @@ public partial class GameTransform
 		_worldCached = default;
 		_worldInterpCached = default;
 
+		if ( GameObject.SpatialRefs > 0 )
+		{
+			GameObject.Scene?.SpatialIndexMoved( GameObject );
+		}
+
 		InsideChangeCallback = useTargetLocal;
 
 		try
@@ -2,23 +2,41 @@
 
 public partial class Scene : GameObject
 {
+	// listeners for each event interface that's been run on this scene
+	[SuppressNullKeyWarning]
+	Dictionary<Type, SceneEventListeners> eventListeners = new();
+
+	SceneEventListeners<T> GetEventListeners<T>()
+	{
+		if ( eventListeners.TryGetValue( typeof( T ), out var found ) )
+			return (SceneEventListeners<T>)found;
+
+		var listeners = new SceneEventListeners<T>( objectIndex.GetOrCreate( typeof( T ) ) );
+		eventListeners[typeof( T )] = listeners;
+		return listeners;
+	}
+
 	/// <summary>
 	/// Run an event on all components. The find argument is unused when calling this on a scene.
 	/// </summary>
 	public override void RunEvent<T>( Action<T> action, FindMode find = FindMode.EnabledInSelfAndDescendants )
 	{
-		foreach ( var c in GetAll<T>() )
-		{
-			try
-			{
-				action( c );
-			}
-			catch ( System.Exception e )
-			{
-				Log.Warning( e, e.Message );
-			}
-		}
+		var invoker = new ActionInvoker<T>( action );
+		GetEventListeners<T>().Run( ref invoker );
+	}
 
+	/// <summary>
+	/// Run an event on all components and systems, calling it on each one with <paramref name="invoker"/>.
+	/// Unlike <see cref="RunEvent{T}(Action{T}, FindMode)"/> this doesn't need a closure, so doesn't allocate.
+	/// </summary>
+	public void RunEvent<T, TInvoker>( TInvoker invoker ) where TInvoker : struct, ISceneEventInvoker<T>
+	{
+		GetEventListeners<T>().Run( ref invoker );
+	}
+
+	readonly struct ActionInvoker<T>( Action<T> action ) : ISceneEventInvoker<T>
+	{
+		public void Invoke( T listener ) => action( listener );
 	}
 }
 
@@ -39,6 +57,18 @@ public interface ISceneEvent<T>
 		Game.ActiveScene.RunEvent( action );
 	}
 
+	/// <summary>
+	/// Post an event to the entire scene, including GameObjectSystem's. The event is called on each listener by
+	/// <paramref name="invoker"/>, a struct holding the event's arguments, so nothing is allocated. Worth using for
+	/// events that fire every tick or every hit, like `IPlayerEvents.Post( new PlayerHurt( this, amount ) )`.
+	/// </summary>
+	public static void Post<TInvoker>( TInvoker invoker ) where TInvoker : struct, ISceneEventInvoker<T>
+	{
+		if ( !Game.ActiveScene.IsValid() ) return;
+
+		Game.ActiveScene.RunEvent<T, TInvoker>( invoker );
+	}
+
 	/// <summary>
 	/// Post event to a specific GameObject (and its descendants by default - you can specify a <see cref="FindMode"/> to control this)
 	/// </summary>
@@ -219,7 +219,8 @@ public partial class Scene : GameObject
 
 	public override void Deserialize( JsonObject node ) => Deserialize( node, new DeserializeOptions() );
 
-	internal JsonObject SerializeProperties()
+	/// <param name="includeNavMeshTiles">Save the generated navmesh tiles too, so they don't need generating when loaded</param>
+	internal JsonObject SerializeProperties( bool includeNavMeshTiles = false )
 	{
 		var jso = new JsonObject();
 
@@ -236,7 +237,7 @@ public partial class Scene : GameObject
 		}
 
 		jso.Add( "Metadata", SerializeMetadata() );
-		jso.Add( "NavMesh", NavMesh.Serialize() );
+		jso.Add( "NavMesh", NavMesh.Serialize( includeNavMeshTiles ) );
 
 		return jso;
 	}
@@ -310,6 +311,6 @@ public partial class Scene : GameObject
 
 		target.Id = Id;
 		target.GameObjects = Children.Select( x => x.Serialize() ).Where( x => x is not null ).ToArray();
-		target.SceneProperties = SerializeProperties();
+		target.SceneProperties = SerializeProperties( true );
 	}
 }
@@ -27,6 +27,8 @@ public partial class Scene : GameObject
 
 		NavMesh.UpdateCache( PhysicsWorld );
 
-		NavMesh.crowd.Update( Time.Delta, new DotRecast.Detour.Crowd.DtCrowdAgentDebugInfo() );
+		NavMesh.UpdateCrowd( Time.Delta );
+
+		NavMesh.ProcessPathQueue();
 	}
 }
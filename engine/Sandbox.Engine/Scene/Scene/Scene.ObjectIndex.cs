@@ -27,6 +27,10 @@ public partial class Scene : GameObject
 	internal HashSetEx<Component> fixedUpdateComponents = new();
 	internal HashSetEx<Component> preRenderComponents = new();
 
+	// PreRenderOnlyWhenDirty components that have changed since the last PreRender
+	HashSet<Component> dirtyPreRenderComponents = new();
+	HashSet<Component> preRenderingComponents = new();
+
 	/// <summary>
 	/// Should only be called when destroying the scene. This here just to avoid unregistering
 	/// all of the objects when we don't need to, because we're just quitting.
@@ -40,9 +44,13 @@ public partial class Scene : GameObject
 
 		objectsInIndex.Clear();
 		objectIndex.Clear();
+		eventListeners.Clear();
 		updateComponents.Clear();
 		fixedUpdateComponents.Clear();
 		preRenderComponents.Clear();
+		dirtyPreRenderComponents.Clear();
+		_spatialIndex = null;
+		_spatialDirty.Clear();
 	}
 
 	/// <summary>
@@ -53,6 +61,9 @@ public partial class Scene : GameObject
 	{
 		var ft = FastTimer.StartNew();
 
+		// re-adding would count every component again, so start the spatial index over
+		ClearSpatialIndex();
+
 		// copy the list
 		var temporaryHash = objectsInIndex.ToList();
 
@@ -60,6 +71,9 @@ public partial class Scene : GameObject
 		objectsInIndex.Clear();
 		objectIndex.Clear();
 
+		// these hold on to the old index, and could be for types that don't exist anymore
+		eventListeners.Clear();
+
 		// We can't clear updateComponents etc because ActionGraph add to them manually
 
 		// re-add everything
@@ -108,7 +122,20 @@ public partial class Scene : GameObject
 		{
 			if ( c is IUpdateSubscriber || c.OnComponentUpdate is not null ) updateComponents.Add( c );
 			if ( c is IFixedUpdateSubscriber || c.OnComponentFixedUpdate is not null ) fixedUpdateComponents.Add( c );
-			if ( c is IPreRenderSubscriber ) preRenderComponents.Add( c );
+			if ( c is IPreRenderSubscriber )
+			{
+				if ( c is Component.PreRenderOnlyWhenDirty )
+				{
+					c.StartPreRenderTracking();
+					dirtyPreRenderComponents.Add( c );
+				}
+				else
+				{
+					preRenderComponents.Add( c );
+				}
+			}
+
+			SpatialIndexAdd( c.GameObject );
 		}
 	}
 
@@ -141,10 +168,28 @@ public partial class Scene : GameObject
 		{
 			if ( c is IUpdateSubscriber || c.OnComponentUpdate is not null ) updateComponents.Remove( c );
 			if ( c is IFixedUpdateSubscriber || c.OnComponentFixedUpdate is not null ) fixedUpdateComponents.Remove( c );
-			if ( c is IPreRenderSubscriber ) preRenderComponents.Remove( c );
+			if ( c is IPreRenderSubscriber )
+			{
+				preRenderComponents.Remove( c );
+				dirtyPreRenderComponents.Remove( c );
+				c.StopPreRenderTracking();
+			}
+
+			SpatialIndexRemove( c.GameObject );
 		}
 	}
 
+	/// <summary>
+	/// Have a <see cref="Component.PreRenderOnlyWhenDirty"/> component pre-rendered during the next <see cref="PreRender"/>.
+	/// </summary>
+	internal void MarkPreRenderDirty( Component c )
+	{
+		if ( c is not IPreRenderSubscriber ) return;
+		if ( !objectsInIndex.Contains( c ) ) return;
+
+		dirtyPreRenderComponents.Add( c );
+	}
+
 	/// <summary>
 	/// Get all objects of this type. This could be a component or a GameObjectSystem, or other stuff in the future.
 	/// </summary>
@@ -0,0 +1,222 @@
+﻿using Sandbox.Utility;
+using System.Threading;
+
+namespace Sandbox;
+
+//
+// Every GameObject with an active component, sorted into a spatial hash by its world position, so proximity
+// queries don't have to go through physics or check every component in the scene. Nothing is kept until the
+// first query. After that, components coming and going and objects moving are only noted as they happen,
+// and the hash catches up with all of them at one point in the frame, after UpdateBones. Each entry is a copy
+// of the object's enabled components taken at that point, so queries never touch a live ComponentList or
+// change the hash, and they can run on any thread at any other time.
+//
+
+public partial class Scene : GameObject
+{
+	SpatialHash<Component[]> _spatialIndex;
+	List<GameObject> _spatialDirty = new();
+
+	[ThreadStatic]
+	static List<int> _spatialResults;
+
+	/// <summary>
+	/// Size of each cell in the spatial index.
+	/// </summary>
+	const float SpatialCellSize = 512.0f;
+
+	/// <summary>
+	/// Find components of type <typeparamref name="T"/> on enabled GameObjects whose position is inside
+	/// <paramref name="sphere"/>. Results are added to <paramref name="results"/>, which isn't cleared first.
+	/// </summary>
+	/// <remarks>
+	/// Objects are where they were, with the components they had, after the last update, on every thread. This
+	/// can be called from any thread, but the first call has to be on the main thread.
+	/// </remarks>
+	public void FindInSphere<T>( Sphere sphere, List<T> results )
+	{
+		var index = GetSpatialIndex();
+		var handles = _spatialResults ??= new List<int>();
+
+		handles.Clear();
+		index.FindInSphere( sphere, handles );
+
+		CollectSpatialResults( index, handles, results );
+	}
+
+	/// <summary>
+	/// Find components of type <typeparamref name="T"/> on enabled GameObjects whose position is inside
+	/// <paramref name="box"/>. Results are added to <paramref name="results"/>, which isn't cleared first.
+	/// </summary>
+	/// <remarks>
+	/// Objects are where they were, with the components they had, after the last update, on every thread. This
+	/// can be called from any thread, but the first call has to be on the main thread.
+	/// </remarks>
+	public void FindInBox<T>( BBox box, List<T> results )
+	{
+		var index = GetSpatialIndex();
+		var handles = _spatialResults ??= new List<int>();
+
+		handles.Clear();
+		index.FindInBox( box, handles );
+
+		CollectSpatialResults( index, handles, results );
+	}
+
+	static void CollectSpatialResults<T>( SpatialHash<Component[]> index, List<int> handles, List<T> results )
+	{
+		for ( int i = 0; i < handles.Count; i++ )
+		{
+			foreach ( var component in index[handles[i]] )
+			{
+				if ( component is T t )
+					results.Add( t );
+			}
+		}
+
+		handles.Clear();
+	}
+
+	/// <summary>
+	/// What queries will see of this object until it changes again. Only ever taken on the main thread.
+	/// </summary>
+	static Component[] GetSpatialComponents( GameObject go )
+	{
+		go.SpatialComponentsDirty = false;
+		return go.Components.GetAll( FindMode.EnabledInSelf ).ToArray();
+	}
+
+	SpatialHash<Component[]> GetSpatialIndex()
+	{
+		var index = Volatile.Read( ref _spatialIndex );
+		if ( index is not null )
+			return index;
+
+		ThreadSafe.AssertIsMainThread();
+
+		// Fill it in before anyone else can see it, this is the only time it's changed outside of UpdateSpatialIndex
+		index = new SpatialHash<Component[]>( SpatialCellSize );
+
+		foreach ( var obj in objectsInIndex )
+		{
+			if ( obj is not Component c || c.GameObject is null )
+				continue;
+
+			var go = c.GameObject;
+
+			if ( go.SpatialRefs++ == 0 )
+			{
+				go.SpatialHandle = index.Add( GetSpatialComponents( go ), go.WorldPosition );
+			}
+		}
+
+		Volatile.Write( ref _spatialIndex, index );
+		return index;
+	}
+
+	/// <summary>
+	/// Add, remove and move everything that's changed since last time. This is the only place the hash
+	/// changes once it's built, so it's called at one point in the frame.
+	/// </summary>
+	internal void UpdateSpatialIndex()
+	{
+		if ( _spatialIndex is null )
+			return;
+
+		foreach ( var go in _spatialDirty )
+		{
+			go.SpatialDirty = false;
+
+			if ( go.SpatialRefs > 0 )
+			{
+				if ( go.SpatialHandle < 0 )
+				{
+					go.SpatialHandle = _spatialIndex.Add( GetSpatialComponents( go ), go.WorldPosition );
+					continue;
+				}
+
+				_spatialIndex.Move( go.SpatialHandle, go.WorldPosition );
+
+				if ( go.SpatialComponentsDirty )
+					_spatialIndex.Set( go.SpatialHandle, GetSpatialComponents( go ) );
+			}
+			else if ( go.SpatialHandle >= 0 )
+			{
+				_spatialIndex.Remove( go.SpatialHandle );
+				go.SpatialHandle = -1;
+				go.SpatialComponentsDirty = false;
+			}
+		}
+
+		_spatialDirty.Clear();
+	}
+
+	/// <summary>
+	/// Forget the spatial index, it'll be built again on the next query.
+	/// </summary>
+	void ClearSpatialIndex()
+	{
+		if ( _spatialIndex is null )
+			return;
+
+		foreach ( var obj in objectsInIndex )
+		{
+			if ( obj is Component c )
+			{
+				c.GameObject.SpatialHandle = -1;
+				c.GameObject.SpatialRefs = 0;
+				c.GameObject.SpatialDirty = false;
+				c.GameObject.SpatialComponentsDirty = false;
+			}
+		}
+
+		_spatialIndex = null;
+		_spatialDirty.Clear();
+	}
+
+	/// <summary>
+	/// A component on this object has become active.
+	/// </summary>
+	void SpatialIndexAdd( GameObject go )
+	{
+		if ( _spatialIndex is null || go is null )
+			return;
+
+		go.SpatialRefs++;
+		go.SpatialComponentsDirty = true;
+		SpatialIndexDirty( go );
+	}
+
+	/// <summary>
+	/// A component on this object is no longer active.
+	/// </summary>
+	void SpatialIndexRemove( GameObject go )
+	{
+		if ( _spatialIndex is null || go is null || go.SpatialRefs <= 0 )
+			return;
+
+		go.SpatialRefs--;
+		go.SpatialComponentsDirty = true;
+		SpatialIndexDirty( go );
+	}
+
+	/// <summary>
+	/// This object's world transform has changed.
+	/// </summary>
+	internal void SpatialIndexMoved( GameObject go )
+	{
+		if ( go.SpatialRefs <= 0 )
+			return;
+
+		SpatialIndexDirty( go );
+	}
+
+	void SpatialIndexDirty( GameObject go )
+	{
+		if ( go.SpatialDirty )
+			return;
+
+		go.SpatialDirty = true;
+		_spatialDirty.Add( go );
+	}
+}
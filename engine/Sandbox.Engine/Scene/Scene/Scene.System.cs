@@ -85,6 +85,11 @@ public partial class Scene
 		{
 			l.ClearMetrics();
 		}
+
+		foreach ( var e in eventListeners.Values )
+		{
+			e.ClearMetrics();
+		}
 	}
 
 	/// <summary>
@@ -93,7 +98,9 @@ public partial class Scene
 	/// </summary>
 	internal object[] GetListenerMetrics()
 	{
-		return listeners.Values.SelectMany( x => x.GetMetrics() ).ToArray();
+		return listeners.Values.SelectMany( x => x.GetMetrics() )
+			.Concat( eventListeners.Values.Where( x => x.HasMetrics ).Select( x => x.GetMetric() ) )
+			.ToArray();
 	}
 
 	/// <summary>
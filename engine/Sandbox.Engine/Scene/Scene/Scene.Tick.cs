@@ -104,6 +104,26 @@ public partial class Scene : GameObject
 	internal void PreRender()
 	{
 		foreach ( var c in preRenderComponents.EnumerateLocked() ) c.OnPreRenderInternal();
+
+		SceneMetrics.PreRenderComponents += preRenderComponents.Count;
+
+		if ( dirtyPreRenderComponents.Count == 0 )
+			return;
+
+		// Swap, so anything that gets dirty while we're pre-rendering is done next frame
+		(preRenderingComponents, dirtyPreRenderComponents) = (dirtyPreRenderComponents, preRenderingComponents);
+
+		SceneMetrics.PreRenderDirtyComponents += preRenderingComponents.Count;
+
+		foreach ( var c in preRenderingComponents )
+		{
+			// Something pre-rendered before it could have destroyed or disabled it
+			if ( !objectsInIndex.Contains( c ) ) continue;
+
+			c.OnPreRenderInternal();
+		}
+
+		preRenderingComponents.Clear();
 	}
 
 	static Superluminal _updateTimer = new Superluminal( "Scene.Update", Color.Cyan );
@@ -169,6 +189,8 @@ public partial class Scene : GameObject
 				Signal( GameObjectSystem.Stage.UpdateBones );
 			}
 
+			UpdateSpatialIndex();
+
 			if ( !Application.IsHeadless )
 			{
 				using ( _preRenderTimer.Start() )
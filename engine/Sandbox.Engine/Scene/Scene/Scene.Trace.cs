@@ -1,4 +1,5 @@
 ﻿using NativeEngine;
+using System.Buffers;
 using System.Collections.Immutable;
 
 namespace Sandbox;
@@ -99,17 +100,114 @@ public partial class Scene : GameObject
 		if ( bestResult.Fraction < 2 )
 			return bestResult;
 
-		// Empty result
+		return EmptyTraceResult( trace.PhysicsTrace.request.StartPos, trace.PhysicsTrace.request.EndPos );
+	}
+
+	internal void RunTraceBatch( SceneTrace trace, ReadOnlySpan<TraceSweep> sweeps, Span<SceneTraceResult> results )
+	{
+		if ( results.Length < sweeps.Length )
+			throw new ArgumentException( "Not enough room for the results", nameof( results ) );
+
+		SceneMetrics.RayTrace += sweeps.Length;
+
+		if ( trace.NeedsFilterCallback )
+		{
+			trace.PhysicsTrace.filterCallback = trace.FilterCallback;
+		}
+
+		if ( trace.IncludePhysicsWorld )
+		{
+			var physicsResults = ArrayPool<PhysicsTraceResult>.Shared.Rent( sweeps.Length );
+
+			try
+			{
+				trace.PhysicsTrace.RunBatch( sweeps, physicsResults );
+
+				for ( int i = 0; i < sweeps.Length; i++ )
+				{
+					results[i] = SceneTraceResult.From( this, physicsResults[i] );
+				}
+			}
+			finally
+			{
+				ArrayPool<PhysicsTraceResult>.Shared.Return( physicsResults );
+			}
+		}
+		else
+		{
+			for ( int i = 0; i < sweeps.Length; i++ )
+			{
+				results[i] = default;
+				results[i].Fraction = float.MaxValue;
+			}
+		}
+
+		var includeMeshes = trace.IncludeRenderMeshes && SceneWorld is not null;
+		var hasProviders = systems.Exists( x => x is GameObjectSystem.ITraceProvider );
+
+		// Render meshes and trace providers only take a single trace, so run them per sweep
+		if ( includeMeshes || hasProviders )
+		{
+			for ( int i = 0; i < sweeps.Length; i++ )
+			{
+				var sweepTrace = trace;
+				sweepTrace.PhysicsTrace.request.StartPos = sweeps[i].From;
+				sweepTrace.PhysicsTrace.request.EndPos = sweeps[i].To;
+
+				if ( sweeps[i].Radius > 0.0f )
+					sweepTrace = sweepTrace.Radius( sweeps[i].Radius );
+
+				if ( includeMeshes )
+				{
+					var mt = Engine.Utility.RayTrace.MeshTraceRequest.From( sweepTrace.PhysicsTrace.request, SceneWorld, trace.CullMode );
+					mt.filterCallback = trace.NeedsFilterCallback ? trace.FilterCallback : default;
+					var meshTraceResult = mt.Run();
+					if ( meshTraceResult.Hit )
+					{
+						var result = SceneTraceResult.From( this, meshTraceResult );
+
+						if ( result.Fraction < results[i].Fraction )
+							results[i] = result;
+					}
+				}
+
+				if ( !hasProviders )
+					continue;
+
+				foreach ( var system in systems )
+				{
+					if ( system is GameObjectSystem.ITraceProvider traceProvider )
+					{
+						var result = traceProvider.DoTrace( sweepTrace );
+
+						if ( result.HasValue && result.Value.Fraction < results[i].Fraction )
+							results[i] = result.Value;
+					}
+				}
+			}
+		}
+
+		for ( int i = 0; i < sweeps.Length; i++ )
+		{
+			if ( results[i].Fraction >= 2 )
+			{
+				results[i] = EmptyTraceResult( sweeps[i].From, sweeps[i].To );
+			}
+		}
+	}
+
+	SceneTraceResult EmptyTraceResult( in Vector3 start, in Vector3 end )
+	{
 		return new SceneTraceResult
 		{
-			Scene = trace.scene,
+			Scene = this,
 			Hit = false,
 			StartedSolid = false,
-			StartPosition = trace.PhysicsTrace.request.StartPos,
-			EndPosition = trace.PhysicsTrace.request.EndPos,
-			HitPosition = trace.PhysicsTrace.request.EndPos,
+			StartPosition = start,
+			EndPosition = end,
+			HitPosition = end,
 			Fraction = 1,
-			Direction = (trace.PhysicsTrace.request.EndPos - trace.PhysicsTrace.request.StartPos).Normal,
+			Direction = (end - start).Normal,
 			Tags = default
 		};
 	}
@@ -642,6 +740,16 @@ public partial struct SceneTrace
 		return scene.RunTrace( this );
 	}
 
+	/// <summary>
+	/// Run this trace once for each sweep, writing the first hit of each to <paramref name="results"/>.
+	/// Filtering and the physics world are only set up once for the whole batch, so this is much cheaper
+	/// than running a trace for each when you have a lot of them.
+	/// </summary>
+	public readonly void RunBatch( ReadOnlySpan<TraceSweep> sweeps, Span<SceneTraceResult> results )
+	{
+		scene.RunTraceBatch( this, sweeps, results );
+	}
+
 	/// <summary>
 	/// Run the trace and record everything we hit along the way. The result will be an array of hits.
 	/// </summary>
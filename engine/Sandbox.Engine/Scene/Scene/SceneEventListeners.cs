@@ -0,0 +1,124 @@
+﻿using Sandbox.Utility;
+
+namespace Sandbox;
+
+/// <summary>
+/// Calls a scene event on one listener. Implement this on a struct that holds the event's arguments and pass it to
+/// <see cref="ISceneEvent{T}.Post{TInvoker}"/>, to post an event without allocating a closure for it.
+/// </summary>
+public interface ISceneEventInvoker<in T>
+{
+	/// <summary>
+	/// Call the event on <paramref name="listener"/>.
+	/// </summary>
+	void Invoke( T listener );
+}
+
+/// <summary>
+/// Everything in a scene's object index implementing one event interface, copied into an array so running the event
+/// is a straight loop. The array is only rebuilt after something is added to or removed from the index.
+/// </summary>
+abstract class SceneEventListeners
+{
+	protected int _totalRuns;
+	protected double _totalMilliseconds;
+
+	public abstract Type EventType { get; }
+
+	/// <summary>
+	/// True if this event has been run since the metrics were last cleared.
+	/// </summary>
+	internal bool HasMetrics => _totalRuns > 0;
+
+	internal void ClearMetrics()
+	{
+		_totalRuns = 0;
+		_totalMilliseconds = 0;
+	}
+
+	internal object GetMetric()
+	{
+		return new { Name = "RunEvent", ClassName = EventType.Name, Count = _totalRuns, TotalMs = _totalMilliseconds, Avg = _totalRuns > 0 ? _totalMilliseconds / _totalRuns : 0 };
+	}
+}
+
+/// <inheritdoc cref="SceneEventListeners"/>
+sealed class SceneEventListeners<T> : SceneEventListeners
+{
+	readonly HashSetEx<object> _source;
+
+	T[] _listeners = [];
+	int _count;
+	int _version = -1;
+	int _running;
+
+	public SceneEventListeners( HashSetEx<object> source )
+	{
+		_source = source;
+	}
+
+	public override Type EventType => typeof( T );
+
+	void Update()
+	{
+		if ( _version == _source.Version )
+			return;
+
+		_version = _source.Version;
+
+		// Anything running this event right now is still looping over the old array, so leave it alone
+		var listeners = _running > 0 ? Array.Empty<T>() : _listeners;
+		var count = _source.CopyTo( ref listeners );
+
+		if ( listeners == _listeners && count < _count )
+		{
+			Array.Clear( listeners, count, _count - count );
+		}
+
+		_listeners = listeners;
+		_count = count;
+	}
+
+	/// <summary>
+	/// Call <paramref name="invoker"/> on every valid listener. Listeners added while this is running
+	/// won't be called until next time.
+	/// </summary>
+	public void Run<TInvoker>( ref TInvoker invoker ) where TInvoker : struct, ISceneEventInvoker<T>
+	{
+		Update();
+
+		if ( _count == 0 )
+			return;
+
+		var listeners = _listeners;
+		var count = _count;
+		var timer = FastTimer.StartNew();
+
+		_running++;
+
+		try
+		{
+			for ( int i = 0; i < count; i++ )
+			{
+				var listener = listeners[i];
+				if ( listener is IValid { IsValid: false } ) continue;
+
+				try
+				{
+					invoker.Invoke( listener );
+				}
+				catch ( System.Exception e )
+				{
+					Log.Warning( e, e.Message );
+				}
+			}
+		}
+		finally
+		{
+			_running--;
+		}
+
+		_totalRuns++;
+		_totalMilliseconds += timer.ElapsedMilliSeconds;
+	}
+}
@@ -12,6 +12,8 @@ internal static class SceneMetrics
 		ComponentsDestroyed = 0;
 		RayTrace = 0;
 		RayTraceAll = 0;
+		PreRenderComponents = 0;
+		PreRenderDirtyComponents = 0;
 	}
 
 	public static double ParticlesCreated = 0;
@@ -22,4 +24,14 @@ internal static class SceneMetrics
 	public static double ComponentsDestroyed = 0;
 	public static double RayTrace = 0;
 	public static double RayTraceAll = 0;
+
+	/// <summary>
+	/// Components that had OnPreRender called because they're pre-rendered every frame
+	/// </summary>
+	public static double PreRenderComponents = 0;
+
+	/// <summary>
+	/// <see cref="Component.PreRenderOnlyWhenDirty"/> components that had OnPreRender called because they changed
+	/// </summary>
+	public static double PreRenderDirtyComponents = 0;
 }
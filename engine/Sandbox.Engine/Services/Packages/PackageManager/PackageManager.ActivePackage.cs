@@ -211,6 +211,11 @@ internal static partial class PackageManager
 			return FileSystem.FindFile( "/", "*.cll", true ).Any();
 		}
 
+		/// <summary>
+		/// Where compiled code archives are cached between sessions, see <see cref="CompileGroup.OutputCache"/>
+		/// </summary>
+		static CompileOutputCache CompileOutputCache;
+
 		internal async Task<bool> CompileCodeArchive()
 		{
 			// get all the code archives
@@ -231,6 +236,12 @@ internal static partial class PackageManager
 			group.AccessControl = AccessControl;
 			group.ReferenceProvider = this;
 
+			// Dedicated servers compile the same archives every boot and map change, keep the output around
+			if ( Application.IsDedicatedServer )
+			{
+				group.OutputCache = CompileOutputCache ??= CompileOutputCache.CreateGlobal();
+			}
+
 			using ( analytic.ScopeTimer( "LoadArchives" ) )
 			{
 				foreach ( var file in codeArchives )
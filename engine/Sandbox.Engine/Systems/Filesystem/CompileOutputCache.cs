@@ -0,0 +1,104 @@
+﻿using System.Threading;
+
+namespace Sandbox;
+
+/// <summary>
+/// Keeps compiled package assemblies on disk between sessions, see <see cref="CompileGroup.OutputCache"/>.
+/// Reading an entry bumps its write time, and storing one deletes the least recently used entries until the
+/// folder fits in <see cref="MaxSize"/>, so a server that cycles through lots of packages doesn't fill its disk.
+/// </summary>
+sealed class CompileOutputCache : ICompileOutputCache
+{
+	[ConVar( "compile_cache_size", ConVarFlags.Protected, Help = "How many megabytes of compiled package code to keep on disk" )]
+	internal static int CacheSizeMb { get; set; } = 512;
+
+	readonly string _folder;
+	readonly Lock _lock = new Lock();
+
+	/// <summary>
+	/// Size in bytes we trim the folder down to after storing an entry
+	/// </summary>
+	public long MaxSize { get; set; }
+
+	public CompileOutputCache( string folder, long maxSize )
+	{
+		System.IO.Directory.CreateDirectory( folder );
+
+		_folder = folder;
+		MaxSize = maxSize;
+	}
+
+	/// <summary>
+	/// The cache used by the package manager, in the global cache folder
+	/// </summary>
+	public static CompileOutputCache CreateGlobal()
+	{
+		var folder = EngineFileSystem.Root.GetFullPath( "/.source2/cache/compile" );
+		return new CompileOutputCache( folder, CacheSizeMb * 1024L * 1024L );
+	}
+
+	string GetPath( string key ) => System.IO.Path.Combine( _folder, $"{key.Md5()}.bin" );
+
+	public byte[] Get( string key )
+	{
+		var path = GetPath( key );
+
+		lock ( _lock )
+		{
+			if ( !System.IO.File.Exists( path ) )
+				return null;
+
+			try
+			{
+				var data = System.IO.File.ReadAllBytes( path );
+				System.IO.File.SetLastWriteTimeUtc( path, DateTime.UtcNow );
+				return data;
+			}
+			catch ( System.IO.IOException e )
+			{
+				Log.Warning( e, $"Couldn't read compile cache entry: {e.Message}" );
+				return null;
+			}
+		}
+	}
+
+	public void Set( string key, byte[] data )
+	{
+		ArgumentNullException.ThrowIfNull( key );
+		ArgumentNullException.ThrowIfNull( data );
+
+		lock ( _lock )
+		{
+			System.IO.File.WriteAllBytes( GetPath( key ), data );
+			Trim();
+		}
+	}
+
+	/// <summary>
+	/// Delete the least recently used entries until we're under <see cref="MaxSize"/>
+	/// </summary>
+	void Trim()
+	{
+		var files = new System.IO.DirectoryInfo( _folder ).GetFiles( "*.bin" );
+		var total = files.Sum( x => x.Length );
+
+		if ( total <= MaxSize )
+			return;
+
+		foreach ( var file in files.OrderBy( x => x.LastWriteTimeUtc ) )
+		{
+			if ( total <= MaxSize )
+				break;
+
+			try
+			{
+				file.Delete();
+				total -= file.Length;
+			}
+			catch ( System.IO.IOException e )
+			{
+				Log.Warning( e, $"Couldn't delete compile cache entry: {e.Message}" );
+			}
+		}
+	}
+}
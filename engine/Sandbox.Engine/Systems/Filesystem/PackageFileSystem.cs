@@ -12,4 +12,15 @@ internal class PackageFileSystem : BaseFileSystem
 		// Files are all lowercase in manifests, so ignore case in comparer
 		system = AssetDownloadCache.CreateRedirectFileSystem();
 	}
+
+	/// <summary>
+	/// Every compiled resource in the package. All of its files come from the package's manifest,
+	/// so this doesn't need to walk any directories.
+	/// </summary>
+	internal IEnumerable<string> FindCompiledResources()
+	{
+		return Redirect.Files.Keys
+			.Select( x => x.FullName.Trim( '/' ) )
+			.Where( x => x.EndsWith( "_c", StringComparison.OrdinalIgnoreCase ) );
+	}
 }
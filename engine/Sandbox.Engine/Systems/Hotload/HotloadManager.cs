@@ -267,6 +267,12 @@ internal class HotloadManager : IDisposable
 						log.Info( $"   Instance queue: {info.InstanceQueueTime:0.0}ms" );
 						log.Info( $"        Diagnostics: {info.DiagnosticsTime:0.0}ms" );
 						log.Info( $"    Static fields: {info.StaticFieldTime:0.0}ms" );
+
+						foreach ( var (thread, timing) in info.StaticFieldScanThreadTimings )
+						{
+							log.Info( $"        {thread}: {timing.Instances:n0} fields in {timing.Milliseconds:0.0}ms" );
+						}
+
 						log.Info( $"Watched instances: {info.WatchedInstanceTime:0.0}ms" );
 
 						LogVerboseTimingInfo( info.TypeTimings );
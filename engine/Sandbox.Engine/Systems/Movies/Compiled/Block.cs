@@ -1,5 +1,6 @@
 ﻿using System;
 using System.Collections.Immutable;
+using System.Threading;
 
 namespace Sandbox.MovieMaker.Compiled;
 
@@ -78,14 +79,37 @@ public sealed record CompiledConstantBlock<T>( MovieTimeRange TimeRange, T Value
 [Expose]
 public sealed partial record CompiledSampleBlock<T>( MovieTimeRange TimeRange, MovieTime Offset, int SampleRate, ImmutableArray<T> Samples ) : ICompiledPropertyBlock<T>
 {
-	private readonly ImmutableArray<T> _samples = Validate( Samples );
+	private ImmutableArray<T> _samples = Validate( Samples );
+
+	/// <summary>
+	/// Samples loaded from a movie resource that haven't been needed yet, see <see cref="SampleCodec"/>.
+	/// </summary>
+	private EncodedSamples<T>? _encoded;
+
+	/// <summary>
+	/// Create a block from encoded samples, which are only decoded the first time <see cref="Samples"/> is read.
+	/// </summary>
+	internal CompiledSampleBlock( MovieTimeRange timeRange, MovieTime offset, int sampleRate, EncodedSamples<T> encoded )
+		: this( timeRange, offset, sampleRate, _pending )
+	{
+		_encoded = encoded;
+	}
 
 	public ImmutableArray<T> Samples
 	{
-		get => _samples;
-		init => _samples = Validate( value );
+		get => Volatile.Read( ref _encoded ) is { } encoded ? DecodeSamples( encoded ) : _samples;
+		init
+		{
+			_samples = Validate( value );
+			_encoded = null;
+		}
 	}
 
+	/// <summary>
+	/// The encoded samples this block was loaded with, if they haven't been decoded yet.
+	/// </summary>
+	internal byte[]? EncodedSamples => Volatile.Read( ref _encoded )?.Data;
+
 	public T GetValue( MovieTime time ) =>
 		Samples.Sample( time.Clamp( TimeRange ) - TimeRange.Start + Offset, SampleRate, _interpolator );
 
@@ -102,7 +126,21 @@ public sealed partial record CompiledSampleBlock<T>( MovieTimeRange TimeRange, M
 		return samples;
 	}
 
+	private ImmutableArray<T> DecodeSamples( EncodedSamples<T> encoded )
+	{
+		// Two threads might both decode, but they'll get the same values
+
+		var samples = Validate( encoded.Decode() );
+
+		_samples = samples;
+		Volatile.Write( ref _encoded, null );
+
+		return samples;
+	}
+
 #pragma warning disable SB3000
+	private static readonly ImmutableArray<T> _pending = [default!];
+
 	private static readonly IInterpolator<T>? _interpolator = Interpolator.GetDefault<T>();
 #pragma warning restore SB3000
 }
@@ -0,0 +1,94 @@
+﻿namespace Sandbox.MovieMaker.Compiled;
+
+#nullable enable
+
+/// <summary>
+/// Applies a <see cref="MovieClip"/> to a scene through a <see cref="TrackBinder"/>, like
+/// <see cref="ClipExtensions.Update(IMovieClip,MovieTime,TrackBinder?)"/>, but built for playing the
+/// same clip every frame. The target and a block cursor for each property track are kept between updates,
+/// and each update samples every track into a value table before applying any of them.
+/// </summary>
+public sealed class MovieClipEvaluator
+{
+	/// <summary>
+	/// The clip being played.
+	/// </summary>
+	public MovieClip Clip { get; }
+
+	/// <summary>
+	/// Maps the clip's tracks to targets in the scene.
+	/// </summary>
+	public TrackBinder Binder { get; }
+
+	private readonly Channel[] _channels;
+
+	public MovieClipEvaluator( MovieClip clip, TrackBinder binder )
+	{
+		Clip = clip;
+		Binder = binder;
+
+		_channels = clip.Tracks
+			.OfType<ICompiledPropertyTrack>()
+			.Select( x => (Channel)Activator.CreateInstance( typeof( Channel<> ).MakeGenericType( x.TargetType ), x, binder.Get( x ) )! )
+			.ToArray();
+	}
+
+	/// <summary>
+	/// For each track that we have a mapped property for, set the property value to whatever value
+	/// is stored in that track at the given <paramref name="time"/>.
+	/// </summary>
+	public bool Update( MovieTime time )
+	{
+		foreach ( var channel in _channels )
+		{
+			channel.Sample( time );
+		}
+
+		var anyChanges = false;
+
+		foreach ( var channel in _channels )
+		{
+			anyChanges |= channel.Apply();
+		}
+
+		return anyChanges;
+	}
+
+	/// <summary>
+	/// One row of the value table: a property track, its target, and the value sampled for it this update.
+	/// </summary>
+	private abstract class Channel
+	{
+		public abstract void Sample( MovieTime time );
+		public abstract bool Apply();
+	}
+
+	private sealed class Channel<T>( CompiledPropertyTrack<T> track, ITrackProperty target ) : Channel
+	{
+		private readonly ITrackProperty<T> _target = (ITrackProperty<T>)target;
+
+		private int _cursor;
+		private bool _hasValue;
+		private T? _value;
+
+		public override void Sample( MovieTime time )
+		{
+			_hasValue = false;
+
+			if ( !_target.IsBound || !_target.CanWrite ) return;
+			if ( track.GetBlock( time, ref _cursor ) is not { } block ) return;
+
+			_value = block.GetValue( time );
+			_hasValue = true;
+		}
+
+		public override bool Apply()
+		{
+			if ( !_hasValue ) return false;
+
+			_target.Value = _value!;
+
+			return true;
+		}
+	}
+}
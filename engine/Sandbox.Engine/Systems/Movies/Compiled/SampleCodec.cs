@@ -0,0 +1,210 @@
+﻿using System.Buffers;
+using System.Buffers.Binary;
+using System.Collections.Immutable;
+using System.IO;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using K4os.Compression.LZ4;
+
+namespace Sandbox.MovieMaker.Compiled;
+
+#nullable enable
+
+/// <summary>
+/// Packs the samples of a <see cref="CompiledSampleBlock{T}"/> into a compact binary blob. Each sample is split into
+/// channels, 4 byte words or single bytes for odd sized types, and each channel is delta encoded against the previous
+/// sample. The bytes of the deltas are then grouped by significance and LZ4 compressed. Recorded values change
+/// smoothly, so the high bytes of the deltas are mostly zero and compress away. Nothing is lost.
+/// </summary>
+internal static class SampleCodec
+{
+	/// <summary>
+	/// First byte of every blob, so the format can change later.
+	/// </summary>
+	public const byte Version = 1;
+
+	// Version, sample count, sample size, uncompressed size
+	private const int HeaderSize = 1 + 4 + 4 + 4;
+
+	public static byte[] Encode<T>( ReadOnlySpan<T> samples )
+		where T : unmanaged
+	{
+		var stride = Unsafe.SizeOf<T>();
+		var length = samples.Length * stride;
+		var shuffled = ArrayPool<byte>.Shared.Rent( length );
+
+		try
+		{
+			Shuffle( MemoryMarshal.AsBytes( samples ), shuffled.AsSpan( 0, length ), samples.Length, stride );
+
+			var blob = new byte[HeaderSize + LZ4Codec.MaximumOutputSize( length )];
+
+			blob[0] = Version;
+			BinaryPrimitives.WriteInt32LittleEndian( blob.AsSpan( 1 ), samples.Length );
+			BinaryPrimitives.WriteInt32LittleEndian( blob.AsSpan( 5 ), stride );
+			BinaryPrimitives.WriteInt32LittleEndian( blob.AsSpan( 9 ), length );
+
+			var compressed = length > 0
+				? LZ4Codec.Encode( shuffled.AsSpan( 0, length ), blob.AsSpan( HeaderSize ), LZ4Level.L12_MAX )
+				: 0;
+
+			if ( compressed < 0 )
+			{
+				throw new InvalidDataException( "LZ4 encode failed." );
+			}
+
+			Array.Resize( ref blob, HeaderSize + compressed );
+
+			return blob;
+		}
+		finally
+		{
+			ArrayPool<byte>.Shared.Return( shuffled );
+		}
+	}
+
+	public static ImmutableArray<T> Decode<T>( ReadOnlySpan<byte> blob )
+		where T : unmanaged
+	{
+		if ( blob.Length < HeaderSize || blob[0] != Version )
+		{
+			throw new InvalidDataException( "Unknown sample encoding." );
+		}
+
+		var count = BinaryPrimitives.ReadInt32LittleEndian( blob[1..] );
+		var stride = BinaryPrimitives.ReadInt32LittleEndian( blob[5..] );
+		var length = BinaryPrimitives.ReadInt32LittleEndian( blob[9..] );
+
+		if ( stride != Unsafe.SizeOf<T>() || count < 0 || length != (long)count * stride )
+		{
+			throw new InvalidDataException( $"Encoded samples don't match {typeof( T )}." );
+		}
+
+		var shuffled = ArrayPool<byte>.Shared.Rent( length );
+
+		try
+		{
+			if ( length > 0 && LZ4Codec.Decode( blob[HeaderSize..], shuffled.AsSpan( 0, length ) ) != length )
+			{
+				throw new InvalidDataException( "LZ4 decode failed." );
+			}
+
+			var samples = new T[count];
+
+			Unshuffle( shuffled.AsSpan( 0, length ), MemoryMarshal.AsBytes( samples.AsSpan() ), count, stride );
+
+			return ImmutableCollectionsMarshal.AsImmutableArray( samples );
+		}
+		finally
+		{
+			ArrayPool<byte>.Shared.Return( shuffled );
+		}
+	}
+
+	/// <summary>
+	/// Delta encode each channel, writing byte <c>b</c> of channel <c>c</c> for sample <c>i</c>
+	/// to <c>dst[(c * wordSize + b) * count + i]</c>.
+	/// </summary>
+	private static void Shuffle( ReadOnlySpan<byte> src, Span<byte> dst, int count, int stride )
+	{
+		if ( stride % 4 != 0 )
+		{
+			for ( var c = 0; c < stride; ++c )
+			{
+				var plane = dst.Slice( c * count, count );
+				byte prev = 0;
+
+				for ( var i = 0; i < count; ++i )
+				{
+					var value = src[i * stride + c];
+
+					plane[i] = (byte)(value - prev);
+					prev = value;
+				}
+			}
+
+			return;
+		}
+
+		for ( var c = 0; c < stride / 4; ++c )
+		{
+			var planes = dst.Slice( c * 4 * count, 4 * count );
+			var prev = 0u;
+
+			for ( var i = 0; i < count; ++i )
+			{
+				var value = BinaryPrimitives.ReadUInt32LittleEndian( src[(i * stride + c * 4)..] );
+				var delta = (int)(value - prev);
+				var zigzag = (uint)((delta << 1) ^ (delta >> 31));
+
+				planes[i] = (byte)zigzag;
+				planes[count + i] = (byte)(zigzag >> 8);
+				planes[2 * count + i] = (byte)(zigzag >> 16);
+				planes[3 * count + i] = (byte)(zigzag >> 24);
+
+				prev = value;
+			}
+		}
+	}
+
+	/// <summary>
+	/// Reverse of <see cref="Shuffle"/>.
+	/// </summary>
+	private static void Unshuffle( ReadOnlySpan<byte> src, Span<byte> dst, int count, int stride )
+	{
+		if ( stride % 4 != 0 )
+		{
+			for ( var c = 0; c < stride; ++c )
+			{
+				var plane = src.Slice( c * count, count );
+				byte value = 0;
+
+				for ( var i = 0; i < count; ++i )
+				{
+					value += plane[i];
+					dst[i * stride + c] = value;
+				}
+			}
+
+			return;
+		}
+
+		for ( var c = 0; c < stride / 4; ++c )
+		{
+			var planes = src.Slice( c * 4 * count, 4 * count );
+			var value = 0u;
+
+			for ( var i = 0; i < count; ++i )
+			{
+				var zigzag = planes[i]
+					| ((uint)planes[count + i] << 8)
+					| ((uint)planes[2 * count + i] << 16)
+					| ((uint)planes[3 * count + i] << 24);
+
+				value += (uint)((int)(zigzag >> 1) ^ -(int)(zigzag & 1));
+
+				BinaryPrimitives.WriteUInt32LittleEndian( dst[(i * stride + c * 4)..], value );
+			}
+		}
+	}
+}
+
+/// <summary>
+/// Samples read from a movie that haven't been decoded yet, see <see cref="CompiledSampleBlock{T}.Samples"/>.
+/// </summary>
+internal abstract class EncodedSamples<T>( byte[] data )
+{
+	/// <summary>
+	/// The blob from <see cref="SampleCodec.Encode{T}"/>, so unchanged samples can be saved again without
+	/// decoding them.
+	/// </summary>
+	public byte[] Data { get; } = data;
+
+	public abstract ImmutableArray<T> Decode();
+}
+
+internal sealed class EncodedUnmanagedSamples<T>( byte[] data ) : EncodedSamples<T>( data )
+	where T : unmanaged
+{
+	public override ImmutableArray<T> Decode() => SampleCodec.Decode<T>( Data );
+}
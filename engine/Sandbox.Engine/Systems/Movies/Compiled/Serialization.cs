@@ -237,19 +237,21 @@ file sealed class CompiledSampleBlockConverterFactory : JsonConverterFactory
 file sealed class CompressedSampleBlockConverter<T> : JsonConverter<CompiledSampleBlock<T>>
 	where T : unmanaged
 {
+	/// <param name="Encoding">
+	/// Zero if <paramref name="Samples"/> is a JSON array or a gzipped <see cref="ByteStream"/>, otherwise the
+	/// <see cref="SampleCodec.Version"/> it was written with.
+	/// </param>
 	private sealed record Model( MovieTimeRange TimeRange,
 		[property: JsonIgnore( Condition = JsonIgnoreCondition.WhenWritingDefault )] MovieTime Offset,
-		int SampleRate, JsonNode Samples );
+		int SampleRate, JsonNode Samples,
+		[property: JsonIgnore( Condition = JsonIgnoreCondition.WhenWritingDefault )] int Encoding = 0 );
 
 	public override void Write( Utf8JsonWriter writer, CompiledSampleBlock<T> value, JsonSerializerOptions options )
 	{
-		var stream = ByteStream.Create( 16 * value.Samples.Length + 4 );
+		// Blocks that were loaded but never played can be written back out as they are
 
-		stream.WriteArray( value.Samples.AsSpan() );
-
-		var compressed = stream.Compress();
-		var base64 = Convert.ToBase64String( compressed.ToArray() );
-		var model = new Model( value.TimeRange, value.Offset, value.SampleRate, base64 );
+		var encoded = value.EncodedSamples ?? SampleCodec.Encode( value.Samples.AsSpan() );
+		var model = new Model( value.TimeRange, value.Offset, value.SampleRate, Convert.ToBase64String( encoded ), SampleCodec.Version );
 
 		JsonSerializer.Serialize( writer, model, options );
 	}
@@ -258,6 +260,19 @@ file sealed class CompressedSampleBlockConverter<T> : JsonConverter<CompiledSamp
 	{
 		var model = JsonSerializer.Deserialize<Model>( ref reader, options )!;
 
+		if ( model.Encoding == SampleCodec.Version && model.Samples.GetValue<string>() is { } encoded )
+		{
+			// Decoded the first time something reads the samples
+
+			return new CompiledSampleBlock<T>( model.TimeRange, model.Offset, model.SampleRate,
+				new EncodedUnmanagedSamples<T>( Convert.FromBase64String( encoded ) ) );
+		}
+
+		if ( model.Encoding != 0 )
+		{
+			throw new Exception( $"Unknown sample encoding {model.Encoding}." );
+		}
+
 		ImmutableArray<T> samples;
 
 		if ( model.Samples is JsonArray sampleArray )
@@ -71,21 +71,76 @@ public sealed record CompiledPropertyTrack<T>( string Name, ICompiledTrack Paren
 
 	public ICompiledPropertyBlock<T>? GetBlock( MovieTime time )
 	{
-		// TODO: binary search?
+		return GetBlockAt( FindBlockIndex( time ), time );
+	}
+
+	/// <summary>
+	/// Same as <see cref="GetBlock(MovieTime)"/>, but starts looking from the block found last time, stored in
+	/// <paramref name="cursor"/>. Playing forwards only ever needs to step to the next block, anything else
+	/// falls back to a binary search. Each playback position should keep its own cursor, starting at <c>0</c>.
+	/// </summary>
+	public ICompiledPropertyBlock<T>? GetBlock( MovieTime time, ref int cursor )
+	{
+		var blocks = Blocks;
+		var index = cursor;
 
-		// We go backwards because if we're exactly on a block boundary, we want to use the later block
+		if ( (uint)index < (uint)blocks.Length && blocks[index].TimeRange.Start <= time )
+		{
+			// Still in the same block, or moved on to the next one
+
+			if ( index + 1 < blocks.Length && blocks[index + 1].TimeRange.Start <= time )
+			{
+				++index;
 
-		for ( var i = Blocks.Length - 1; i >= 0; --i )
+				if ( index + 1 < blocks.Length && blocks[index + 1].TimeRange.Start <= time )
+				{
+					index = FindBlockIndex( time );
+				}
+			}
+		}
+		else
 		{
-			var block = Blocks[i];
+			index = FindBlockIndex( time );
+		}
+
+		cursor = index;
+
+		return GetBlockAt( index, time );
+	}
 
-			if ( block.TimeRange.Start > time ) continue;
-			if ( block.TimeRange.End < time ) break;
+	/// <summary>
+	/// Index of the last block starting at or before <paramref name="time"/>, or <c>-1</c> if there isn't one.
+	/// If we're exactly on a block boundary, this is the later block.
+	/// </summary>
+	private int FindBlockIndex( MovieTime time )
+	{
+		var blocks = Blocks;
+		int lo = 0, hi = blocks.Length - 1;
+
+		while ( lo <= hi )
+		{
+			var mid = lo + ((hi - lo) >> 1);
 
-			return block;
+			if ( blocks[mid].TimeRange.Start <= time )
+			{
+				lo = mid + 1;
+			}
+			else
+			{
+				hi = mid - 1;
+			}
 		}
 
-		return default;
+		return hi;
+	}
+
+	private ICompiledPropertyBlock<T>? GetBlockAt( int index, MovieTime time )
+	{
+		if ( index < 0 ) return default;
+
+		var block = Blocks[index];
+
+		return block.TimeRange.End < time ? default : block;
 	}
 
 	public bool TryGetValue( MovieTime time, [MaybeNullWhen( false )] out T value )
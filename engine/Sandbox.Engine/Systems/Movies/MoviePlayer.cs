@@ -1,5 +1,6 @@
 ﻿using System.Diagnostics;
 using System.Text.Json.Serialization;
+using Sandbox.MovieMaker.Compiled;
 
 namespace Sandbox.MovieMaker;
 
@@ -17,6 +18,7 @@ public sealed class MoviePlayer : Component
 	private IMovieResource? _source;
 	private IMovieClip? _clip;
 	private TrackBinder? _binder;
+	private MovieClipEvaluator? _evaluator;
 
 	/// <summary>
 	/// Maps <see cref="ITrack"/>s to game objects, components, and property <see cref="ITrackTarget"/>s in the scene.
@@ -114,7 +116,21 @@ public sealed class MoviePlayer : Component
 
 		if ( Clip is not { } clip ) return;
 
-		clip.Update( _position, Binder );
+		if ( clip is MovieClip compiled )
+		{
+			// Compiled clips are immutable, so we can keep track cursors and targets between updates
+
+			if ( _evaluator?.Clip != compiled )
+			{
+				_evaluator = new MovieClipEvaluator( compiled, Binder );
+			}
+
+			_evaluator.Update( _position );
+		}
+		else
+		{
+			clip.Update( _position, Binder );
+		}
 
 		if ( IsPlaying )
 		{
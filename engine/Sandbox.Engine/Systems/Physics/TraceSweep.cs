@@ -0,0 +1,10 @@
+﻿namespace Sandbox;
+
+/// <summary>
+/// One sweep in a batch of traces, see <see cref="PhysicsTraceBuilder.RunBatch"/> and <see cref="SceneTrace.RunBatch"/>.
+/// Everything other than the start, end and radius comes from the trace that runs the batch.
+/// </summary>
+/// <param name="From">Where to start the sweep</param>
+/// <param name="To">Where to end the sweep</param>
+/// <param name="Radius">If above zero, sweep a sphere of this radius. Otherwise the trace's own shape is used.</param>
+public record struct TraceSweep( Vector3 From, Vector3 To, float Radius = 0 );
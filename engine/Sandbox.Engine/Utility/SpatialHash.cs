@@ -0,0 +1,276 @@
+namespace Sandbox.Utility;
+
+/// <summary>
+/// Points sorted into a grid of cubic cells, so finding everything near a position only has to look at the cells
+/// around it. Items are added with a position and referred to by the handle they're given, and the positions
+/// are kept in here so queries never have to touch the items themselves.
+/// </summary>
+/// <remarks>
+/// Queries only read, so any number of threads can run them at once as long as nothing is being added, removed or moved.
+/// </remarks>
+internal sealed class SpatialHash<T> where T : class
+{
+	readonly float _cellSize;
+	readonly float _invCellSize;
+
+	readonly Dictionary<long, List<int>> _cells = new();
+
+	T[] _items = [];
+	Vector3[] _positions = [];
+	long[] _itemCells = [];
+	int[] _itemSlots = [];
+
+	readonly Stack<int> _free = new();
+	int _capacity;
+	int _count;
+
+	public SpatialHash( float cellSize )
+	{
+		_cellSize = cellSize;
+		_invCellSize = 1.0f / cellSize;
+	}
+
+	/// <summary>
+	/// Size of each cell along each axis.
+	/// </summary>
+	public float CellSize => _cellSize;
+
+	/// <summary>
+	/// Number of items in the hash.
+	/// </summary>
+	public int Count => _count;
+
+	/// <summary>
+	/// Number of cells with anything in them.
+	/// </summary>
+	public int CellCount => _cells.Count;
+
+	/// <summary>
+	/// The item with this handle.
+	/// </summary>
+	public T this[int handle] => _items[handle];
+
+	/// <summary>
+	/// Replace the item with this handle, keeping its position.
+	/// </summary>
+	public void Set( int handle, T item ) => _items[handle] = item;
+
+	/// <summary>
+	/// The position of the item with this handle.
+	/// </summary>
+	public Vector3 GetPosition( int handle ) => _positions[handle];
+
+	/// <summary>
+	/// Add an item at a position, returning the handle used to move or remove it.
+	/// </summary>
+	public int Add( T item, Vector3 position )
+	{
+		if ( !_free.TryPop( out var handle ) )
+		{
+			handle = _capacity++;
+
+			if ( handle >= _items.Length )
+			{
+				var capacity = Math.Max( 256, _items.Length * 2 );
+
+				Array.Resize( ref _items, capacity );
+				Array.Resize( ref _positions, capacity );
+				Array.Resize( ref _itemCells, capacity );
+				Array.Resize( ref _itemSlots, capacity );
+			}
+		}
+
+		_items[handle] = item;
+		_positions[handle] = position;
+
+		Insert( handle, GetCell( position ) );
+
+		_count++;
+		return handle;
+	}
+
+	/// <summary>
+	/// Remove the item with this handle. The handle could be given to something else after this.
+	/// </summary>
+	public void Remove( int handle )
+	{
+		Erase( handle );
+
+		_items[handle] = null;
+		_free.Push( handle );
+		_count--;
+	}
+
+	/// <summary>
+	/// Move the item with this handle to a new position.
+	/// </summary>
+	public void Move( int handle, Vector3 position )
+	{
+		_positions[handle] = position;
+
+		var cell = GetCell( position );
+		if ( cell == _itemCells[handle] )
+			return;
+
+		Erase( handle );
+		Insert( handle, cell );
+	}
+
+	/// <summary>
+	/// Remove everything.
+	/// </summary>
+	public void Clear()
+	{
+		_cells.Clear();
+		_free.Clear();
+
+		Array.Clear( _items, 0, _capacity );
+
+		_capacity = 0;
+		_count = 0;
+	}
+
+	/// <summary>
+	/// Add the handle of every item inside <paramref name="sphere"/> to <paramref name="results"/>.
+	/// </summary>
+	public void FindInSphere( in Sphere sphere, List<int> results )
+	{
+		var center = sphere.Center;
+		var radiusSquared = sphere.Radius * sphere.Radius;
+		var box = new BBox( center - sphere.Radius, center + sphere.Radius );
+
+		var query = new SphereQuery( center, radiusSquared, _positions, results );
+		Query( box, ref query );
+	}
+
+	/// <summary>
+	/// Add the handle of every item inside <paramref name="box"/> to <paramref name="results"/>.
+	/// </summary>
+	public void FindInBox( in BBox box, List<int> results )
+	{
+		var query = new BoxQuery( box, _positions, results );
+		Query( box, ref query );
+	}
+
+	interface ICellQuery
+	{
+		void Visit( List<int> cell );
+	}
+
+	struct SphereQuery( Vector3 center, float radiusSquared, Vector3[] positions, List<int> results ) : ICellQuery
+	{
+		public readonly void Visit( List<int> cell )
+		{
+			for ( int i = 0; i < cell.Count; i++ )
+			{
+				var handle = cell[i];
+
+				if ( positions[handle].DistanceSquared( center ) <= radiusSquared )
+				{
+					results.Add( handle );
+				}
+			}
+		}
+	}
+
+	struct BoxQuery( BBox box, Vector3[] positions, List<int> results ) : ICellQuery
+	{
+		public readonly void Visit( List<int> cell )
+		{
+			for ( int i = 0; i < cell.Count; i++ )
+			{
+				var handle = cell[i];
+
+				if ( box.Contains( positions[handle] ) )
+				{
+					results.Add( handle );
+				}
+			}
+		}
+	}
+
+	/// <summary>
+	/// Visit every cell overlapping <paramref name="box"/>. If that's more cells than we've got in total, visit
+	/// every cell we've got instead.
+	/// </summary>
+	void Query<TQuery>( in BBox box, ref TQuery query ) where TQuery : struct, ICellQuery
+	{
+		if ( _count == 0 )
+			return;
+
+		var min = GetCellCoords( box.Mins );
+		var max = GetCellCoords( box.Maxs );
+
+		var span = (long)(max.x - min.x + 1) * (max.y - min.y + 1) * (max.z - min.z + 1);
+
+		if ( span > _cells.Count )
+		{
+			foreach ( var cell in _cells.Values )
+			{
+				query.Visit( cell );
+			}
+
+			return;
+		}
+
+		for ( int x = min.x; x <= max.x; x++ )
+		for ( int y = min.y; y <= max.y; y++ )
+		for ( int z = min.z; z <= max.z; z++ )
+		{
+			if ( _cells.TryGetValue( PackCell( x, y, z ), out var cell ) )
+			{
+				query.Visit( cell );
+			}
+		}
+	}
+
+	void Insert( int handle, long key )
+	{
+		if ( !_cells.TryGetValue( key, out var cell ) )
+		{
+			cell = new List<int>();
+			_cells[key] = cell;
+		}
+
+		_itemCells[handle] = key;
+		_itemSlots[handle] = cell.Count;
+		cell.Add( handle );
+	}
+
+	void Erase( int handle )
+	{
+		var key = _itemCells[handle];
+		var cell = _cells[key];
+		var slot = _itemSlots[handle];
+
+		// Swap the last one in to fill the gap
+		var last = cell[^1];
+		cell[slot] = last;
+		_itemSlots[last] = slot;
+		cell.RemoveAt( cell.Count - 1 );
+
+		if ( cell.Count == 0 )
+		{
+			_cells.Remove( key );
+		}
+	}
+
+	(int x, int y, int z) GetCellCoords( Vector3 position )
+	{
+		return ((int)MathF.Floor( position.x * _invCellSize ), (int)MathF.Floor( position.y * _invCellSize ), (int)MathF.Floor( position.z * _invCellSize ));
+	}
+
+	long GetCell( Vector3 position )
+	{
+		var (x, y, z) = GetCellCoords( position );
+		return PackCell( x, y, z );
+	}
+
+	/// <summary>
+	/// 21 bits per axis, which with any sensible cell size is far bigger than a map.
+	/// </summary>
+	static long PackCell( int x, int y, int z )
+	{
+		return ((long)(x & 0x1FFFFF) << 42) | ((long)(y & 0x1FFFFF) << 21) | (long)(z & 0x1FFFFF);
+	}
+}
@@ -692,7 +692,8 @@ internal partial class GameInstanceDll : Engine.IGameInstanceDll
 		// Load all the GameResources and fonts in the package
 		if ( package.FileSystem is not null )
 		{
-			ResourceLoader.LoadAllGameResource( package.FileSystem );
+			// Downloaded packages know every file they have, local ones need to look
+			ResourceLoader.LoadAllGameResource( package.FileSystem, package.PackageFileSystem?.FindCompiledResources() );
 			FontManager.Instance.LoadAll( package.FileSystem );
 		}
 	}
@@ -771,6 +772,8 @@ internal partial class GameInstanceDll : Engine.IGameInstanceDll
 		Api.Performance.CollectStat( "ComponentsDestroyed", SceneMetrics.ComponentsDestroyed );
 		Api.Performance.CollectStat( "RayTrace", SceneMetrics.RayTrace );
 		Api.Performance.CollectStat( "RayTraceAll", SceneMetrics.RayTraceAll );
+		Api.Performance.CollectStat( "PreRenderComponents", SceneMetrics.PreRenderComponents );
+		Api.Performance.CollectStat( "PreRenderDirtyComponents", SceneMetrics.PreRenderDirtyComponents );
 
 		SceneMetrics.Flip();
 	}
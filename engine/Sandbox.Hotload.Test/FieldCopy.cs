@@ -0,0 +1,74 @@
+extern alias After;
+extern alias Before;
+
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+using System;
+using System.Diagnostics;
+
+namespace Hotload
+{
+	/// <summary>
+	/// Types with lots of instances get compiled field accessors instead of copying with reflection,
+	/// make sure both paths copy the same values.
+	/// </summary>
+	[TestClass]
+	public class FieldCopyTests : HotloadTests
+	{
+		private static void FieldCopy( int count )
+		{
+			Before::TestClass50.Instances = new Before::TestClass50[count];
+
+			for ( var i = 0; i < count; ++i )
+			{
+				Before::TestClass50.Instances[i] = new Before::TestClass50( i )
+				{
+					IntProperty = i * 2,
+					StringField = i % 2 == 0 ? $"Instance {i}" : null,
+					StructField = new Before::TestClass50.ExampleStruct { Value = i * 3 },
+					Next = i > 0 ? Before::TestClass50.Instances[i / 2] : null
+				};
+			}
+
+			Assert.IsNull( After::TestClass50.Instances );
+
+			var timer = Stopwatch.StartNew();
+			var result = Hotload();
+
+			Console.WriteLine( $"Copied {count} instances in {timer.Elapsed.TotalMilliseconds:F2}ms ({result.ProcessingTime:F2}ms processing)" );
+
+			Assert.IsNotNull( After::TestClass50.Instances );
+			Assert.AreEqual( count, After::TestClass50.Instances.Length );
+
+			for ( var i = 0; i < count; ++i )
+			{
+				var instance = After::TestClass50.Instances[i];
+
+				Assert.AreEqual( i, instance.ReadOnlyField );
+				Assert.AreEqual( i * 2, instance.IntProperty );
+				Assert.AreEqual( i % 2 == 0 ? $"Instance {i}" : null, instance.StringField );
+				Assert.AreEqual( i * 3, instance.StructField.Value );
+				Assert.AreEqual( 0, instance.StructField.Added );
+				Assert.AreEqual( 86, instance.AddedField );
+				Assert.AreSame( i > 0 ? After::TestClass50.Instances[i / 2] : null, instance.Next );
+			}
+		}
+
+		/// <summary>
+		/// Few enough instances that we only ever use reflection.
+		/// </summary>
+		[TestMethod]
+		public void FieldCopyReflection()
+		{
+			FieldCopy( 16 );
+		}
+
+		/// <summary>
+		/// Enough instances that most are copied with compiled accessors, also acts as a benchmark.
+		/// </summary>
+		[TestMethod]
+		public void FieldCopyCompiled()
+		{
+			FieldCopy( 100_000 );
+		}
+	}
+}
@@ -99,6 +99,22 @@ namespace Hotload
 				}
 			}
 
+			Console.WriteLine( "Static Field Scan Thread Timings:" );
+			foreach ( var pair in result.StaticFieldScanThreadTimings )
+			{
+				Console.WriteLine( $"  {pair.Key}:" );
+				Console.WriteLine( $"    Fields = {pair.Value.Instances}" );
+				Console.WriteLine( $"    TimeSpan = {pair.Value.Milliseconds:F2}ms" );
+			}
+
+			Console.WriteLine( "Parallel Walk Thread Timings:" );
+			foreach ( var pair in result.ParallelWalkThreadTimings )
+			{
+				Console.WriteLine( $"  {pair.Key}:" );
+				Console.WriteLine( $"    Instances = {pair.Value.Instances}" );
+				Console.WriteLine( $"    TimeSpan = {pair.Value.Milliseconds:F2}ms" );
+			}
+
 			if ( !allowErrors )
 			{
 				Assert.IsFalse( result.HasErrors );
@@ -0,0 +1,121 @@
+extern alias After;
+extern alias Before;
+
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+using System;
+using System.Collections.Generic;
+using System.Linq;
+
+namespace Hotload
+{
+	/// <summary>
+	/// Lots of instances from a non-swapped assembly, a few of which reference swapped instances. The parallel walk
+	/// should leave the non-swapped graph alone and only replace the swapped references, the same as the upgraders would.
+	/// </summary>
+	[TestClass]
+	public class ParallelWalkTests : HotloadTests
+	{
+		public class Node
+		{
+			public string Name;
+			public Node Next;
+			public object Value;
+			public List<object> Items = new();
+			public (Node Node, object Value) Pair;
+		}
+
+		[Reset]
+		public static Node[] Nodes;
+
+		private static Node[] CreateNodes( int count )
+		{
+			Nodes = new Node[count];
+
+			for ( var i = 0; i < count; ++i )
+			{
+				var node = Nodes[i] = new Node
+				{
+					Name = $"Node {i}",
+					Next = i > 0 ? Nodes[i - 1] : null,
+					Value = i % 10 == 0 ? new Before::TestClass1 { IntField = i } : null
+				};
+
+				node.Items.Add( Nodes[i / 2] );
+				node.Items.Add( Nodes[i / 3].Value );
+				node.Pair = (Nodes[i / 4], Nodes[i / 5].Value);
+			}
+
+			return Nodes.ToArray();
+		}
+
+		private static void AssertUpgraded( Node[] nodes )
+		{
+			Assert.AreEqual( nodes.Length, Nodes.Length );
+
+			for ( var i = 0; i < nodes.Length; ++i )
+			{
+				var node = Nodes[i];
+
+				Assert.AreSame( nodes[i], node );
+				Assert.AreEqual( $"Node {i}", node.Name );
+				Assert.AreSame( i > 0 ? nodes[i - 1] : null, node.Next );
+
+				if ( i % 10 == 0 )
+				{
+					Assert.IsInstanceOfType( node.Value, typeof( After::TestClass1 ) );
+					Assert.AreEqual( i, ((After::TestClass1)node.Value).IntField );
+				}
+				else
+				{
+					Assert.IsNull( node.Value );
+				}
+
+				Assert.AreEqual( 2, node.Items.Count );
+				Assert.AreSame( nodes[i / 2], node.Items[0] );
+				Assert.AreSame( Nodes[i / 3].Value, node.Items[1] );
+				Assert.AreSame( nodes[i / 4], node.Pair.Node );
+				Assert.AreSame( Nodes[i / 5].Value, node.Pair.Value );
+			}
+		}
+
+		[TestMethod]
+		public void ParallelWalk()
+		{
+			var nodes = CreateNodes( 10_000 );
+			var result = Hotload();
+
+			AssertUpgraded( nodes );
+
+			Assert.AreNotEqual( 0, result.ParallelWalkThreadTimings.Count );
+			Assert.IsTrue( result.ParallelWalkThreadTimings.Values.Sum( x => x.Instances ) >= nodes.Length );
+		}
+
+		[TestMethod]
+		public void SerialWalk()
+		{
+			var nodes = CreateNodes( 10_000 );
+
+			var hotload = CreateHotload();
+			hotload.ParallelWalk = false;
+
+			var result = hotload.UpdateReferences();
+
+			Assert.IsFalse( result.HasErrors );
+			Assert.AreEqual( 0, result.ParallelWalkThreadTimings.Count );
+
+			AssertUpgraded( nodes );
+		}
+
+		[TestMethod]
+		public void StaticFieldScan()
+		{
+			CreateNodes( 100 );
+
+			var result = Hotload();
+
+			// The swapped assembly always gets scanned
+			Assert.AreNotEqual( 0, result.StaticFieldScanThreadTimings.Count );
+			Assert.AreNotEqual( 0, result.StaticFieldScanThreadTimings.Values.Sum( x => x.Instances ) );
+		}
+	}
+}
@@ -0,0 +1,580 @@
+﻿using System;
+using System.Collections;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Reflection;
+using System.Threading;
+using System.Threading.Tasks;
+using Sandbox.Upgraders;
+using Sandbox.Upgraders.SpecialCases;
+
+namespace Sandbox
+{
+	public partial class Hotload
+	{
+		/// <summary>
+		/// How the parallel walk treats instances of a type.
+		/// </summary>
+		private enum WalkKind
+		{
+			/// <summary>
+			/// Upgrading doesn't change it or look inside it.
+			/// </summary>
+			Skip,
+
+			/// <summary>
+			/// Upgraded in place by <see cref="DefaultUpgrader"/>, field by field.
+			/// </summary>
+			Fields,
+
+			/// <summary>
+			/// Upgraded in place by <see cref="ArrayUpgrader"/>, element by element.
+			/// </summary>
+			Array,
+
+			/// <summary>
+			/// Upgraded in place by <see cref="ListUpgrader"/>, item by item.
+			/// </summary>
+			List,
+
+			/// <summary>
+			/// Has to go through the upgraders on the hotloading thread.
+			/// </summary>
+			Upgrade
+		}
+
+		private enum WalkResult
+		{
+			Same,
+			Fixup,
+			Unknown
+		}
+
+		private sealed class WalkType
+		{
+			public WalkKind Kind = WalkKind.Upgrade;
+			public FieldInfo[] Fields;
+			public FieldInfo ListItems;
+			public FieldInfo ListSize;
+		}
+
+		/// <summary>
+		/// A reference found by the parallel walk that the upgraders need to replace: a field of <see cref="Holder"/>,
+		/// or an element of it if <see cref="Field"/> is null.
+		/// </summary>
+		private readonly record struct WalkFixup( object Holder, FieldInfo Field, int Index );
+
+		/// <summary>
+		/// State owned by one worker thread during the parallel walk.
+		/// </summary>
+		private sealed class WalkWorker
+		{
+			public readonly Stack<object> Stack = new();
+			public readonly List<object> Children = new();
+			public readonly List<WalkFixup> Pending = new();
+			public readonly List<WalkFixup> Fixups = new();
+			public readonly List<object> Deferred = new();
+			public readonly HashSet<Type> UnknownTypes = new();
+			public readonly TimingEntry Timing = new();
+		}
+
+		/// <summary>
+		/// Once a worker has this many instances waiting, it shares half of them with idle workers.
+		/// </summary>
+		private const int WalkShareThreshold = 32;
+
+		/// <summary>
+		/// Only written on the hotloading thread, between waves of the parallel walk.
+		/// </summary>
+		private readonly Dictionary<Type, WalkType> WalkTypes = new();
+
+		/// <summary>
+		/// Instances the parallel walk has visited. The upgraders would have upgraded each of them in place,
+		/// so <see cref="GetNewInstance"/> returns them as they are.
+		/// </summary>
+		private ConcurrentDictionary<object, byte> WalkedInstances;
+
+		/// <summary>
+		/// Instances that <see cref="UpdateReferencesInType"/> upgrades into a different instance, which the walk has to leave alone.
+		/// </summary>
+		private HashSet<object> WalkReserved;
+
+		private List<WalkFixup> WalkFixups;
+
+		/// <summary>
+		/// Before any upgraders run, visit everything reachable from static fields and watched instances that would only
+		/// be upgraded in place, spread across worker threads. The walk only reads, and everything it needs to know about
+		/// a type is worked out on this thread between waves, so no upgrader state is touched off this thread.
+		/// References that need replacing are collected for <see cref="ApplyWalkFixups"/>.
+		/// </summary>
+		private void WalkInParallel( List<(Type Type, FieldInfo[] Fields)> watchedFields )
+		{
+			WalkedInstances = new ConcurrentDictionary<object, byte>( ReferenceComparer.Singleton );
+			WalkReserved = new HashSet<object>( ReferenceComparer.Singleton );
+			WalkFixups = new List<WalkFixup>();
+
+			var pending = new List<object>();
+
+			foreach ( var root in GetWalkRoots( watchedFields ) )
+			{
+				if ( WalkedInstances.TryAdd( root, 0 ) )
+				{
+					pending.Add( root );
+				}
+			}
+
+			var workers = new WalkWorker[Math.Max( 1, Environment.ProcessorCount )];
+
+			for ( var i = 0; i < workers.Length; ++i )
+			{
+				workers[i] = new WalkWorker();
+			}
+
+			try
+			{
+				while ( pending.Count > 0 )
+				{
+					RunWalkWave( pending, workers );
+					pending.Clear();
+
+					// Workers stop at types they haven't seen before, so work those out here and carry on
+
+					foreach ( var worker in workers )
+					{
+						foreach ( var type in worker.UnknownTypes )
+						{
+							GetWalkType( type );
+						}
+
+						pending.AddRange( worker.Deferred );
+
+						worker.UnknownTypes.Clear();
+						worker.Deferred.Clear();
+					}
+				}
+			}
+#if !HOTLOAD_NOCATCH
+			catch ( Exception e )
+			{
+				// Nothing has been changed yet, so the upgraders can still do everything
+
+				Log( e, $"Parallel object graph walk failed." );
+
+				WalkedInstances = null;
+				WalkFixups = null;
+
+				return;
+			}
+#endif
+
+			for ( var i = 0; i < workers.Length; ++i )
+			{
+				var worker = workers[i];
+
+				WalkFixups.AddRange( worker.Fixups );
+				CurrentResult.InstancesProcessed += worker.Timing.Instances;
+
+				if ( (IncludeTypeTimings || IncludeProcessorTimings) && worker.Timing.Instances > 0 )
+				{
+					CurrentResult.ParallelWalkThreadTimings[$"Worker {i}"] = worker.Timing;
+				}
+			}
+		}
+
+		/// <summary>
+		/// Values of static fields that <see cref="UpdateReferencesInType"/> upgrades in place, followed by watched instances.
+		/// </summary>
+		private IEnumerable<object> GetWalkRoots( List<(Type Type, FieldInfo[] Fields)> watchedFields )
+		{
+			foreach ( var (type, fields) in watchedFields )
+			{
+				var subType = GetNewType( type );
+
+				if ( subType == null ) continue;
+
+				foreach ( var staticField in fields )
+				{
+					var newField = GetNewStaticField( type, subType, staticField );
+
+					if ( newField == null ) continue;
+
+					object curVal;
+
+					try
+					{
+						curVal = staticField.GetValue( null );
+
+						if ( curVal is not null && newField.IsInitOnly )
+						{
+							var newVal = newField.GetValue( null );
+
+							if ( newVal is null ) continue;
+
+							if ( !ReferenceEquals( curVal, newVal ) )
+							{
+								WalkReserved.Add( curVal );
+								continue;
+							}
+						}
+					}
+					catch
+					{
+						// Leave the rest of this type to UpdateReferencesInType, which will log the error
+						break;
+					}
+
+					if ( curVal is null || curVal.GetType().IsValueType ) continue;
+					if ( GetWalkType( curVal.GetType() ).Kind is WalkKind.Skip or WalkKind.Upgrade ) continue;
+
+					yield return curVal;
+				}
+			}
+
+			foreach ( var instance in WatchedInstances )
+			{
+				// Still processed by UpdateReferences afterwards, but that's cheap once everything they reference is walked
+				if ( GetWalkType( instance.GetType() ).Kind != WalkKind.Fields ) continue;
+
+				yield return instance;
+			}
+		}
+
+		private void RunWalkWave( List<object> instances, WalkWorker[] workers )
+		{
+			var shared = new ConcurrentQueue<object>( instances );
+			var active = 0;
+
+			Parallel.For( 0, workers.Length, new ParallelOptions { MaxDegreeOfParallelism = workers.Length }, i =>
+			{
+				var worker = workers[i];
+				var timer = Stopwatch.StartNew();
+				var spinner = new SpinWait();
+
+				while ( true )
+				{
+					Interlocked.Increment( ref active );
+
+					if ( shared.TryDequeue( out var instance ) )
+					{
+						worker.Stack.Push( instance );
+
+						while ( worker.Stack.TryPop( out instance ) )
+						{
+							ExpandWalkedInstance( instance, worker );
+
+							if ( worker.Stack.Count >= WalkShareThreshold && shared.IsEmpty )
+							{
+								for ( var j = worker.Stack.Count / 2; j > 0; --j )
+								{
+									shared.Enqueue( worker.Stack.Pop() );
+								}
+							}
+						}
+
+						Interlocked.Decrement( ref active );
+						spinner.Reset();
+						continue;
+					}
+
+					// Only stop once nobody is holding work they might share
+
+					if ( Interlocked.Decrement( ref active ) == 0 && shared.IsEmpty ) break;
+
+					spinner.SpinOnce();
+				}
+
+				worker.Timing.Milliseconds += timer.Elapsed.TotalMilliseconds;
+			} );
+		}
+
+		private void ExpandWalkedInstance( object instance, WalkWorker worker )
+		{
+			var walkType = WalkTypes[instance.GetType()];
+			var unknown = false;
+
+			worker.Children.Clear();
+			worker.Pending.Clear();
+
+			switch ( walkType.Kind )
+			{
+				case WalkKind.Fields:
+					foreach ( var field in walkType.Fields )
+					{
+						ScanWalkedSlot( field.GetValue( instance ), instance, field, 0, worker, ref unknown );
+					}
+					break;
+
+				case WalkKind.Array:
+					ScanWalkedElements( (Array)instance, instance, ((Array)instance).Length, worker, ref unknown );
+					break;
+
+				case WalkKind.List:
+					var items = (Array)walkType.ListItems.GetValue( instance );
+					var size = Math.Min( (int)walkType.ListSize.GetValue( instance ), items?.Length ?? 0 );
+
+					ScanWalkedElements( items, instance, size, worker, ref unknown );
+					break;
+			}
+
+			if ( unknown )
+			{
+				// Try again once the hotloading thread knows about the new types
+				worker.Deferred.Add( instance );
+				return;
+			}
+
+			foreach ( var child in worker.Children )
+			{
+				if ( WalkedInstances.TryAdd( child, 0 ) )
+				{
+					worker.Stack.Push( child );
+				}
+			}
+
+			worker.Fixups.AddRange( worker.Pending );
+			worker.Timing.Instances++;
+		}
+
+		private void ScanWalkedElements( Array items, object holder, int count, WalkWorker worker, ref bool unknown )
+		{
+			if ( items is object[] objects )
+			{
+				for ( var i = 0; i < count; ++i )
+				{
+					ScanWalkedSlot( objects[i], holder, null, i, worker, ref unknown );
+				}
+
+				return;
+			}
+
+			for ( var i = 0; i < count; ++i )
+			{
+				ScanWalkedSlot( items.GetValue( i ), holder, null, i, worker, ref unknown );
+			}
+		}
+
+		private void ScanWalkedSlot( object value, object holder, FieldInfo field, int index, WalkWorker worker, ref bool unknown )
+		{
+			switch ( ScanWalkedValue( value, worker ) )
+			{
+				case WalkResult.Fixup:
+					worker.Pending.Add( new WalkFixup( holder, field, index ) );
+					break;
+
+				case WalkResult.Unknown:
+					unknown = true;
+					break;
+			}
+		}
+
+		private WalkResult ScanWalkedValue( object value, WalkWorker worker )
+		{
+			if ( value is null ) return WalkResult.Same;
+
+			var type = value.GetType();
+
+			if ( !WalkTypes.TryGetValue( type, out var walkType ) )
+			{
+				worker.UnknownTypes.Add( type );
+				return WalkResult.Unknown;
+			}
+
+			switch ( walkType.Kind )
+			{
+				case WalkKind.Skip:
+					return WalkResult.Same;
+
+				case WalkKind.Upgrade:
+					return WalkResult.Fixup;
+			}
+
+			if ( !type.IsValueType )
+			{
+				if ( WalkReserved.Count > 0 && WalkReserved.Contains( value ) ) return WalkResult.Fixup;
+
+				worker.Children.Add( value );
+				return WalkResult.Same;
+			}
+
+			// Structs get upgraded along with whatever holds them, so if anything inside needs replacing, so does the struct
+
+			var result = WalkResult.Same;
+
+			foreach ( var field in walkType.Fields )
+			{
+				var fieldResult = ScanWalkedValue( field.GetValue( value ), worker );
+
+				if ( fieldResult > result ) result = fieldResult;
+			}
+
+			return result;
+		}
+
+		/// <summary>
+		/// Work out how the parallel walk should treat instances of <paramref name="type"/>, matching what the upgraders
+		/// would do with one that's upgraded in place.
+		/// </summary>
+		private WalkType GetWalkType( Type type )
+		{
+			if ( WalkTypes.TryGetValue( type, out var walkType ) ) return walkType;
+
+			// Added before classifying, so types that contain themselves stop here
+			WalkTypes.Add( type, walkType = new WalkType() );
+
+			walkType.Kind = ClassifyWalkType( type, walkType );
+
+			// Classify any types we know we'll find in fields up front, so the walk needs fewer waves
+
+			if ( walkType.Fields != null )
+			{
+				foreach ( var field in walkType.Fields )
+				{
+					PrepareWalkType( field.FieldType );
+				}
+			}
+
+			if ( walkType.Kind == WalkKind.Array )
+			{
+				PrepareWalkType( type.GetElementType() );
+			}
+			else if ( walkType.Kind == WalkKind.List )
+			{
+				PrepareWalkType( type.GetGenericArguments()[0] );
+			}
+
+			return walkType;
+		}
+
+		private void PrepareWalkType( Type type )
+		{
+			type = Nullable.GetUnderlyingType( type ) ?? type;
+
+			if ( type.IsValueType || type.IsSealed )
+			{
+				GetWalkType( type );
+			}
+		}
+
+		private WalkKind ClassifyWalkType( Type type, WalkType walkType )
+		{
+			if ( type.IsPrimitive || type.IsPointer || type == typeof( string ) ) return WalkKind.Skip;
+
+			// Anything that gets replaced, or wants to hear about being persisted, needs the upgraders
+			if ( GetNewType( type ) != type ) return WalkKind.Upgrade;
+			if ( typeof( IHotloadManaged ).IsAssignableFrom( type ) ) return WalkKind.Upgrade;
+
+			IInstanceUpgrader upgrader = null;
+
+			foreach ( var candidate in RootUpgraderGroup.GetUpgradersForType( type ) )
+			{
+				if ( candidate is CachedUpgrader ) continue;
+
+				upgrader = candidate;
+				break;
+			}
+
+			switch ( upgrader )
+			{
+				case SkipUpgrader or AutoSkipUpgrader or PrimitiveUpgrader:
+					return WalkKind.Skip;
+
+				case DefaultUpgrader defaultUpgrader when upgrader.GetType() == typeof( DefaultUpgrader ):
+					walkType.Fields = defaultUpgrader.GetInPlaceFields( type );
+
+					if ( walkType.Fields == null ) return WalkKind.Upgrade;
+
+					return walkType.Fields.Length == 0 ? WalkKind.Skip : WalkKind.Fields;
+
+				case ArrayUpgrader arrayUpgrader when upgrader.GetType() == typeof( ArrayUpgrader ):
+				{
+					var elemType = type.GetElementType()!;
+
+					if ( arrayUpgrader.CanSkipType( elemType ) || arrayUpgrader.CanBlockCopy( elemType, elemType ) ) return WalkKind.Skip;
+
+					// Multi-dimensional arrays stay with ArrayUpgrader
+					return type.IsSZArray ? WalkKind.Array : WalkKind.Upgrade;
+				}
+
+				case ListUpgrader when upgrader.GetType() == typeof( ListUpgrader ):
+				{
+					var arrayUpgrader = GetUpgrader<ArrayUpgrader>();
+					var elemType = type.GetGenericArguments()[0];
+
+					if ( arrayUpgrader.CanSkipType( elemType ) || arrayUpgrader.CanBlockCopy( elemType, elemType ) ) return WalkKind.Skip;
+
+					walkType.ListItems = type.GetField( "_items", BindingFlags.Instance | BindingFlags.NonPublic );
+					walkType.ListSize = type.GetField( "_size", BindingFlags.Instance | BindingFlags.NonPublic );
+
+					return walkType.ListItems != null && walkType.ListSize != null ? WalkKind.List : WalkKind.Upgrade;
+				}
+
+				default:
+					return WalkKind.Upgrade;
+			}
+		}
+
+		/// <summary>
+		/// Replace the references the parallel walk found that need upgrading, the same way the upgrader for their holder would.
+		/// </summary>
+		private void ApplyWalkFixups()
+		{
+			if ( WalkFixups == null ) return;
+
+			foreach ( var (holder, field, index) in WalkFixups )
+			{
+				var member = field != null ? field : (MemberInfo)typeof( int );
+
+				if ( TracePaths )
+				{
+					CurrentPath = ReferencePath.GetRoot( holder.GetType() )[member];
+				}
+
+				CurrentSrcField = field;
+				CurrentDstField = field;
+
+				try
+				{
+					if ( field != null )
+					{
+						field.SetValue( holder, GetNewInstance( field.GetValue( holder ) ) );
+					}
+					else if ( holder is Array array )
+					{
+						array.SetValue( GetNewInstance( array.GetValue( index ) ), index );
+					}
+					else
+					{
+						var list = (IList)holder;
+						list[index] = GetNewInstance( list[index] );
+					}
+				}
+#if !HOTLOAD_NOCATCH
+				catch ( Exception e )
+				{
+					Log( e, member: member );
+				}
+#endif
+				finally
+				{
+					CurrentPath = null;
+					CurrentSrcField = null;
+					CurrentDstField = null;
+				}
+			}
+		}
+
+		private bool IsWalked( object instance )
+		{
+			return WalkedInstances != null && WalkedInstances.ContainsKey( instance );
+		}
+
+		private void ClearParallelWalk()
+		{
+			WalkTypes.Clear();
+			WalkedInstances = null;
+			WalkReserved = null;
+			WalkFixups = null;
+		}
+	}
+}
@@ -46,6 +46,12 @@ namespace Sandbox
 		/// </summary>
 		public bool TracePaths { get; set; }
 
+		/// <summary>
+		/// If true, instances that would only be upgraded in place are found on worker threads before any upgraders run,
+		/// so the upgraders only visit the parts of the object graph that change. Defaults to true.
+		/// </summary>
+		public bool ParallelWalk { get; set; } = true;
+
 		/// <summary>
 		/// If true, record per-type timing information.
 		/// </summary>
@@ -224,8 +224,22 @@ namespace Sandbox
 
 		public double WatchedInstanceTime { get; set; }
 
+		public double ParallelWalkTime { get; set; }
+
 		public double DiagnosticsTime { get; set; }
 
+		/// <summary>
+		/// Static fields found and time taken by each worker thread while scanning assemblies for static fields.
+		/// Only populated if <see cref="Hotload.IncludeTypeTimings"/> or <see cref="Hotload.IncludeProcessorTimings"/> is set to true.
+		/// </summary>
+		public Dictionary<string, TimingEntry> StaticFieldScanThreadTimings { get; set; } = new Dictionary<string, TimingEntry>();
+
+		/// <summary>
+		/// Instances visited and time taken by each worker during the parallel object graph walk, see <see cref="Hotload.ParallelWalk"/>.
+		/// Only populated if <see cref="Hotload.IncludeTypeTimings"/> or <see cref="Hotload.IncludeProcessorTimings"/> is set to true.
+		/// </summary>
+		public Dictionary<string, TimingEntry> ParallelWalkThreadTimings { get; set; } = new Dictionary<string, TimingEntry>();
+
 		/// <summary>
 		/// If true, no errors were emitted during the hotload.
 		/// </summary>
@@ -1,4 +1,5 @@
 using System;
+using System.Collections.Concurrent;
 using System.Collections.Generic;
 using System.Diagnostics;
 using System.Linq;
@@ -99,14 +100,26 @@ namespace Sandbox
 				var staticFieldStartTime = timer.Elapsed;
 				var watchedAssemblies = _watchedAssemblies.Keys
 					.Union( Swaps.Keys )
-					.Union( New.Where( x => !Swaps.ContainsValue( x ) ) );
+					.Union( New.Where( x => !Swaps.ContainsValue( x ) ) )
+					.ToArray();
 
-				foreach ( var (type, fields) in watchedAssemblies.SelectMany( GetWatchedFields ) )
+				var watchedFields = GetWatchedFields( watchedAssemblies );
+
+				if ( ParallelWalk )
+				{
+					var parallelWalkStartTime = timer.Elapsed;
+
+					WalkInParallel( watchedFields );
+
+					CurrentResult.ParallelWalkTime = (timer.Elapsed - parallelWalkStartTime).TotalMilliseconds;
+				}
+
+				foreach ( var (type, fields) in watchedFields )
 				{
 					UpdateReferencesInType( type, fields );
 				}
 
-				CurrentResult.StaticFieldTime = (timer.Elapsed - staticFieldStartTime).TotalMilliseconds;
+				CurrentResult.StaticFieldTime = (timer.Elapsed - staticFieldStartTime).TotalMilliseconds - CurrentResult.ParallelWalkTime;
 
 				var watchedInstanceStartTime = timer.Elapsed;
 
@@ -121,6 +134,7 @@ namespace Sandbox
 
 				var instanceQueueStartTime = timer.Elapsed;
 
+				ApplyWalkFixups();
 				ProcessInstanceQueue();
 
 				CurrentResult.InstanceQueueTime = (timer.Elapsed - instanceQueueStartTime).TotalMilliseconds;
@@ -137,6 +151,7 @@ namespace Sandbox
 				}
 
 				ClearFieldDefaults();
+				ClearParallelWalk();
 				DefaultInstanceTaskQueue.Clear();
 				LateInstanceTaskQueue.Clear();
 				SubstituteTypeCache.Clear();
@@ -288,79 +303,146 @@ namespace Sandbox
 				(a.Version?.Equals( b.Version ) ?? false);
 		}
 
-		private IEnumerable<(Type Type, FieldInfo[] Fields)> GetWatchedFields( Assembly asm )
+		/// <summary>
+		/// Find the static fields to process in each of the given assemblies, in the same order as <paramref name="assemblies"/>.
+		/// Reflecting over every type is the slow part, so assemblies that aren't in <see cref="StaticFieldCache"/> are scanned
+		/// in parallel. Watch filters and anything that needs to ask the upgraders about a type happen on this thread afterwards.
+		/// </summary>
+		private List<(Type Type, FieldInfo[] Fields)> GetWatchedFields( IReadOnlyList<Assembly> assemblies )
 		{
-			if ( Swaps.ContainsKey( asm ) )
+			var skipped = new bool[assemblies.Count];
+			var toScan = new List<(int Index, bool IsFromSwappedAsm)>();
+
+			for ( var i = 0; i < assemblies.Count; ++i )
 			{
-				return GetWatchedFieldsUncached( asm, true );
+				var asm = assemblies[i];
+
+				if ( Swaps.ContainsKey( asm ) )
+				{
+					toScan.Add( (i, true) );
+					continue;
+				}
+
+				if ( !New.Contains( asm ) && ReferencesSwappedAssembly( asm ) )
+				{
+					skipped[i] = true;
+					continue;
+				}
+
+				if ( !StaticFieldCache.ContainsKey( asm ) )
+				{
+					toScan.Add( (i, false) );
+				}
 			}
 
-			if ( !New.Contains( asm ) )
+			var scanned = new (Type Type, FieldInfo[] Fields)[assemblies.Count][];
+			var threadTimings = new ConcurrentDictionary<int, TimingEntry>();
+
+			Parallel.ForEach( toScan, item =>
 			{
-				var references = asm.GetReferencedAssemblies();
+				var sw = Stopwatch.StartNew();
+				var result = scanned[item.Index] = ScanStaticFields( assemblies[item.Index], item.IsFromSwappedAsm );
 
-				// For assemblies that aren't getting swapped, check for references to swapped assemblies.
+				var timing = threadTimings.GetOrAdd( Environment.CurrentManagedThreadId, _ => new TimingEntry() );
+				timing.Instances += result.Sum( x => x.Fields.Length );
+				timing.Milliseconds += sw.Elapsed.TotalMilliseconds;
+			} );
 
-				foreach ( var reference in references )
+			if ( IncludeTypeTimings || IncludeProcessorTimings )
+			{
+				foreach ( var (threadId, timing) in threadTimings.OrderBy( x => x.Key ) )
 				{
-					var matchingSwap = Swaps.SingleOrDefault( x => IsMatchingName( x.Key.GetName(), reference ) );
+					CurrentResult.StaticFieldScanThreadTimings[$"Thread {threadId}"] = timing;
+				}
+			}
 
-					if ( matchingSwap.Key == null )
-					{
-						continue;
-					}
+			var watched = new List<(Type Type, FieldInfo[] Fields)>();
 
-					if ( matchingSwap.Value != null && references.Any( x => IsMatchingName( x, matchingSwap.Value.GetName() ) ) )
-					{
-						// Both the old and new versions of a swapped assembly are referenced by asm.
-						// This will probably only happen in Sandbox.Hotload.Test, and it's intentional.
+			for ( var i = 0; i < assemblies.Count; ++i )
+			{
+				var asm = assemblies[i];
 
-						Log( HotloadEntryType.Information, $"Both old and new versions of an assembly are referenced by a non-swapped assembly. ({FormatAssemblyName( asm )} references {FormatAssemblyName( matchingSwap.Key )} and {FormatAssemblyName( matchingSwap.Value )})" );
-						continue;
-					}
+				if ( skipped[i] ) continue;
 
-					// A reference to an assembly that's getting swapped was found.
-					// This is technically a fault, but we'll let it slide with a message for now since tools relies on it.
+				if ( Swaps.ContainsKey( asm ) )
+				{
+					watched.AddRange( FilterWatchedFields( asm, scanned[i], true ) );
+					continue;
+				}
 
-					Log( HotloadEntryType.Information, $"Skipping static fields from a non-swapped assembly that references a swapped assembly. ({FormatAssemblyName( asm )} references {FormatAssemblyName( matchingSwap.Key )})" );
-					return Enumerable.Empty<(Type, FieldInfo[])>();
+				if ( !StaticFieldCache.TryGetValue( asm, out var cached ) )
+				{
+					cached = FilterWatchedFields( asm, scanned[i], false ).ToArray();
+					StaticFieldCache.Add( asm, cached );
 				}
+
+				watched.AddRange( cached );
 			}
 
-			if ( StaticFieldCache.TryGetValue( asm, out var cached ) )
+			return watched;
+		}
+
+		/// <summary>
+		/// For assemblies that aren't getting swapped, check for references to swapped assemblies.
+		/// </summary>
+		private bool ReferencesSwappedAssembly( Assembly asm )
+		{
+			var references = asm.GetReferencedAssemblies();
+
+			foreach ( var reference in references )
 			{
-				return cached;
-			}
+				var matchingSwap = Swaps.SingleOrDefault( x => IsMatchingName( x.Key.GetName(), reference ) );
+
+				if ( matchingSwap.Key == null )
+				{
+					continue;
+				}
+
+				if ( matchingSwap.Value != null && references.Any( x => IsMatchingName( x, matchingSwap.Value.GetName() ) ) )
+				{
+					// Both the old and new versions of a swapped assembly are referenced by asm.
+					// This will probably only happen in Sandbox.Hotload.Test, and it's intentional.
+
+					Log( HotloadEntryType.Information, $"Both old and new versions of an assembly are referenced by a non-swapped assembly. ({FormatAssemblyName( asm )} references {FormatAssemblyName( matchingSwap.Key )} and {FormatAssemblyName( matchingSwap.Value )})" );
+					continue;
+				}
 
-			cached = GetWatchedFieldsUncached( asm, false ).ToArray();
-			StaticFieldCache.Add( asm, cached );
+				// A reference to an assembly that's getting swapped was found.
+				// This is technically a fault, but we'll let it slide with a message for now since tools relies on it.
 
-			return cached;
+				Log( HotloadEntryType.Information, $"Skipping static fields from a non-swapped assembly that references a swapped assembly. ({FormatAssemblyName( asm )} references {FormatAssemblyName( matchingSwap.Key )})" );
+				return true;
+			}
+
+			return false;
 		}
 
-		private IEnumerable<(Type Type, FieldInfo[] Fields)> GetWatchedFieldsUncached( Assembly asm, bool isFromSwappedAsm )
+		/// <summary>
+		/// Find candidate static fields in every type of an assembly. This only uses reflection, and doesn't touch
+		/// any hotload state that changes during a hotload, so it's safe to call from worker threads. Watch filters
+		/// are user code, so they're applied later by <see cref="FilterWatchedFields"/>.
+		/// </summary>
+		private (Type Type, FieldInfo[] Fields)[] ScanStaticFields( Assembly asm, bool isFromSwappedAsm )
 		{
-			if ( IsAssemblyIgnored( asm ) ) yield break;
+			if ( IsAssemblyIgnored( asm ) ) return Array.Empty<(Type, FieldInfo[])>();
 
-			var filter = _watchedAssemblies.GetValueOrDefault( asm );
+			var result = new List<(Type Type, FieldInfo[] Fields)>();
 
 			foreach ( var type in asm.GetTypes() )
 			{
-				if ( filter?.Invoke( type ) is false ) continue;
-
-				var fields = GetWatchedFields( type, isFromSwappedAsm ).ToArray();
+				var fields = ScanStaticFields( type, isFromSwappedAsm ).ToArray();
 
 				if ( fields.Length == 0 ) continue;
 
-				yield return (type, fields);
+				result.Add( (type, fields) );
 			}
+
+			return result.ToArray();
 		}
 
-		private IEnumerable<FieldInfo> GetWatchedFields( Type type, bool isFromSwappedAsm )
+		private IEnumerable<FieldInfo> ScanStaticFields( Type type, bool isFromSwappedAsm )
 		{
 			var typeInfo = type.GetTypeInfo();
-			var skipUpgrader = GetUpgrader<SkipUpgrader>();
-			var autoSkipUpgrader = TryGetUpgrader<AutoSkipUpgrader>( out var upgrader ) ? upgrader : null;
 
 			// Ignore anything in the hotload assembly
 			if ( IsAssemblyIgnored( typeInfo.Assembly ) ) yield break;
@@ -388,16 +470,37 @@ namespace Sandbox
 				// Ignore if marked with SkipAttribute 
 				if ( staticField.HasAttribute<SkipHotloadAttribute>() ) continue;
 
-				if ( !isFromSwappedAsm && staticField.FieldType.IsSealed )
-				{
-					if ( skipUpgrader.ShouldProcessType( staticField.FieldType ) ) continue;
-					if ( autoSkipUpgrader?.ShouldProcessType( staticField.FieldType ) ?? false ) continue;
-				}
-
 				yield return staticField;
 			}
 		}
 
+		/// <summary>
+		/// Remove types excluded by the assembly's watch filter, and static fields that an upgrader would skip anyway.
+		/// Neither filters nor upgraders are thread safe, so this has to happen on the hotloading thread.
+		/// </summary>
+		private IEnumerable<(Type Type, FieldInfo[] Fields)> FilterWatchedFields( Assembly asm, (Type Type, FieldInfo[] Fields)[] scanned, bool isFromSwappedAsm )
+		{
+			if ( _watchedAssemblies.GetValueOrDefault( asm ) is { } filter )
+			{
+				scanned = scanned.Where( x => filter( x.Type ) ).ToArray();
+			}
+
+			if ( isFromSwappedAsm )
+			{
+				return scanned;
+			}
+
+			var skipUpgrader = GetUpgrader<SkipUpgrader>();
+			var autoSkipUpgrader = TryGetUpgrader<AutoSkipUpgrader>( out var upgrader ) ? upgrader : null;
+
+			return scanned
+				.Select( x => (x.Type, Fields: x.Fields
+					.Where( field => !field.FieldType.IsSealed
+						|| !skipUpgrader.ShouldProcessType( field.FieldType ) && !(autoSkipUpgrader?.ShouldProcessType( field.FieldType ) ?? false) )
+					.ToArray()) )
+				.Where( x => x.Fields.Length > 0 );
+		}
+
 		internal void UpdateReferencesInType( Type t, FieldInfo[] staticFields )
 		{
 			var subType = GetNewType( t );
@@ -408,19 +511,10 @@ namespace Sandbox
 			// Iterate all statics
 			foreach ( var staticField in staticFields )
 			{
-				var newField = subType != t
-					? subType.GetField( staticField.Name, BindingFlags.Static | BindingFlags.Public | BindingFlags.NonPublic | BindingFlags.DeclaredOnly )
-					: staticField;
+				var newField = GetNewStaticField( t, subType, staticField );
 
-				// Ignore removed fields
 				if ( newField == null ) continue;
 
-				// Ignore const values
-				if ( newField.IsLiteral ) continue;
-
-				// Ignore if marked with SkipAttribute 
-				if ( newField.HasAttribute<SkipHotloadAttribute>() ) continue;
-
 				object curVal;
 
 				try
@@ -464,6 +558,9 @@ namespace Sandbox
 
 						if ( newVal is null ) continue;
 
+						// Already upgraded in place by the parallel walk
+						if ( ReferenceEquals( curVal, newVal ) && IsWalked( curVal ) ) continue;
+
 						RootUpgraderGroup.TryUpgradeInstance( curVal, newVal );
 						continue;
 					}
@@ -475,7 +572,7 @@ namespace Sandbox
 						// We're processing a static field in a non-swapped type, and the value type isn't
 						// swapped either. Try upgrading in-place.
 
-						if ( RootUpgraderGroup.TryUpgradeInstance( curVal, curVal ) )
+						if ( IsWalked( curVal ) || RootUpgraderGroup.TryUpgradeInstance( curVal, curVal ) )
 						{
 							continue;
 						}
@@ -500,11 +597,37 @@ namespace Sandbox
 			}
 		}
 
+		/// <summary>
+		/// Find the field in <paramref name="subType"/> that replaces <paramref name="staticField"/> from <paramref name="t"/>,
+		/// or null if it shouldn't be processed.
+		/// </summary>
+		private static FieldInfo GetNewStaticField( Type t, Type subType, FieldInfo staticField )
+		{
+			var newField = subType != t
+				? subType.GetField( staticField.Name, BindingFlags.Static | BindingFlags.Public | BindingFlags.NonPublic | BindingFlags.DeclaredOnly )
+				: staticField;
+
+			// Ignore removed fields
+			if ( newField == null ) return null;
+
+			// Ignore const values
+			if ( newField.IsLiteral ) return null;
+
+			// Ignore if marked with SkipAttribute 
+			if ( newField.HasAttribute<SkipHotloadAttribute>() ) return null;
+
+			return newField;
+		}
+
 		private object GetNewInstance( object oldInstance )
 		{
 			if ( oldInstance == null )
 				return null;
 
+			// Already visited by the parallel walk, which only visits instances that are upgraded in place
+			if ( IsWalked( oldInstance ) )
+				return oldInstance;
+
 			// Check for specific InstanceUpgraders for handling special types
 			if ( RootUpgraderGroup.TryCreateNewInstance( oldInstance, out var newInstance ) )
 			{
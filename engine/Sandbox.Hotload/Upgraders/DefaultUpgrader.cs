@@ -37,10 +37,44 @@ public class DefaultUpgrader : Hotload.InstanceUpgrader
 	private Stack<CompletionTask> CompletionTasks { get; } = new Stack<CompletionTask>();
 	private List<Dictionary<string, object?>> StateDictPool { get; } = new List<Dictionary<string, object?>>();
 
-	private Dictionary<(Type? OldType, Type NewType, bool CanSkip), (FieldInfo? SrcField, FieldInfo DstField)[]> FieldCache { get; } = new();
+	private Dictionary<(Type? OldType, Type NewType, bool CanSkip), FieldCopyPlan> FieldCache { get; } = new();
 
 	private const int StateDictPoolCapacity = 1024;
 
+	/// <summary>
+	/// How many instances of a type pair we copy with plain reflection before compiling
+	/// field accessors for it. Compiling isn't free, so only bother for types with lots of instances.
+	/// </summary>
+	private const int CompileAccessorsThreshold = 64;
+
+	/// <summary>
+	/// The fields to copy between an old and new type, and compiled accessors for them once
+	/// we've seen enough instances of this pair.
+	/// </summary>
+	private sealed class FieldCopyPlan
+	{
+		public (FieldInfo? SrcField, FieldInfo DstField)[] Fields { get; }
+
+		/// <summary>
+		/// Compiled getters for each <see cref="Fields"/> source field, or null if not compiled yet.
+		/// Individual entries are null if that field must use reflection.
+		/// </summary>
+		public Func<object, object?>?[]? Getters { get; set; }
+
+		/// <summary>
+		/// Compiled setters for each <see cref="Fields"/> destination field, or null if not compiled yet.
+		/// Individual entries are null if that field must use reflection.
+		/// </summary>
+		public Action<object, object?>?[]? Setters { get; set; }
+
+		public int InstanceCount { get; set; }
+
+		public FieldCopyPlan( (FieldInfo? SrcField, FieldInfo DstField)[] fields )
+		{
+			Fields = fields;
+		}
+	}
+
 	private SkipUpgrader SkipUpgrader { get; set; } = null!;
 	private AutoSkipUpgrader AutoSkipUpgrader { get; set; } = null!;
 
@@ -285,7 +319,7 @@ public class DefaultUpgrader : Hotload.InstanceUpgrader
 	/// <summary>
 	/// Get all fields on this type, and types it inherits from, that we should process.
 	/// </summary>
-	private (FieldInfo? SrcField, FieldInfo DstField)[] GetFieldsToProcess( Type? oldType, Type newType, bool canSkip )
+	private FieldCopyPlan GetFieldsToProcess( Type? oldType, Type newType, bool canSkip )
 	{
 		var key = (oldType, newType, canSkip);
 
@@ -294,13 +328,42 @@ public class DefaultUpgrader : Hotload.InstanceUpgrader
 			return cached;
 		}
 
-		cached = GetFieldsToProcessUncached( oldType, newType, canSkip ).ToArray();
+		cached = new FieldCopyPlan( GetFieldsToProcessUncached( oldType, newType, canSkip ).ToArray() );
 
 		FieldCache.Add( key, cached );
 
 		return cached;
 	}
 
+	/// <summary>
+	/// Emit getters and setters for each field in the plan, so copying further instances
+	/// doesn't need to go through <see cref="FieldInfo.GetValue"/> / <see cref="FieldInfo.SetValue(object, object)"/>.
+	/// Fields we can't compile an accessor for keep using reflection.
+	/// </summary>
+	private void CompileFieldAccessors( FieldCopyPlan plan )
+	{
+		var getters = new Func<object, object?>?[plan.Fields.Length];
+		var setters = new Action<object, object?>?[plan.Fields.Length];
+
+		for ( var i = 0; i < plan.Fields.Length; ++i )
+		{
+			var (srcField, dstField) = plan.Fields[i];
+
+			try
+			{
+				if ( srcField != null ) getters[i] = ILGeneratorExtensions.CreateFieldGetter( srcField );
+				setters[i] = ILGeneratorExtensions.CreateFieldSetter( dstField );
+			}
+			catch ( Exception e )
+			{
+				Log( HotloadEntryType.Trace, $"Unable to compile field accessors: {e.Message}", dstField );
+			}
+		}
+
+		plan.Getters = getters;
+		plan.Setters = setters;
+	}
+
 	/// <summary>
 	/// For each type in <paramref name="newType"/>'s hierarchy, try to find a matching type in <paramref name="oldType"/>'s hierarchy.
 	/// If no match is found, yields <c>(null, dstType)</c>. Ordered by most derived type first.
@@ -401,6 +464,25 @@ public class DefaultUpgrader : Hotload.InstanceUpgrader
 		}
 	}
 
+	/// <summary>
+	/// Fields that <see cref="ProcessObjectFields(object)"/> visits on an instance of <paramref name="type"/> that's
+	/// upgraded in place, or null if any of them would be reset rather than keep their value.
+	/// </summary>
+	internal FieldInfo[]? GetInPlaceFields( Type type )
+	{
+		var plan = GetFieldsToProcess( type, type, true );
+		var fields = new FieldInfo[plan.Fields.Length];
+
+		for ( var i = 0; i < fields.Length; ++i )
+		{
+			if ( plan.Fields[i].SrcField is not { } srcField ) return null;
+
+			fields[i] = srcField;
+		}
+
+		return fields;
+	}
+
 	public void ProcessObjectFields( object instance )
 	{
 		ProcessObjectFields( instance, instance );
@@ -415,10 +497,22 @@ public class DefaultUpgrader : Hotload.InstanceUpgrader
 
 		var oldPath = CurrentPath;
 
+		var plan = GetFieldsToProcess( oldType, newType, sameInstance );
+
+		if ( plan.Getters is null && ++plan.InstanceCount >= CompileAccessorsThreshold )
+		{
+			CompileFieldAccessors( plan );
+		}
+
+		var getters = plan.Getters;
+		var setters = plan.Setters;
+
 		try
 		{
-			foreach ( var (srcField, dstField) in GetFieldsToProcess( oldType, newType, sameInstance ) )
+			for ( var i = 0; i < plan.Fields.Length; ++i )
 			{
+				var (srcField, dstField) = plan.Fields[i];
+
 				if ( TracePaths )
 				{
 					CurrentPath = oldPath[dstField];
@@ -455,13 +549,20 @@ public class DefaultUpgrader : Hotload.InstanceUpgrader
 				}
 				else
 				{
-					newValue = ProcessFieldValue( oldInst, srcField );
+					newValue = ProcessFieldValue( oldInst, srcField, getters?[i] );
 				}
 
 
 				try
 				{
-					dstField.SetValue( newInst, newValue );
+					if ( setters?[i] is { } setter )
+					{
+						setter( newInst, newValue );
+					}
+					else
+					{
+						dstField.SetValue( newInst, newValue );
+					}
 				}
 #if !HOTLOAD_NOCATCH
 				catch ( Exception e )
@@ -484,9 +585,9 @@ public class DefaultUpgrader : Hotload.InstanceUpgrader
 		}
 	}
 
-	private object ProcessFieldValue( object oldInst, FieldInfo srcField )
+	private object ProcessFieldValue( object oldInst, FieldInfo srcField, Func<object, object?>? getter )
 	{
-		var value = srcField.GetValue( oldInst );
+		var value = getter is not null ? getter( oldInst ) : srcField.GetValue( oldInst );
 
 		return GetNewInstance( value );
 	}
@@ -24,6 +24,12 @@ internal class HashSetEx<T> : IHotloadManaged
 	/// </summary>
 	public int Count => _hashset.Count;
 
+	/// <summary>
+	/// Incremented every time an item is added or removed, so anything built from
+	/// the contents of the set can tell when it needs rebuilding.
+	/// </summary>
+	public int Version { get; private set; }
+
 	/// <summary>
 	/// List view of the set. This is only updated when there are no
 	/// active enumerators created by <see cref="EnumerateLocked"/>.
@@ -46,6 +52,7 @@ internal class HashSetEx<T> : IHotloadManaged
 		if ( !_hashset.Add( obj ) ) return false;
 
 		_listInvalid = true;
+		Version++;
 		return true;
 	}
 
@@ -58,6 +65,7 @@ internal class HashSetEx<T> : IHotloadManaged
 		if ( !_hashset.Remove( obj ) ) return false;
 
 		_listInvalid = true;
+		Version++;
 		return true;
 	}
 
@@ -75,6 +83,28 @@ internal class HashSetEx<T> : IHotloadManaged
 
 		_hashset.Clear();
 		_listInvalid = true;
+		Version++;
+	}
+
+	/// <summary>
+	/// Copy every item into <paramref name="array"/> as a <typeparamref name="TItem"/>, growing it if it's too small,
+	/// and return how many were copied. Unlike <see cref="List"/>, this sees changes made while enumerators are active.
+	/// </summary>
+	public int CopyTo<TItem>( ref TItem[] array )
+	{
+		if ( array.Length < _hashset.Count )
+		{
+			array = new TItem[Math.Max( _hashset.Count, array.Length * 2 )];
+		}
+
+		var count = 0;
+
+		foreach ( var item in _hashset )
+		{
+			array[count++] = (TItem)(object)item;
+		}
+
+		return count;
 	}
 
 	/// <summary>
@@ -1198,6 +1198,35 @@ public class TestClass49
 	public int IntProperty;
 }
 
+public class TestClass50
+{
+	[Reset] public static TestClass50[] Instances;
+
+	public struct ExampleStruct
+	{
+		public int Value;
+#if TEST_AFTER
+		public int Added;
+#endif
+	}
+
+	public readonly int ReadOnlyField;
+
+	public int IntProperty { get; set; }
+	public string StringField;
+	public ExampleStruct StructField;
+	public TestClass50 Next;
+
+#if TEST_AFTER
+	public int AddedField = 86;
+#endif
+
+	public TestClass50( int value )
+	{
+		ReadOnlyField = value;
+	}
+}
+
 public class ContainerClass
 {
 	public SerializableClass ObjectProperty { get; set; }
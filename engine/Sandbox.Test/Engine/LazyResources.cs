@@ -0,0 +1,230 @@
+using System;
+using System.Collections.Generic;
+
+namespace Resources;
+
+[AssetType( Name = "Lazy Test", Extension = "lazytest" )]
+public class LazyTestResource : GameResource
+{
+	public static int Loaded;
+	public static List<string> LoadOrder = new();
+
+	public string Title { get; set; }
+	public LazyTestResource Other { get; set; }
+
+	protected override void PostLoad()
+	{
+		Loaded++;
+		LoadOrder.Add( ResourcePath );
+	}
+}
+
+[TestClass]
+public class LazyResources
+{
+	static readonly AssetTypeAttribute Type = new() { Name = "Lazy Test", Extension = "lazytest", TargetType = typeof( LazyTestResource ) };
+
+	[TestInitialize]
+	public void Initialize()
+	{
+		LazyTestResource.Loaded = 0;
+		LazyTestResource.LoadOrder.Clear();
+	}
+
+	/// <summary>
+	/// Compile <paramref name="json"/> into a real compiled resource, so loading it goes through the same
+	/// native read as a game's files.
+	/// </summary>
+	static unsafe byte[] Compile( string path, string json )
+	{
+		var absolutePath = System.IO.Path.GetFullPath( System.IO.Path.Combine( ".source2/temp", path ) );
+		System.IO.Directory.CreateDirectory( System.IO.Path.GetDirectoryName( absolutePath ) );
+		System.IO.File.WriteAllText( absolutePath, json );
+
+		var data = System.Text.Encoding.UTF8.GetBytes( json );
+
+		fixed ( byte* ptr = data )
+		{
+			using var buffer = NativeEngine.IResourceCompilerSystem.GenerateResourceBytes( absolutePath, (IntPtr)ptr, data.Length );
+			return buffer.ToArray();
+		}
+	}
+
+	static void WriteCompiled( MemoryFileSystem fs, string path, string json )
+	{
+		fs.CreateDirectory( System.IO.Path.GetDirectoryName( path ) );
+		fs.WriteAllBytes( $"{path}_c", Compile( path, json ) );
+	}
+
+	static void Unregister( params string[] paths )
+	{
+		foreach ( var path in paths )
+		{
+			if ( ResourceLibrary.Get<LazyTestResource>( path ) is { } resource )
+			{
+				Game.Resources.Unregister( resource );
+			}
+		}
+	}
+
+	/// <summary>
+	/// Indexing shouldn't read anything. The first get deserializes the file, and after that it's just a
+	/// normal loaded resource.
+	/// </summary>
+	[TestMethod]
+	public void LoadsOnFirstGet()
+	{
+		var fs = new MemoryFileSystem();
+		WriteCompiled( fs, "lazy/real.lazytest", "{ \"Title\": \"Hello\" }" );
+
+		Game.Resources.AddPendingGameResource( Type, "lazy/real.lazytest_c", fs );
+
+		try
+		{
+			Assert.AreEqual( 0, LazyTestResource.Loaded );
+			Assert.IsTrue( Game.Resources.IsPending( "lazy/real.lazytest", out _ ) );
+
+			var resource = ResourceLibrary.Get<LazyTestResource>( "lazy/real.lazytest" );
+
+			Assert.IsNotNull( resource );
+			Assert.AreEqual( "Hello", resource.Title );
+			Assert.AreEqual( 1, LazyTestResource.Loaded );
+			Assert.IsFalse( Game.Resources.IsPending( "lazy/real.lazytest", out _ ) );
+
+			Assert.AreSame( resource, ResourceLibrary.Get<LazyTestResource>( "lazy/real.lazytest" ) );
+			Assert.AreEqual( 1, LazyTestResource.Loaded, "Shouldn't load again" );
+		}
+		finally
+		{
+			Unregister( "lazy/real.lazytest" );
+		}
+	}
+
+	/// <summary>
+	/// A pending resource referenced by one being loaded gets loaded as it's deserialized, so it has
+	/// finished its PostLoad by the time the one referencing it runs its own.
+	/// </summary>
+	[TestMethod]
+	public void ReferencesPostLoadFirst()
+	{
+		var fs = new MemoryFileSystem();
+		WriteCompiled( fs, "lazy/first.lazytest", "{ \"Title\": \"First\", \"Other\": \"lazy/second.lazytest\" }" );
+		WriteCompiled( fs, "lazy/second.lazytest", "{ \"Title\": \"Second\" }" );
+
+		Game.Resources.AddPendingGameResource( Type, "lazy/first.lazytest_c", fs );
+		Game.Resources.AddPendingGameResource( Type, "lazy/second.lazytest_c", fs );
+
+		try
+		{
+			var first = ResourceLibrary.Get<LazyTestResource>( "lazy/first.lazytest" );
+
+			Assert.IsNotNull( first.Other );
+			Assert.AreEqual( "Second", first.Other.Title );
+			Assert.IsFalse( Game.Resources.IsPending( "lazy/second.lazytest", out _ ) );
+
+			CollectionAssert.AreEqual( new[] { "lazy/second.lazytest", "lazy/first.lazytest" }, LazyTestResource.LoadOrder );
+		}
+		finally
+		{
+			Unregister( "lazy/first.lazytest", "lazy/second.lazytest" );
+		}
+	}
+
+	/// <summary>
+	/// With resource_lazyload on, loading everything only indexes it
+	/// </summary>
+	[TestMethod]
+	public void LoadAllGameResourceLazy()
+	{
+		var fs = new MemoryFileSystem();
+		WriteCompiled( fs, "lazy/all/a.lazytest", "{ \"Title\": \"A\" }" );
+		WriteCompiled( fs, "lazy/all/b.lazytest", "{ \"Title\": \"B\" }" );
+
+		ResourceLoader.LazyLoad = true;
+
+		try
+		{
+			ResourceLoader.LoadAllGameResource( fs );
+
+			Assert.AreEqual( 0, LazyTestResource.Loaded );
+			Assert.IsTrue( Game.Resources.IsPending( "lazy/all/a.lazytest", out _ ) );
+			Assert.IsTrue( Game.Resources.IsPending( "lazy/all/b.lazytest", out _ ) );
+
+			Assert.AreEqual( "A", ResourceLibrary.Get<LazyTestResource>( "lazy/all/a.lazytest" ).Title );
+
+			Assert.AreEqual( 1, LazyTestResource.Loaded );
+			Assert.IsFalse( Game.Resources.IsPending( "lazy/all/a.lazytest", out _ ) );
+			Assert.IsTrue( Game.Resources.IsPending( "lazy/all/b.lazytest", out _ ) );
+		}
+		finally
+		{
+			ResourceLoader.LazyLoad = false;
+			Unregister( "lazy/all/a.lazytest", "lazy/all/b.lazytest" );
+		}
+	}
+
+	/// <summary>
+	/// Indexing the same resource from two filesystems, like a second LoadAllGameResource after mounting
+	/// a package, shouldn't load anything. It should be loaded from the one indexed last when it's first used.
+	/// </summary>
+	[TestMethod]
+	public void IndexTwoFileSystems()
+	{
+		var first = new MemoryFileSystem();
+		var second = new MemoryFileSystem();
+
+		// Too short to be a compiled resource, so loading gives up before reading them
+
+		first.WriteAllText( "lazy/thing.lazytest_c", "ab" );
+		second.WriteAllText( "lazy/thing.lazytest_c", "cd" );
+
+		Game.Resources.AddPendingGameResource( Type, "lazy/thing.lazytest_c", first );
+		Game.Resources.AddPendingGameResource( Type, "lazy/thing.lazytest_c", second );
+
+		Assert.AreEqual( 0, LazyTestResource.Loaded );
+		Assert.IsTrue( Game.Resources.IsPending( "lazy/thing.lazytest", out var fileSystem ) );
+		Assert.AreSame( second, fileSystem );
+
+		var resource = ResourceLibrary.Get<LazyTestResource>( "lazy/thing.lazytest" );
+
+		try
+		{
+			Assert.IsNotNull( resource );
+			Assert.IsFalse( Game.Resources.IsPending( "lazy/thing.lazytest", out _ ) );
+		}
+		finally
+		{
+			Game.Resources.Unregister( resource );
+		}
+	}
+
+	/// <summary>
+	/// Indexing a resource that's already loaded leaves it alone until it's next used, then reads it again
+	/// from the new filesystem
+	/// </summary>
+	[TestMethod]
+	public void IndexLoadedResource()
+	{
+		var resource = new LazyTestResource();
+		resource.Register( "lazy/loaded.lazytest" );
+
+		try
+		{
+			var fs = new MemoryFileSystem();
+			fs.WriteAllText( "lazy/loaded.lazytest_c", "ab" );
+
+			Game.Resources.AddPendingGameResource( Type, "lazy/loaded.lazytest_c", fs );
+
+			Assert.AreEqual( 0, LazyTestResource.Loaded );
+			Assert.IsTrue( Game.Resources.IsPending( "lazy/loaded.lazytest", out var fileSystem ) );
+			Assert.AreSame( fs, fileSystem );
+
+			Assert.AreSame( resource, ResourceLibrary.Get<LazyTestResource>( "lazy/loaded.lazytest" ) );
+			Assert.IsFalse( Game.Resources.IsPending( "lazy/loaded.lazytest", out _ ) );
+		}
+		finally
+		{
+			Game.Resources.Unregister( resource );
+		}
+	}
+}
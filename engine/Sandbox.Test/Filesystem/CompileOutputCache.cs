@@ -0,0 +1,58 @@
+using System;
+using System.IO;
+
+namespace TestFileSystem;
+
+[TestClass]
+public class CompileOutputCacheTest
+{
+	string folder;
+
+	[TestInitialize]
+	public void Initialize()
+	{
+		folder = Path.GetFullPath( ".source2/CompileOutputCacheTest" );
+
+		if ( Directory.Exists( folder ) )
+			Directory.Delete( folder, true );
+	}
+
+	void Age( string key, int minutes )
+	{
+		var file = Directory.GetFiles( folder ).Single( x => File.ReadAllBytes( x )[0] == (byte)key[0] );
+		File.SetLastWriteTimeUtc( file, DateTime.UtcNow.AddMinutes( -minutes ) );
+	}
+
+	/// <summary>
+	/// Storing past the size limit should delete whatever was used longest ago,
+	/// and reading an entry counts as using it.
+	/// </summary>
+	[TestMethod]
+	public void EvictsLeastRecentlyUsed()
+	{
+		var cache = new Sandbox.CompileOutputCache( folder, 250 );
+
+		cache.Set( "a", [(byte)'a', .. new byte[99]] );
+		cache.Set( "b", [(byte)'b', .. new byte[99]] );
+		Age( "a", 10 );
+		Age( "b", 5 );
+
+		// a is older, but reading it makes b the least recently used
+		Assert.IsNotNull( cache.Get( "a" ) );
+
+		cache.Set( "c", [(byte)'c', .. new byte[99]] );
+
+		Assert.IsNotNull( cache.Get( "a" ) );
+		Assert.IsNull( cache.Get( "b" ) );
+		Assert.IsNotNull( cache.Get( "c" ) );
+		Assert.AreEqual( 2, Directory.GetFiles( folder ).Length );
+	}
+
+	[TestMethod]
+	public void MissingKey()
+	{
+		var cache = new Sandbox.CompileOutputCache( folder, 1024 );
+
+		Assert.IsNull( cache.Get( "nothing" ) );
+	}
+}
@@ -146,6 +146,39 @@ public sealed class BinderTests : SceneTests
 		Assert.AreEqual( new Vector3( 0, 100, 0 ), exampleObject.LocalPosition );
 	}
 
+	/// <summary>
+	/// <see cref="MovieClipEvaluator"/> must set the same property values as <see cref="ClipExtensions.Update(IMovieClip,MovieTime,TrackBinder?)"/>.
+	/// </summary>
+	[TestMethod]
+	public void EvaluatorMatchesUpdate()
+	{
+		var rootTrack = MovieClip.RootGameObject( "Example" );
+		var positionTrack = rootTrack.Property<Vector3>( nameof( GameObject.LocalPosition ) )
+			.WithSamples( (0d, 2d), 4, Enumerable.Range( 0, 9 ).Select( x => new Vector3( x * 10f, 0f, 0f ) ) )
+			.WithConstant( (3d, 4d), new Vector3( 0f, 0f, 100f ) );
+		var heightTrack = rootTrack.Property<Vector3>( nameof( GameObject.LocalPosition ) )
+			.Property<float>( nameof( Vector3.y ) )
+			.WithSamples( (1d, 4d), 2, [0f, 1f, 2f, 3f, 4f, 5f, 6f] );
+
+		var clip = MovieClip.FromTracks( positionTrack, heightTrack );
+		var exampleObject = new GameObject( true, "Example" );
+
+		var evaluator = new MovieClipEvaluator( clip, TrackBinder.Default );
+
+		for ( var t = 0d; t <= 4.5d; t += 0.1d )
+		{
+			exampleObject.LocalPosition = default;
+			clip.Update( t );
+
+			var expected = exampleObject.LocalPosition;
+
+			exampleObject.LocalPosition = default;
+			evaluator.Update( t );
+
+			Assert.AreEqual( expected, exampleObject.LocalPosition, $"At {t}" );
+		}
+	}
+
 	/// <summary>
 	/// Support custom <see cref="ITrackPropertyFactory"/> implementations.
 	/// </summary>
@@ -1,4 +1,6 @@
 ﻿using System;
+using System.Collections.Generic;
+using System.Text.Json.Nodes;
 using Sandbox.MovieMaker;
 using Sandbox.MovieMaker.Compiled;
 
@@ -123,6 +125,122 @@ public sealed class CompiledTests
 		Assert.AreEqual( "Terry", name );
 	}
 
+	/// <summary>
+	/// Looking up blocks with a cursor, whether playing forwards or seeking around, must find the
+	/// same block as looking them up from scratch.
+	/// </summary>
+	[TestMethod]
+	public void GetBlockWithCursor()
+	{
+		var track = MovieClip.RootGameObject( "Example" )
+			.Property<float>( "Value" );
+
+		var random = new Random( 1234 );
+		var time = 0d;
+
+		for ( var i = 0; i < 100; ++i )
+		{
+			// Leave gaps between some blocks, and have others touching
+
+			time += random.Next( 3 ) * 0.5d;
+
+			var duration = random.Next( 1, 4 ) * 0.5d;
+
+			track = track.WithConstant( (time, time + duration), i );
+			time += duration;
+		}
+
+		var cursor = 0;
+
+		for ( var t = -1d; t <= time + 1d; t += 0.125d )
+		{
+			Assert.AreEqual( track.GetBlock( t ), track.GetBlock( t, ref cursor ), $"Playing at {t}" );
+		}
+
+		for ( var i = 0; i < 1000; ++i )
+		{
+			var t = random.NextDouble() * (time + 2d) - 1d;
+
+			Assert.AreEqual( track.GetBlock( t ), track.GetBlock( t, ref cursor ), $"Seeking to {t}" );
+		}
+
+		// On a boundary between two blocks, we want the later one
+
+		var first = track.Blocks.First( x => track.Blocks.Any( y => y.TimeRange.Start == x.TimeRange.End ) );
+		cursor = 0;
+
+		Assert.AreNotEqual( first, track.GetBlock( first.TimeRange.End ) );
+		Assert.AreEqual( track.GetBlock( first.TimeRange.End ), track.GetBlock( first.TimeRange.End, ref cursor ) );
+	}
+
+	private static IPropertyTrack<Vector3> CreateSampledTrack( int sampleCount )
+	{
+		var random = new Random( 1234 );
+		var samples = Enumerable.Range( 0, sampleCount )
+			.Select( i => new Vector3( MathF.Sin( i * 0.1f ) * 100f, random.Float( -1f, 1f ), i * 0.5f ) )
+			.ToArray();
+
+		return MovieClip.RootGameObject( "Object" )
+			.Property<Vector3>( nameof( GameObject.LocalPosition ) )
+			.WithSamples( (0d, sampleCount / 30d), 30, samples );
+	}
+
+	private static CompiledSampleBlock<Vector3> GetSampleBlock( IMovieClip clip ) =>
+		(CompiledSampleBlock<Vector3>)((CompiledPropertyTrack<Vector3>)clip.GetProperty<Vector3>( "Object", nameof( GameObject.LocalPosition ) )!).Blocks[0];
+
+	/// <summary>
+	/// Samples written with <see cref="SampleCodec"/> must read back exactly, and only be decoded when needed.
+	/// </summary>
+	[TestMethod]
+	public void SerializeSamplesLossless()
+	{
+		var clip = MovieClip.FromTracks( CreateSampledTrack( 1000 ) );
+		var srcBlock = GetSampleBlock( clip );
+
+		clip = Json.Deserialize<MovieClip>( Json.Serialize( clip ) );
+
+		var dstBlock = GetSampleBlock( clip );
+
+		Assert.IsNotNull( dstBlock.EncodedSamples );
+		Assert.AreEqual( srcBlock.GetValue( 10d ), dstBlock.GetValue( 10d ) );
+		Assert.IsNull( dstBlock.EncodedSamples );
+
+		CollectionAssert.AreEqual( srcBlock.Samples.ToArray(), dstBlock.Samples.ToArray() );
+	}
+
+	/// <summary>
+	/// Movies saved before <see cref="SampleCodec"/> stored samples as a gzipped <see cref="ByteStream"/>.
+	/// </summary>
+	[TestMethod]
+	public void DeserializeLegacySamples()
+	{
+		var clip = MovieClip.FromTracks( CreateSampledTrack( 100 ) );
+		var srcBlock = GetSampleBlock( clip );
+
+		var stream = ByteStream.Create( 16 * srcBlock.Samples.Length + 4 );
+		stream.WriteArray( srcBlock.Samples.AsSpan() );
+
+		var legacy = Convert.ToBase64String( stream.Compress().ToArray() );
+		stream.Dispose();
+
+		var json = JsonNode.Parse( Json.Serialize( clip ) )!;
+		var blockNode = FindObjects( json ).Single( x => x.ContainsKey( "Encoding" ) );
+
+		blockNode.Remove( "Encoding" );
+		blockNode["Samples"] = legacy;
+
+		clip = Json.Deserialize<MovieClip>( json.ToJsonString() );
+
+		CollectionAssert.AreEqual( srcBlock.Samples.ToArray(), GetSampleBlock( clip ).Samples.ToArray() );
+	}
+
+	private static IEnumerable<JsonObject> FindObjects( JsonNode node ) => node switch
+	{
+		JsonObject obj => obj.Select( x => x.Value ).SelectMany( FindObjects ).Prepend( obj ),
+		JsonArray array => array.SelectMany( FindObjects ),
+		_ => []
+	};
+
 	[TestMethod]
 	public void ValidateBlocks()
 	{
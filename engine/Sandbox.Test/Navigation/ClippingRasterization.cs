@@ -0,0 +1,199 @@
+﻿using Sandbox.Navigation.Generation;
+using System;
+
+namespace Navigation
+{
+	/// <summary>
+	/// The rasterizer as it was before rows were split into columns with SIMD: every row of a triangle is
+	/// clipped again one column at a time. Kept to check <see cref="Rasterization"/> against.
+	/// </summary>
+	internal static class ClippingRasterization
+	{
+		public static void RasterizeTriangles( Span<Vector3> verts, Span<int> tris, Span<int> triAreaIds,
+											 Heightfield heightfield, int flagMergeThreshold )
+		{
+			float inverseCellSize = 1.0f / heightfield.CellSize;
+			float inverseCellHeight = 1.0f / heightfield.CellHeight;
+
+			for ( int triIndex = 0; triIndex < tris.Length / 3; ++triIndex )
+			{
+				RasterizeTri( verts[tris[triIndex * 3 + 0]], verts[tris[triIndex * 3 + 1]], verts[tris[triIndex * 3 + 2]],
+					triAreaIds[triIndex], heightfield, heightfield.BMin, heightfield.BMax, heightfield.CellSize,
+					inverseCellSize, inverseCellHeight, flagMergeThreshold );
+			}
+		}
+
+		static void DividePoly( Span<Vector3> inVerts, int inVertsCount,
+							   Span<Vector3> outVerts1, out int outVerts1Count,
+							   Span<Vector3> outVerts2, out int outVerts2Count,
+							   float axisOffset, int axis )
+		{
+			Span<float> inVertAxisDelta = stackalloc float[12];
+			for ( int inVert = 0; inVert < inVertsCount; ++inVert )
+			{
+				inVertAxisDelta[inVert] = axisOffset - inVerts[inVert][axis];
+			}
+
+			int poly1Vert = 0;
+			int poly2Vert = 0;
+
+			for ( int inVertA = 0, inVertB = inVertsCount - 1; inVertA < inVertsCount; inVertB = inVertA, ++inVertA )
+			{
+				bool sameSide = (inVertAxisDelta[inVertA] >= 0) == (inVertAxisDelta[inVertB] >= 0);
+
+				if ( !sameSide )
+				{
+					float s = inVertAxisDelta[inVertB] / (inVertAxisDelta[inVertB] - inVertAxisDelta[inVertA]);
+
+					outVerts1[poly1Vert] = inVerts[inVertB] + (inVerts[inVertA] - inVerts[inVertB]) * s;
+					outVerts2[poly2Vert] = outVerts1[poly1Vert];
+					poly1Vert++;
+					poly2Vert++;
+
+					if ( inVertAxisDelta[inVertA] > 0 )
+					{
+						outVerts1[poly1Vert] = inVerts[inVertA];
+						poly1Vert++;
+					}
+					else if ( inVertAxisDelta[inVertA] < 0 )
+					{
+						outVerts2[poly2Vert] = inVerts[inVertA];
+						poly2Vert++;
+					}
+				}
+				else
+				{
+					if ( inVertAxisDelta[inVertA] >= 0 )
+					{
+						outVerts1[poly1Vert] = inVerts[inVertA];
+						poly1Vert++;
+
+						if ( inVertAxisDelta[inVertA] != 0 )
+						{
+							continue;
+						}
+					}
+
+					outVerts2[poly2Vert] = inVerts[inVertA];
+					poly2Vert++;
+				}
+			}
+
+			outVerts1Count = poly1Vert;
+			outVerts2Count = poly2Vert;
+		}
+
+		static void RasterizeTri( Vector3 v0, Vector3 v1, Vector3 v2,
+								 int areaId, Heightfield heightfield,
+								 Vector3 heightfieldBBMin, Vector3 heightfieldBBMax,
+								 float cellSize, float inverseCellSize, float inverseCellHeight,
+								 int flagMergeThreshold )
+		{
+			Vector3 triBBMin = Vector3.Min( Vector3.Min( v0, v1 ), v2 );
+			Vector3 triBBMax = Vector3.Max( Vector3.Max( v0, v1 ), v2 );
+
+			if ( triBBMin.x > heightfieldBBMax.x || triBBMax.x < heightfieldBBMin.x ||
+				triBBMin.y > heightfieldBBMax.y || triBBMax.y < heightfieldBBMin.y ||
+				triBBMin.z > heightfieldBBMax.z || triBBMax.z < heightfieldBBMin.z )
+			{
+				return;
+			}
+
+			int w = heightfield.Width;
+			int h = heightfield.Height;
+			float by = heightfieldBBMax.y - heightfieldBBMin.y;
+
+			int z0 = (int)MathF.Floor( (triBBMin.z - heightfieldBBMin.z) * inverseCellSize );
+			int z1 = (int)MathF.Floor( (triBBMax.z - heightfieldBBMin.z) * inverseCellSize );
+
+			z0 = Math.Clamp( z0, -1, h - 1 );
+			z1 = Math.Clamp( z1, 0, h - 1 );
+
+			Span<Vector3> inVerts = stackalloc Vector3[7];
+			Span<Vector3> inRow = stackalloc Vector3[7];
+			Span<Vector3> p1 = stackalloc Vector3[7];
+			Span<Vector3> p2 = stackalloc Vector3[7];
+
+			inVerts[0] = v0;
+			inVerts[1] = v1;
+			inVerts[2] = v2;
+			int nvRow;
+			int nvIn = 3;
+
+			for ( int z = z0; z <= z1; ++z )
+			{
+				float cellZ = heightfieldBBMin.z + z * cellSize;
+				DividePoly( inVerts, nvIn, inRow, out nvRow, p1, out nvIn, cellZ + cellSize, 2 );
+
+				Span<Vector3> temp = inVerts;
+				inVerts = p1;
+				p1 = temp;
+
+				if ( nvRow < 3 )
+					continue;
+				if ( z < 0 )
+					continue;
+
+				float minX = inRow[0].x;
+				float maxX = inRow[0].x;
+				for ( int vert = 1; vert < nvRow; ++vert )
+				{
+					minX = Math.Min( minX, inRow[vert].x );
+					maxX = Math.Max( maxX, inRow[vert].x );
+				}
+
+				int x0 = (int)MathF.Floor( (minX - heightfieldBBMin.x) * inverseCellSize );
+				int x1 = (int)MathF.Floor( (maxX - heightfieldBBMin.x) * inverseCellSize );
+				if ( x1 < 0 || x0 >= w )
+					continue;
+
+				x0 = Math.Clamp( x0, -1, w - 1 );
+				x1 = Math.Clamp( x1, 0, w - 1 );
+
+				int nv;
+				int nv2 = nvRow;
+
+				for ( int x = x0; x <= x1; ++x )
+				{
+					float cx = heightfieldBBMin.x + x * cellSize;
+					DividePoly( inRow, nv2, p1, out nv, p2, out nv2, cx + cellSize, 0 );
+
+					Span<Vector3> swap = inRow;
+					inRow = p2;
+					p2 = swap;
+
+					if ( nv < 3 )
+						continue;
+					if ( x < 0 )
+						continue;
+
+					float spanMin = p1[0].y;
+					float spanMax = p1[0].y;
+					for ( int vert = 1; vert < nv; ++vert )
+					{
+						spanMin = Math.Min( spanMin, p1[vert].y );
+						spanMax = Math.Max( spanMax, p1[vert].y );
+					}
+
+					spanMin -= heightfieldBBMin.y;
+					spanMax -= heightfieldBBMin.y;
+
+					if ( spanMax < 0.0f )
+						continue;
+					if ( spanMin > by )
+						continue;
+
+					if ( spanMin < 0.0f )
+						spanMin = 0;
+					if ( spanMax > by )
+						spanMax = by;
+
+					ushort spanMinCellIndex = (ushort)Math.Clamp( (int)MathF.Floor( spanMin * inverseCellHeight ), 0, Constants.SPAN_MAX_HEIGHT );
+					ushort spanMaxCellIndex = (ushort)Math.Clamp( (int)MathF.Ceiling( spanMax * inverseCellHeight ), spanMinCellIndex + 1, Constants.SPAN_MAX_HEIGHT );
+
+					heightfield.AddOrMergeSpan( x, z, spanMinCellIndex, spanMaxCellIndex, areaId, flagMergeThreshold );
+				}
+			}
+		}
+	}
+}
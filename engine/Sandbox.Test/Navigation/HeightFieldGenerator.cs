@@ -162,6 +162,134 @@ namespace Navigation
 			Assert.AreEqual( 0, hf.TotalSpanCount, "No spans should be created for triangle outside the heightfield footprint." );
 		}
 
+		[TestMethod]
+		public void Rasterization_GridAlignedQuad_CoversExactlyItsCells()
+		{
+			using var hf = new Heightfield(
+				sizeX: 10,
+				sizeZ: 10,
+				minBounds: new Vector3( 0, 0, 0 ),
+				maxBounds: new Vector3( 10, 10, 10 ),
+				cellSize: 1.0f,
+				cellHeight: 1.0f
+			);
+
+			// Sloped quad from cell 2 to 5 on both axes, its far edges sit exactly on cell boundaries
+			Span<Vector3> verts = stackalloc Vector3[]
+			{
+				new(2,1,2),
+				new(6,5,2),
+				new(6,5,6),
+				new(2,1,6)
+			};
+			Span<int> indices = stackalloc int[] { 0, 2, 1, 0, 3, 2 };
+			Span<int> areas = stackalloc int[] { Constants.WALKABLE_AREA, Constants.WALKABLE_AREA };
+
+			Rasterization.RasterizeTriangles( verts, indices, areas, hf, flagMergeThreshold: 1 );
+			hf.EnsureCompressed();
+
+			for ( int z = 0; z < 10; z++ )
+			{
+				for ( int x = 0; x < 10; x++ )
+				{
+					var column = hf.GetColumn( x + z * 10 );
+					bool inside = x >= 2 && x < 6 && z >= 2 && z < 6;
+
+					Assert.AreEqual( inside ? 1 : 0, column.Length, $"Column {x},{z}" );
+					if ( !inside ) continue;
+
+					// Height rises one unit per column
+					Assert.AreEqual( (ushort)(x - 1), column[0].MinY, $"Column {x},{z}" );
+					Assert.AreEqual( (ushort)x, column[0].MaxY, $"Column {x},{z}" );
+				}
+			}
+		}
+
+		/// <summary>
+		/// Splitting rows into columns should give the same spans as clipping every cell, other than float rounding
+		/// moving the odd span end by one height cell. Lots of the vertices sit on, or a hair either side of, a boundary.
+		/// </summary>
+		[TestMethod]
+		public void Rasterization_MatchesClipping()
+		{
+			const int size = 32;
+			const float cellSize = 4.0f;
+			const float cellHeight = 2.0f;
+			const int count = 5000;
+
+			var bmin = new Vector3( -64, 0, -64 );
+			var bmax = new Vector3( bmin.x + size * cellSize, 256, bmin.z + size * cellSize );
+
+			using var expected = new Heightfield( size, size, bmin, bmax, cellSize, cellHeight );
+			using var actual = new Heightfield( size, size, bmin, bmax, cellSize, cellHeight );
+
+			var random = new Random( 1234 );
+
+			float NearBoundary( float value )
+			{
+				var boundary = MathF.Round( value / cellSize ) * cellSize;
+
+				return random.Next( 4 ) switch
+				{
+					0 => boundary,
+					1 => boundary + random.Float( -1e-5f, 1e-5f ) * cellSize,
+					_ => value
+				};
+			}
+
+			var verts = new Vector3[3];
+			int[] indices = [0, 1, 2];
+			int[] areas = [Constants.WALKABLE_AREA];
+			int inexact = 0;
+
+			for ( int i = 0; i < count; i++ )
+			{
+				var extent = random.Next( 3 ) switch { 0 => 3.0f, 1 => 30.0f, _ => 300.0f };
+				var center = new Vector3( random.Float( bmin.x - 20, bmax.x + 20 ), 0, random.Float( bmin.z - 20, bmax.z + 20 ) );
+
+				for ( int v = 0; v < 3; v++ )
+				{
+					verts[v] = new Vector3(
+						NearBoundary( center.x + random.Float( -extent, extent ) ),
+						random.Float( 0, 200 ),
+						NearBoundary( center.z + random.Float( -extent, extent ) ) );
+				}
+
+				expected.Init( size, size, bmin, bmax, cellSize, cellHeight );
+				actual.Init( size, size, bmin, bmax, cellSize, cellHeight );
+
+				ClippingRasterization.RasterizeTriangles( verts, indices, areas, expected, flagMergeThreshold: 1 );
+				Rasterization.RasterizeTriangles( verts, indices, areas, actual, flagMergeThreshold: 1 );
+
+				expected.EnsureCompressed();
+				actual.EnsureCompressed();
+
+				var exact = true;
+
+				for ( int c = 0; c < size * size; c++ )
+				{
+					var expectedColumn = expected.GetColumn( c );
+					var actualColumn = actual.GetColumn( c );
+
+					Assert.AreEqual( expectedColumn.Length, actualColumn.Length, $"Triangle {i} column {c}: {verts[0]} {verts[1]} {verts[2]}" );
+
+					for ( int s = 0; s < expectedColumn.Length; s++ )
+					{
+						Assert.IsTrue( Math.Abs( expectedColumn[s].MinY - actualColumn[s].MinY ) <= 1, $"Triangle {i} column {c}: {verts[0]} {verts[1]} {verts[2]}" );
+						Assert.IsTrue( Math.Abs( expectedColumn[s].MaxY - actualColumn[s].MaxY ) <= 1, $"Triangle {i} column {c}: {verts[0]} {verts[1]} {verts[2]}" );
+
+						exact &= expectedColumn[s].MinY == actualColumn[s].MinY && expectedColumn[s].MaxY == actualColumn[s].MaxY;
+					}
+				}
+
+				if ( !exact )
+					inexact++;
+			}
+
+			// Rounding only matters for heights right on a cell boundary
+			Assert.IsTrue( inexact < count / 100, $"{inexact} of {count} triangles weren't rasterized exactly the same" );
+		}
+
 		[TestMethod]
 		public void SpanFilter_LedgeRemoval_RemovesIsolatedSpan()
 		{
@@ -200,13 +328,13 @@ namespace Navigation
 			// Mirrors existing Navigation test but adds more assertions.
 			var world = new PhysicsWorld();
 			var body = new PhysicsBody( world );
-			var shape = body.AddBoxShape( BBox.FromPositionAndSize( 0, 200 ), Rotation.Identity );
+			body.AddBoxShape( BBox.FromPositionAndSize( 0, 200 ), Rotation.Identity );
 
 			using var gen = new HeightFieldGenerator();
 			var cfg = MakeConfig( BBox.FromPositionAndSize( Vector3.Zero, 400 ) );
 			gen.Init( cfg );
 
-			gen.AddGeometryFromPhysicsShape( shape );
+			gen.CollectGeometry( new Sandbox.Navigation.NavMesh(), world, cfg.Bounds );
 
 			Assert.AreEqual( 8, gen.inputGeoVerticesCount, "Expected box triangulation vertex count." );
 			Assert.AreEqual( 36, gen.inputGeoIndicesCount, "Expected box triangulation index count (12 triangles)." );
@@ -229,5 +357,91 @@ namespace Navigation
 
 			world.Delete();
 		}
+
+		[TestMethod]
+		public void HeightFieldGenerator_CollectGeometry_FromSnapshot()
+		{
+			var world = new PhysicsWorld();
+			var body = new PhysicsBody( world );
+			body.AddBoxShape( BBox.FromPositionAndSize( 0, 200 ), Rotation.Identity );
+
+			var navMesh = new Sandbox.Navigation.NavMesh();
+			var bounds = BBox.FromPositionAndSize( Vector3.Zero, 400 );
+			var farAway = BBox.FromPositionAndSize( new Vector3( 5000, 0, 0 ), 400 );
+
+			var snapshot = GeometrySnapshot.Capture( navMesh, world, [bounds, farAway] );
+			Assert.AreEqual( 1, snapshot.ShapeCount, "Shape should only be captured once." );
+
+			using var expected = new HeightFieldGenerator();
+			expected.Init( MakeConfig( bounds ) );
+			expected.CollectGeometry( navMesh, world, bounds );
+
+			// Collecting happens off the main thread
+			using var gen = new HeightFieldGenerator();
+			gen.Init( MakeConfig( bounds ) );
+			Task.Run( () => gen.CollectGeometry( snapshot, bounds ) ).Wait();
+
+			Assert.AreEqual( expected.inputGeoVerticesCount, gen.inputGeoVerticesCount );
+			Assert.AreEqual( expected.inputGeoIndicesCount, gen.inputGeoIndicesCount );
+
+			for ( int i = 0; i < gen.inputGeoIndicesCount; i++ )
+			{
+				Assert.AreEqual( expected.inputGeoVertices[expected.inputGeoIndices[i]], gen.inputGeoVertices[gen.inputGeoIndices[i]] );
+			}
+
+			// Nothing overlaps the other area
+			using var empty = new HeightFieldGenerator();
+			empty.Init( MakeConfig( farAway ) );
+			empty.CollectGeometry( snapshot, farAway );
+
+			Assert.AreEqual( 0, empty.inputGeoIndicesCount );
+
+			world.Delete();
+		}
+
+		/// <summary>
+		/// A shape spanning several areas is triangulated for each of them, and each tile gets the same geometry
+		/// as it would from a snapshot of just its own area.
+		/// </summary>
+		[TestMethod]
+		public void HeightFieldGenerator_CollectGeometry_PerArea()
+		{
+			var world = new PhysicsWorld();
+			var body = new PhysicsBody( world );
+			body.AddBoxShape( BBox.FromPositionAndSize( 0, 600 ), Rotation.Identity );
+
+			var navMesh = new Sandbox.Navigation.NavMesh();
+			var left = BBox.FromPositionAndSize( new Vector3( -200, 0, 0 ), 400 );
+			var right = BBox.FromPositionAndSize( new Vector3( 200, 0, 0 ), 400 );
+
+			var snapshot = GeometrySnapshot.Capture( navMesh, world, [left, right] );
+			Assert.AreEqual( 2, snapshot.ShapeCount, "Shape should be triangulated once per area." );
+			Assert.AreEqual( 1, snapshot.GetShapes( left ).Count );
+			Assert.AreEqual( 1, snapshot.GetShapes( right ).Count );
+
+			foreach ( var area in new[] { left, right } )
+			{
+				using var expected = new HeightFieldGenerator();
+				expected.Init( MakeConfig( area ) );
+				expected.CollectGeometry( navMesh, world, area );
+
+				using var gen = new HeightFieldGenerator();
+				gen.Init( MakeConfig( area ) );
+				gen.CollectGeometry( snapshot, area );
+
+				Assert.AreNotEqual( 0, gen.inputGeoIndicesCount );
+				Assert.AreEqual( expected.inputGeoVerticesCount, gen.inputGeoVerticesCount );
+				Assert.AreEqual( expected.inputGeoIndicesCount, gen.inputGeoIndicesCount );
+
+				for ( int i = 0; i < gen.inputGeoIndicesCount; i++ )
+				{
+					Assert.AreEqual( expected.inputGeoVertices[expected.inputGeoIndices[i]], gen.inputGeoVertices[gen.inputGeoIndices[i]] );
+				}
+			}
+
+			Assert.ThrowsException<ArgumentException>( () => snapshot.GetShapes( BBox.FromPositionAndSize( 0, 10 ) ) );
+
+			world.Delete();
+		}
 	}
 }
@@ -1,3 +1,5 @@
+using DotRecast.Detour;
+using DotRecast.Detour.Crowd;
 using Sandbox;
 using Sandbox.Navigation;
 using Sandbox.Navigation.Generation;
@@ -23,7 +25,7 @@ public class MeshBuilding
 		// A physics world to generate the navmesh from
 		var world = new PhysicsWorld();
 		var body = new PhysicsBody( world );
-		var shape = body.AddBoxShape( BBox.FromPositionAndSize( 0, 200 ), Rotation.Identity );
+		body.AddBoxShape( BBox.FromPositionAndSize( 0, 200 ), Rotation.Identity );
 
 
 		// generate the navmesh using CNavMeshHeightFieldGenerator
@@ -31,7 +33,7 @@ public class MeshBuilding
 			using HeightFieldGenerator hfGenerator = new();
 			hfGenerator.Init( testConfig );
 
-			hfGenerator.AddGeometryFromPhysicsShape( shape );
+			hfGenerator.CollectGeometry( new NavMesh(), world, testConfig.Bounds );
 			Assert.AreEqual( 8, hfGenerator.inputGeoVerticesCount );
 			Assert.AreEqual( 36, hfGenerator.inputGeoIndicesCount );
 
@@ -174,4 +176,315 @@ public class MeshBuilding
 
 		navMesh.Dispose();
 	}
+
+	/// <summary>
+	/// A path across many tiles, around a long wall, goes through the portal graph and still reaches the target
+	/// </summary>
+	[TestMethod]
+	public async Task Query_PathLong()
+	{
+		var navMesh = new NavMesh();
+		var world = new PhysicsWorld();
+
+		var body = new PhysicsBody( world );
+		body.AddBoxShape( BBox.FromPositionAndSize( 0, new Vector3( 4000, 4000, 500 ) ), Rotation.Identity );
+		body.AddBoxShape( BBox.FromPositionAndSize( new Vector3( 0, -400, 350 ), new Vector3( 64, 3200, 200 ) ), Rotation.Identity );
+
+		Assert.IsTrue( await navMesh.Generate( world ) );
+
+		world.Delete();
+
+		var start = new Vector3( -1800, 0, 250 );
+		var target = new Vector3( 1800, 0, 250 );
+
+		var path = navMesh.CalculatePath( new CalculatePathRequest { Start = start, Target = target } );
+		Assert.IsTrue( path.IsValid() );
+		Assert.AreEqual( NavMeshPathStatus.Complete, path.Status );
+		Assert.IsTrue( path.Points[^1].Position.WithZ( 0 ).Distance( target.WithZ( 0 ) ) < 32 );
+
+		// Has to go around the end of the wall
+		Assert.IsTrue( path.Points.Any( x => x.Position.y > 1200 ) );
+
+		navMesh.Dispose();
+	}
+
+	/// <summary>
+	/// Tiles saved with the scene are used as they are when the geometry hasn't changed, and regenerated when it has
+	/// </summary>
+	[TestMethod]
+	public async Task Bake_LoadsUnchangedTiles()
+	{
+		var world = new PhysicsWorld();
+		var body = new PhysicsBody( world );
+		body.AddBoxShape( BBox.FromPositionAndSize( 0, 500 ), Rotation.Identity );
+
+		var navMesh = new NavMesh { IsEnabled = true };
+		Assert.IsTrue( await navMesh.Generate( world ) );
+
+		var json = navMesh.Serialize( true );
+		Assert.IsNotNull( json["Tiles"] );
+		Assert.IsNull( navMesh.Serialize()["Tiles"], "Tiles should only be saved when asked for" );
+
+		var tilePosition = navMesh.WorldPositionToTilePosition( new Vector3( 0, 0, 250 ) );
+		var polyCount = navMesh.GetPolyCount( tilePosition );
+		Assert.AreNotEqual( 0, polyCount );
+
+		// Same geometry, tiles come from the bake
+		var loaded = new NavMesh();
+		loaded.Deserialize( json );
+		Assert.IsTrue( await loaded.Generate( world ) );
+
+		Assert.IsTrue( loaded.tileCache.GetOrAddTile( tilePosition ).IsBaked );
+		Assert.AreEqual( polyCount, loaded.GetPolyCount( tilePosition ) );
+
+		var path = loaded.CalculatePath( new CalculatePathRequest { Start = new Vector3( 200, 200, 250 ), Target = new Vector3( -200, -200, 250 ) } );
+		Assert.IsTrue( path.IsValid() );
+
+		// Geometry moved, tiles are generated again
+		body.Position = new Vector3( 0, 0, 50 );
+
+		var changed = new NavMesh();
+		changed.Deserialize( json );
+		Assert.IsTrue( await changed.Generate( world ) );
+
+		Assert.IsFalse( changed.tileCache.GetOrAddTile( tilePosition ).IsBaked );
+		Assert.AreNotEqual( 0, changed.GetPolyCount( tilePosition ) );
+
+		world.Delete();
+
+		navMesh.Dispose();
+		loaded.Dispose();
+		changed.Dispose();
+	}
+
+	static CalculatePathRequest[] CreatePathRequests( int count )
+	{
+		var random = new System.Random( 4321 );
+		var requests = new CalculatePathRequest[count];
+
+		for ( int i = 0; i < count; i++ )
+		{
+			requests[i] = new CalculatePathRequest
+			{
+				Start = new Vector3( random.Float( -220, 220 ), random.Float( -220, 220 ), 250 ),
+				Target = new Vector3( random.Float( -220, 220 ), random.Float( -220, 220 ), 250 )
+			};
+		}
+
+		return requests;
+	}
+
+	/// <summary>
+	/// 1000 paths at once in a batch, which should give the same paths as one at a time
+	/// </summary>
+	[TestMethod]
+	public async Task Query_PathBatch()
+	{
+		var navMesh = new NavMesh();
+		var world = new PhysicsWorld();
+
+		var body = new PhysicsBody( world );
+		body.AddBoxShape( BBox.FromPositionAndSize( 0, 500 ), Rotation.Identity );
+
+		Assert.IsTrue( await navMesh.Generate( world ) );
+
+		world.Delete();
+
+		var requests = CreatePathRequests( 1000 );
+		var expected = new NavMeshPath[requests.Length];
+		var results = new NavMeshPath[requests.Length];
+
+		var sw = System.Diagnostics.Stopwatch.StartNew();
+
+		for ( int i = 0; i < requests.Length; i++ )
+		{
+			expected[i] = navMesh.CalculatePath( requests[i] );
+		}
+
+		Console.WriteLine( $"One at a time: {sw.Elapsed.TotalMilliseconds:0.00}ms" );
+		sw.Restart();
+
+		navMesh.CalculatePaths( requests, results );
+
+		Console.WriteLine( $"Batched: {sw.Elapsed.TotalMilliseconds:0.00}ms" );
+
+		for ( int i = 0; i < requests.Length; i++ )
+		{
+			Assert.AreEqual( expected[i].Status, results[i].Status );
+			Assert.IsTrue( results[i].IsValid() );
+			CollectionAssert.AreEqual( expected[i].Points.ToArray(), results[i].Points.ToArray() );
+		}
+
+		navMesh.Dispose();
+	}
+
+	/// <summary>
+	/// Re-pathing into the same <see cref="NavMeshPath"/> reuses its lists, and shouldn't allocate once it's warmed up
+	/// </summary>
+	[TestMethod]
+	public async Task Query_PathReuseNoAllocations()
+	{
+		var navMesh = new NavMesh();
+		var world = new PhysicsWorld();
+
+		var body = new PhysicsBody( world );
+		body.AddBoxShape( BBox.FromPositionAndSize( 0, 500 ), Rotation.Identity );
+
+		Assert.IsTrue( await navMesh.Generate( world ) );
+
+		world.Delete();
+
+		var requests = CreatePathRequests( 16 );
+		var path = new NavMeshPath();
+
+		// Warm up the pooled query and grow the path's lists to fit the longest path
+		foreach ( var request in requests )
+		{
+			navMesh.CalculatePath( request, ref path );
+		}
+
+		var points = path.Points;
+		var expected = navMesh.CalculatePath( requests[^1] );
+
+		var before = GC.GetAllocatedBytesForCurrentThread();
+
+		for ( int i = 0; i < 100; i++ )
+		{
+			navMesh.CalculatePath( requests[i % requests.Length], ref path );
+		}
+
+		var allocated = GC.GetAllocatedBytesForCurrentThread() - before;
+
+		Assert.AreEqual( 0, allocated, "Re-pathing shouldn't allocate" );
+		Assert.AreSame( points, path.Points );
+
+		navMesh.CalculatePath( requests[^1], ref path );
+		Assert.AreEqual( expected.Status, path.Status );
+		CollectionAssert.AreEqual( expected.Points.ToArray(), path.Points.ToArray() );
+
+		navMesh.Dispose();
+	}
+
+	/// <summary>
+	/// Queued paths are only searched when the queue is processed, a budget's worth at a time
+	/// </summary>
+	[TestMethod]
+	public async Task Query_PathAsync()
+	{
+		var navMesh = new NavMesh();
+		var world = new PhysicsWorld();
+
+		var body = new PhysicsBody( world );
+		body.AddBoxShape( BBox.FromPositionAndSize( 0, 500 ), Rotation.Identity );
+
+		Assert.IsTrue( await navMesh.Generate( world ) );
+
+		world.Delete();
+
+		var requests = CreatePathRequests( 1000 );
+		var tasks = requests.Select( navMesh.CalculatePathAsync ).ToArray();
+
+		Assert.AreEqual( requests.Length, navMesh.PendingPathCount );
+		Assert.IsFalse( tasks.Any( x => x.IsCompleted ) );
+
+		navMesh.PathQueryBudget = 100;
+
+		int updates = 0;
+		while ( navMesh.PendingPathCount > 0 )
+		{
+			navMesh.ProcessPathQueue();
+			updates++;
+		}
+
+		Assert.IsTrue( updates > 1, "Budget should spread the requests over several updates" );
+
+		var results = await Task.WhenAll( tasks );
+
+		for ( int i = 0; i < requests.Length; i++ )
+		{
+			var expected = navMesh.CalculatePath( requests[i] );
+
+			Assert.AreEqual( expected.Status, results[i].Status );
+			CollectionAssert.AreEqual( expected.Points.ToArray(), results[i].Points.ToArray() );
+		}
+
+		navMesh.Dispose();
+	}
+	static DtCrowd CreateCrowd( NavMesh navMesh, int parallelism )
+	{
+		var config = new DtCrowdConfig( navMesh.AgentRadius, navMesh.AgentHeight )
+		{
+			obstacleAvoidanceParallelism = parallelism,
+			minAgentsPerThread = 1,
+		};
+
+		var crowd = new DtCrowd( config, navMesh.navmeshInternal );
+		crowd.SetObstacleAvoidanceParams( 0, navMesh.crowd.GetObstacleAvoidanceParams( 0 ) );
+
+		var random = new System.Random( 1234 );
+
+		for ( int i = 0; i < 200; i++ )
+		{
+			var start = NavMesh.ToNav( new Vector3( random.Float( -220, 220 ), random.Float( -220, 220 ), 250 ) );
+			var target = NavMesh.ToNav( new Vector3( random.Float( -220, 220 ), random.Float( -220, 220 ), 250 ) );
+
+			var agent = crowd.AddAgent( start, new DtCrowdAgentParams
+			{
+				radius = 8,
+				height = 64,
+				maxAcceleration = 1000,
+				maxSpeed = 200,
+				collisionQueryRange = 128,
+				separationWeight = 12,
+				updateFlags = DtCrowdAgentUpdateFlags.DT_CROWD_ANTICIPATE_TURNS | DtCrowdAgentUpdateFlags.DT_CROWD_OBSTACLE_AVOIDANCE | DtCrowdAgentUpdateFlags.DT_CROWD_SEPARATION,
+				filter = DtQueryNoOpFilter.Shared,
+			} );
+
+			crowd.GetNavMeshQuery().FindNearestPoly( target, new Vector3( 64 ), DtQueryNoOpFilter.Shared, out var targetPoly, out var targetPos, out _ );
+			crowd.RequestMoveTarget( agent, targetPoly, targetPos );
+		}
+
+		return crowd;
+	}
+
+	/// <summary>
+	/// Splitting the crowd update across threads should move every agent exactly the same as doing it on one
+	/// </summary>
+	[TestMethod]
+	public async Task Crowd_ParallelMatchesSerial()
+	{
+		var navMesh = new NavMesh();
+		var world = new PhysicsWorld();
+
+		var body = new PhysicsBody( world );
+		body.AddBoxShape( BBox.FromPositionAndSize( 0, 500 ), Rotation.Identity );
+
+		Assert.IsTrue( await navMesh.Generate( world ) );
+
+		world.Delete();
+
+		var serial = CreateCrowd( navMesh, 1 );
+		var parallel = CreateCrowd( navMesh, 4 );
+
+		for ( int frame = 0; frame < 60; frame++ )
+		{
+			serial.Update( 1.0f / 30.0f, null );
+			parallel.Update( 1.0f / 30.0f, null );
+		}
+
+		var serialAgents = serial.GetActiveAgents();
+		var parallelAgents = parallel.GetActiveAgents();
+
+		Assert.AreEqual( serialAgents.Count, parallelAgents.Count );
+
+		for ( int i = 0; i < serialAgents.Count; i++ )
+		{
+			Assert.AreEqual( serialAgents[i].npos, parallelAgents[i].npos );
+			Assert.AreEqual( serialAgents[i].vel, parallelAgents[i].vel );
+		}
+
+		Assert.IsTrue( parallel.Telemetry().GetMilliseconds( DtCrowdTimerLabel.PlanVelocity ) > 0 );
+
+		navMesh.Dispose();
+	}
 }
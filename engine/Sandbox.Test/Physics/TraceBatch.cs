@@ -0,0 +1,88 @@
+namespace Physics;
+
+[TestClass]
+public class TraceBatch
+{
+	static TraceSweep[] Sweeps =>
+	[
+		new( new Vector3( 50, 50, 100 ), new Vector3( 50, 50, -100 ) ),
+		new( new Vector3( 50, 50, 100 ), new Vector3( 50, 50, -100 ), 10 ),
+		new( new Vector3( 500, 500, 100 ), new Vector3( 500, 500, -100 ) ),
+		new( new Vector3( -100, 50, 10 ), new Vector3( 200, 50, 10 ), 4 ),
+		new( new Vector3( 500, 500, 100 ), new Vector3( 200, 200, 100 ), 1000 ),
+	];
+
+	/// <summary>
+	/// A batch of sweeps should give the same results as running each trace on its own
+	/// </summary>
+	[TestMethod]
+	public void BatchMatchesSingle()
+	{
+		var scene = new Scene();
+		using var sceneScope = scene.Push();
+
+		var body = new PhysicsBody( scene.PhysicsWorld );
+		body.AddBoxShape( new BBox( 0, new Vector3( 100, 100, 20 ) ), Rotation.Identity );
+
+		var sweeps = Sweeps;
+		var results = new SceneTraceResult[sweeps.Length];
+
+		scene.Trace.RunBatch( sweeps, results );
+
+		for ( int i = 0; i < sweeps.Length; i++ )
+		{
+			var trace = scene.Trace.Ray( sweeps[i].From, sweeps[i].To );
+			if ( sweeps[i].Radius > 0 ) trace = trace.Radius( sweeps[i].Radius );
+
+			var expected = trace.Run();
+
+			Assert.AreEqual( expected.Hit, results[i].Hit, $"Sweep {i}" );
+			Assert.AreEqual( expected.Fraction, results[i].Fraction, 0.0001f, $"Sweep {i}" );
+			Assert.AreEqual( expected.EndPosition, results[i].EndPosition, $"Sweep {i}" );
+			Assert.AreEqual( expected.StartPosition, results[i].StartPosition, $"Sweep {i}" );
+		}
+
+		Assert.IsTrue( results[0].Hit );
+		Assert.IsFalse( results[2].Hit );
+	}
+
+	/// <summary>
+	/// The physics world trace should batch the same way
+	/// </summary>
+	[TestMethod]
+	public void PhysicsBatchMatchesSingle()
+	{
+		var world = new PhysicsWorld();
+
+		var body = new PhysicsBody( world );
+		body.AddBoxShape( new BBox( 0, new Vector3( 100, 100, 20 ) ), Rotation.Identity );
+
+		var sweeps = Sweeps;
+		var results = new PhysicsTraceResult[sweeps.Length];
+
+		world.Trace.RunBatch( sweeps, results );
+
+		for ( int i = 0; i < sweeps.Length; i++ )
+		{
+			var trace = world.Trace.Ray( sweeps[i].From, sweeps[i].To );
+			if ( sweeps[i].Radius > 0 ) trace = trace.Radius( sweeps[i].Radius );
+
+			var expected = trace.Run();
+
+			Assert.AreEqual( expected.Hit, results[i].Hit, $"Sweep {i}" );
+			Assert.AreEqual( expected.Fraction, results[i].Fraction, 0.0001f, $"Sweep {i}" );
+			Assert.AreEqual( expected.Body, results[i].Body, $"Sweep {i}" );
+		}
+
+		world.Delete();
+	}
+
+	[TestMethod]
+	public void BatchNeedsRoomForResults()
+	{
+		var scene = new Scene();
+		using var sceneScope = scene.Push();
+
+		Assert.ThrowsException<ArgumentException>( () => scene.Trace.RunBatch( Sweeps, new SceneTraceResult[2] ) );
+	}
+}
@@ -0,0 +1,57 @@
+namespace GameObjects.Components;
+
+[TestClass]
+public class ParticleRandomTests
+{
+	/// <summary>
+	/// The random value a particle used for this seed and line before the update was split up and baked.
+	/// </summary>
+	static float Original( Particle p, int seed, int line )
+	{
+		var randomSeed = ((IDynamicFloatContext)p).RandomSeed;
+		return Game.Random.FloatDeterministic( unchecked(randomSeed ^ (line * 73856093) ^ seed) );
+	}
+
+	/// <summary>
+	/// Per-particle randoms are seeded by call site line, make sure they still use the
+	/// lines they always did, otherwise every existing effect changes how it looks.
+	/// </summary>
+	[TestMethod]
+	public void RandomsMatchOriginalCallSites()
+	{
+		var scene = new Scene();
+		using var sceneScope = scene.Push();
+
+		var go = scene.CreateObject();
+		var effect = go.Components.Create<ParticleEffect>();
+		effect.Lifetime = 10;
+		effect.Damping = new ParticleFloat( 0, 5 );
+		effect.ApplyShape = true;
+		effect.Scale = new ParticleFloat( 1, 100 );
+		effect.ApplyColor = true;
+		effect.Gradient = new ParticleGradient { Type = ParticleGradient.ValueType.Range, Evaluation = ParticleGradient.EvaluationType.Particle, ConstantA = Color.Red, ConstantB = Color.Cyan };
+
+		for ( int i = 0; i < 16; i++ )
+		{
+			effect.Emit( Vector3.Zero, i / 16.0f );
+		}
+
+		effect.Step( 0.01f );
+
+		Assert.AreEqual( 16, effect.Particles.Count );
+
+		foreach ( var p in effect.Particles )
+		{
+			Assert.AreEqual( Original( p, 8234, 509 ), ParticleEffect.GetDampingRandom( p ) );
+			Assert.AreEqual( Original( p, 7723, 510 ), ParticleEffect.GetForceScaleRandom( p ) );
+
+			var size = effect.Scale.Evaluate( p.LifeDelta, Original( p, 6211, 613 ) );
+			Assert.AreEqual( size, p.Size.x, 0.01f );
+
+			var tint = effect.Gradient.Evaluate( p.LifeDelta, Original( p, 8752, 602 ) );
+			Assert.AreEqual( tint.r, p.Color.r, 0.01f );
+			Assert.AreEqual( tint.g, p.Color.g, 0.01f );
+			Assert.AreEqual( tint.b, p.Color.b, 0.01f );
+		}
+	}
+}
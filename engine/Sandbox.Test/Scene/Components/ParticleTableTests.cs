@@ -0,0 +1,150 @@
+using System;
+
+namespace GameObjects.Components;
+
+[TestClass]
+public class ParticleTableTests
+{
+	static readonly Curve Bumpy = new Curve( new Curve.Frame( 0, 0.2f ), new Curve.Frame( 0.3f, 1.0f ), new Curve.Frame( 0.6f, 0.1f, -2, 2 ), new Curve.Frame( 1, 0.8f ) );
+
+	static ParticleFloat[] FloatValues =>
+	[
+		4.0f,
+		new ParticleFloat( -3, 12 ),
+		new ParticleFloat( -3, 12 ) { Evaluation = ParticleFloat.EvaluationType.Life },
+		new ParticleFloat { Type = ParticleFloat.ValueType.Curve, Evaluation = ParticleFloat.EvaluationType.Life, CurveA = Curve.Ease },
+		new ParticleFloat { Type = ParticleFloat.ValueType.Curve, Evaluation = ParticleFloat.EvaluationType.Seed, CurveA = Bumpy },
+		new ParticleFloat { Type = ParticleFloat.ValueType.CurveRange, Evaluation = ParticleFloat.EvaluationType.Life, CurveA = Curve.EaseIn, CurveB = Bumpy },
+	];
+
+	/// <summary>
+	/// Baked values should be within a small fraction of the directly evaluated ones
+	/// </summary>
+	[TestMethod]
+	public void FloatMatchesEvaluate()
+	{
+		var table = new ParticleFloatTable();
+
+		foreach ( var value in FloatValues )
+		{
+			Assert.IsTrue( table.Update( value ) );
+			Assert.IsFalse( table.Update( value ), "Unchanged value shouldn't rebake" );
+
+			for ( int i = 0; i <= 1000; i++ )
+			{
+				var delta = i / 1000.0f;
+				var random = (i * 7919 % 1000) / 1000.0f;
+
+				var expected = value.Evaluate( delta, random );
+				var actual = table.Evaluate( delta, random );
+
+				Assert.AreEqual( expected, actual, 0.001f, $"{value.Type} {value.Evaluation} at {delta}, {random}" );
+			}
+		}
+	}
+
+	/// <summary>
+	/// The batch evaluator should give exactly the same results as evaluating one at a time
+	/// </summary>
+	[TestMethod]
+	public void FloatBatchMatchesSingle()
+	{
+		var table = new ParticleFloatTable();
+
+		var deltas = new float[333];
+		var randoms = new float[deltas.Length];
+		var output = new float[deltas.Length];
+
+		for ( int i = 0; i < deltas.Length; i++ )
+		{
+			deltas[i] = i / (float)(deltas.Length - 1);
+			randoms[i] = (i * 7919 % 1000) / 1000.0f;
+		}
+
+		foreach ( var value in FloatValues )
+		{
+			table.Update( value );
+			table.Evaluate( deltas, randoms, output );
+
+			for ( int i = 0; i < deltas.Length; i++ )
+			{
+				Assert.AreEqual( table.Evaluate( deltas[i], randoms[i] ), output[i] );
+			}
+		}
+	}
+
+	/// <summary>
+	/// Stepped curves can't be baked, so should give exactly the same values
+	/// </summary>
+	[TestMethod]
+	public void FloatSteppedIsExact()
+	{
+		var stepped = new Curve( new Curve.Frame( 0, 0 ) { Mode = Curve.HandleMode.Stepped }, new Curve.Frame( 0.5f, 1 ) { Mode = Curve.HandleMode.Stepped }, new Curve.Frame( 1, 0.25f ) );
+		var value = new ParticleFloat { Type = ParticleFloat.ValueType.Curve, Evaluation = ParticleFloat.EvaluationType.Life, CurveA = stepped };
+
+		var table = new ParticleFloatTable();
+		table.Update( value );
+
+		for ( int i = 0; i <= 1000; i++ )
+		{
+			var delta = i / 1000.0f;
+			Assert.AreEqual( value.Evaluate( delta, 0 ), table.Evaluate( delta, 0 ) );
+		}
+	}
+
+	[TestMethod]
+	public void FloatRebakesWhenChanged()
+	{
+		var table = new ParticleFloatTable();
+
+		ParticleFloat value = 1.0f;
+		table.Update( value );
+
+		value.ConstantValue = 2.0f;
+		Assert.IsTrue( table.Update( value ) );
+		Assert.AreEqual( 2.0f, table.Evaluate( 0.5f, 0.5f ) );
+
+		value = new ParticleFloat { Type = ParticleFloat.ValueType.Curve, Evaluation = ParticleFloat.EvaluationType.Life, CurveA = Curve.Linear };
+		Assert.IsTrue( table.Update( value ) );
+
+		value.CurveA = Bumpy;
+		Assert.IsTrue( table.Update( value ) );
+		Assert.AreEqual( Bumpy.Evaluate( 0.3f ), table.Evaluate( 0.3f, 0 ), 0.001f );
+	}
+
+	[TestMethod]
+	public void GradientMatchesEvaluate()
+	{
+		var gradient = new Gradient( new Gradient.ColorFrame( 0, Color.Red ), new Gradient.ColorFrame( 0.4f, Color.Green ), new Gradient.ColorFrame( 1, Color.Blue ) );
+		gradient.AddAlpha( 0, 1 );
+		gradient.AddAlpha( 0.7f, 0.2f );
+
+		var values = new ParticleGradient[]
+		{
+			Color.Orange,
+			new ParticleGradient { Type = ParticleGradient.ValueType.Range, Evaluation = ParticleGradient.EvaluationType.Particle, ConstantA = Color.Red, ConstantB = Color.Cyan },
+			new ParticleGradient { Type = ParticleGradient.ValueType.Gradient, Evaluation = ParticleGradient.EvaluationType.Life, GradientA = gradient },
+		};
+
+		var table = new ParticleGradientTable();
+
+		foreach ( var value in values )
+		{
+			Assert.IsTrue( table.Update( value ) );
+
+			for ( int i = 0; i <= 1000; i++ )
+			{
+				var delta = i / 1000.0f;
+				var random = (i * 7919 % 1000) / 1000.0f;
+
+				var expected = value.Evaluate( delta, random );
+				var actual = table.Evaluate( delta, random );
+
+				Assert.AreEqual( expected.r, actual.r, 0.01f, $"{value.Type} at {delta}" );
+				Assert.AreEqual( expected.g, actual.g, 0.01f, $"{value.Type} at {delta}" );
+				Assert.AreEqual( expected.b, actual.b, 0.01f, $"{value.Type} at {delta}" );
+				Assert.AreEqual( expected.a, actual.a, 0.01f, $"{value.Type} at {delta}" );
+			}
+		}
+	}
+}
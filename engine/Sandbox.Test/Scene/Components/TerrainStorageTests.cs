@@ -0,0 +1,290 @@
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.IO.Compression;
+using System.Runtime.InteropServices;
+using System.Text.Json.Nodes;
+using System.Threading.Tasks;
+
+namespace GameObjects.Components;
+
+[TestClass]
+public class TerrainStorageTests
+{
+	/// <summary>
+	/// Rolling hills with a cliff, a 300x300 map so the tiles along the far edges are smaller
+	/// </summary>
+	static TerrainStorage CreateStorage()
+	{
+		var storage = new TerrainStorage();
+		storage.SetResolution( 300 );
+
+		var random = new Random( 1234 );
+
+		for ( int y = 0; y < storage.Resolution; y++ )
+		{
+			for ( int x = 0; x < storage.Resolution; x++ )
+			{
+				var i = y * storage.Resolution + x;
+
+				storage.HeightMap[i] = (ushort)(20000 + MathF.Sin( x * 0.02f ) * 5000 + MathF.Cos( y * 0.03f ) * 4000 + random.Next( 4 ) + (x > 150 ? 10000 : 0));
+				storage.ControlMap[i] = new Color32( (byte)(255 - x % 256), (byte)(x % 256), (byte)y, 0 );
+				storage.HolesMap[i] = (byte)((x / 7 + y / 9) % 13 == 0 ? 255 : 0);
+			}
+		}
+
+		return storage;
+	}
+
+	static TerrainStorage RoundTrip( TerrainStorage storage )
+	{
+		var result = new TerrainStorage();
+		result.Deserialize( storage.Serialize() );
+		return result;
+	}
+
+	[TestMethod]
+	public void SerializeTiled()
+	{
+		var source = CreateStorage();
+		var json = source.Serialize();
+
+		Assert.IsInstanceOfType<JsonObject>( json["Maps"]["heightmap"] );
+
+		var result = RoundTrip( source );
+
+		CollectionAssert.AreEqual( source.HeightMap, result.HeightMap );
+		CollectionAssert.AreEqual( source.ControlMap, result.ControlMap );
+		CollectionAssert.AreEqual( source.HolesMap, result.HolesMap );
+	}
+
+	/// <summary>
+	/// Reading a region before anything else uses the height map only decodes the tiles under it,
+	/// but must give the same heights as the whole map
+	/// </summary>
+	[TestMethod]
+	public void HeightMapRegion()
+	{
+		var source = CreateStorage();
+		var loaded = RoundTrip( source );
+
+		var region = new ushort[100 * 80];
+		loaded.GetHeightMapRegion( 200, 220, 100, 80, region );
+
+		var decoded = RoundTrip( source );
+		_ = decoded.HeightMap;
+
+		var expected = new ushort[region.Length];
+		decoded.GetHeightMapRegion( 200, 220, 100, 80, expected );
+
+		CollectionAssert.AreEqual( expected, region );
+
+		for ( int y = 0; y < 80; y++ )
+		{
+			for ( int x = 0; x < 100; x++ )
+			{
+				Assert.AreEqual( source.HeightMap[(220 + y) * 300 + 200 + x], region[y * 100 + x] );
+			}
+		}
+	}
+
+	/// <summary>
+	/// The first use of a loaded map can come from several threads at once, they should all get
+	/// the same decoded array
+	/// </summary>
+	[TestMethod]
+	public void DecodeConcurrently()
+	{
+		var source = CreateStorage();
+
+		for ( int attempt = 0; attempt < 8; attempt++ )
+		{
+			var loaded = RoundTrip( source );
+			var maps = new ushort[16][];
+			var regions = new ushort[16][];
+
+			Parallel.For( 0, maps.Length, i =>
+			{
+				regions[i] = new ushort[100 * 80];
+				loaded.GetHeightMapRegion( 200, 220, 100, 80, regions[i] );
+				maps[i] = loaded.HeightMap;
+			} );
+
+			foreach ( var map in maps )
+			{
+				Assert.AreSame( maps[0], map );
+			}
+
+			CollectionAssert.AreEqual( source.HeightMap, maps[0] );
+
+			foreach ( var region in regions )
+			{
+				CollectionAssert.AreEqual( regions[0], region );
+			}
+		}
+	}
+
+	/// <summary>
+	/// Terrain saved before maps were tiled has each one as a single deflated string
+	/// </summary>
+	[TestMethod]
+	public void DeserializeUntiled()
+	{
+		var source = CreateStorage();
+		var json = source.Serialize();
+
+		json["Maps"] = new JsonObject
+		{
+			["heightmap"] = Deflate( MemoryMarshal.AsBytes( source.HeightMap.AsSpan() ) ),
+			["splatmap"] = Deflate( MemoryMarshal.AsBytes( source.ControlMap.AsSpan() ) ),
+			["holesmap"] = Deflate( source.HolesMap ),
+		};
+
+		var result = new TerrainStorage();
+		result.Deserialize( json );
+
+		CollectionAssert.AreEqual( source.HeightMap, result.HeightMap );
+		CollectionAssert.AreEqual( source.ControlMap, result.ControlMap );
+		CollectionAssert.AreEqual( source.HolesMap, result.HolesMap );
+	}
+
+	/// <summary>
+	/// Edits that touch get merged into one region, ones apart from each other stay separate
+	/// </summary>
+	[TestMethod]
+	public void DirtyRegionsMerge()
+	{
+		var storage = new TerrainStorage();
+		storage.SetResolution( 256 );
+
+		storage.MarkDirty( Terrain.SyncFlags.Height, new RectInt( 10, 10, 4, 4 ) );
+		storage.MarkDirty( Terrain.SyncFlags.Control, new RectInt( 14, 12, 4, 4 ) );
+		storage.MarkDirty( Terrain.SyncFlags.Height, new RectInt( 100, 100, 4, 4 ) );
+		storage.MarkDirty( Terrain.SyncFlags.Holes, new RectInt( 250, 250, 20, 20 ) );
+
+		var version = 0L;
+		var regions = new List<(Terrain.SyncFlags Flags, RectInt Region)>();
+		storage.GetDirtyRegions( ref version, regions );
+
+		Assert.AreEqual( 3, regions.Count );
+		Assert.IsTrue( regions.Contains( (Terrain.SyncFlags.Height | Terrain.SyncFlags.Control, new RectInt( 10, 10, 8, 6 )) ) );
+		Assert.IsTrue( regions.Contains( (Terrain.SyncFlags.Height, new RectInt( 100, 100, 4, 4 )) ) );
+		Assert.IsTrue( regions.Contains( (Terrain.SyncFlags.Holes, new RectInt( 250, 250, 6, 6 )) ) );
+
+		regions.Clear();
+		storage.GetDirtyRegions( ref version, regions );
+
+		Assert.AreEqual( 0, regions.Count );
+
+		// Past 16 separate regions they collapse into one, the rest stay separate after it
+
+		for ( int i = 0; i < 32; i++ )
+		{
+			storage.MarkDirty( Terrain.SyncFlags.Height, new RectInt( i * 7, i * 7, 2, 2 ) );
+		}
+
+		storage.GetDirtyRegions( ref version, regions );
+
+		Assert.AreEqual( 16, regions.Count );
+		Assert.AreEqual( (Terrain.SyncFlags.Height, new RectInt( 0, 0, 114, 114 )), regions[0] );
+		Assert.AreEqual( (Terrain.SyncFlags.Height, new RectInt( 217, 217, 2, 2 )), regions[15] );
+	}
+
+	/// <summary>
+	/// Each terrain using the storage keeps its own version, so one syncing doesn't use up the edits for the others
+	/// </summary>
+	[TestMethod]
+	public void DirtyRegionsPerConsumer()
+	{
+		var storage = new TerrainStorage();
+		storage.SetResolution( 256 );
+
+		var first = 0L;
+		var second = 0L;
+		var regions = new List<(Terrain.SyncFlags Flags, RectInt Region)>();
+
+		storage.MarkDirty( Terrain.SyncFlags.Height, new RectInt( 10, 10, 4, 4 ) );
+
+		storage.GetDirtyRegions( ref first, regions );
+		Assert.AreEqual( 1, regions.Count );
+
+		storage.MarkDirty( Terrain.SyncFlags.Control, new RectInt( 100, 100, 4, 4 ) );
+
+		regions.Clear();
+		storage.GetDirtyRegions( ref second, regions );
+
+		Assert.AreEqual( 2, regions.Count );
+		Assert.AreEqual( (Terrain.SyncFlags.Height, new RectInt( 10, 10, 4, 4 )), regions[0] );
+		Assert.AreEqual( (Terrain.SyncFlags.Control, new RectInt( 100, 100, 4, 4 )), regions[1] );
+
+		regions.Clear();
+		storage.GetDirtyRegions( ref first, regions );
+
+		Assert.AreEqual( 1, regions.Count );
+		Assert.AreEqual( (Terrain.SyncFlags.Control, new RectInt( 100, 100, 4, 4 )), regions[0] );
+
+		// Something that hasn't synced in a very long time gets the whole map
+
+		for ( int i = 0; i < 1000; i++ )
+		{
+			storage.MarkDirty( Terrain.SyncFlags.Holes, new RectInt( 0, 0, 1, 1 ) );
+		}
+
+		regions.Clear();
+		storage.GetDirtyRegions( ref second, regions );
+
+		Assert.AreEqual( 1, regions.Count );
+		Assert.AreEqual( (Terrain.SyncFlags.Height | Terrain.SyncFlags.Control | Terrain.SyncFlags.Holes, new RectInt( 0, 0, 256, 256 )), regions[0] );
+		Assert.AreEqual( storage.DirtyVersion, second );
+	}
+
+	[TestMethod]
+	public void EditRoundTrip()
+	{
+		var source = CreateStorage();
+		var target = new TerrainStorage();
+		target.SetResolution( source.Resolution );
+
+		var region = new RectInt( 40, 60, 30, 20 );
+		var edit = source.CreateEdit( Terrain.SyncFlags.Height | Terrain.SyncFlags.Holes, region );
+
+		Assert.IsTrue( edit.Length < region.Width * region.Height * 3 );
+
+		var (flags, applied) = target.ApplyEdit( edit );
+
+		Assert.AreEqual( Terrain.SyncFlags.Height | Terrain.SyncFlags.Holes, flags );
+		Assert.AreEqual( region, applied );
+
+		for ( int y = 0; y < source.Resolution; y++ )
+		{
+			for ( int x = 0; x < source.Resolution; x++ )
+			{
+				var i = y * source.Resolution + x;
+				var inside = x >= 40 && x < 70 && y >= 60 && y < 80;
+
+				Assert.AreEqual( inside ? source.HeightMap[i] : (ushort)0, target.HeightMap[i] );
+				Assert.AreEqual( inside ? source.HolesMap[i] : (byte)0, target.HolesMap[i] );
+			}
+		}
+
+		// Applying it marks it dirty for any terrain using the storage
+
+		var version = 0L;
+		var regions = new List<(Terrain.SyncFlags Flags, RectInt Region)>();
+		target.GetDirtyRegions( ref version, regions );
+
+		Assert.AreEqual( 1, regions.Count );
+		Assert.AreEqual( region, regions[0].Region );
+	}
+
+	static string Deflate( ReadOnlySpan<byte> data )
+	{
+		using var stream = new MemoryStream();
+		using ( var deflate = new DeflateStream( stream, CompressionMode.Compress ) )
+		{
+			deflate.Write( data );
+		}
+
+		return Convert.ToBase64String( stream.ToArray() );
+	}
+}
@@ -0,0 +1,111 @@
+using Sandbox;
+using Sandbox.Internal;
+
+namespace GameObjects;
+
+[TestClass]
+public class PreRender
+{
+	[TestMethod]
+	public void OnlyWhenDirty()
+	{
+		var scene = new Scene();
+		using var sceneScope = scene.Push();
+
+		var parent = scene.CreateObject();
+		var go = scene.CreateObject();
+		go.Parent = parent;
+
+		var c = go.Components.Create<PreRenderCountComponent>();
+
+		scene.PreRender();
+		scene.PreRender();
+		Assert.AreEqual( 1, c.PreRenderCalls, "Should be dirty when enabled, then clean" );
+
+		go.WorldPosition = new Vector3( 10, 0, 0 );
+		scene.PreRender();
+		Assert.AreEqual( 2, c.PreRenderCalls, "Moving should make it dirty" );
+
+		parent.WorldPosition = new Vector3( 0, 10, 0 );
+		scene.PreRender();
+		Assert.AreEqual( 3, c.PreRenderCalls, "Moving the parent should make it dirty" );
+
+		c.Touch();
+		c.Touch();
+		scene.PreRender();
+		scene.PreRender();
+		Assert.AreEqual( 4, c.PreRenderCalls );
+
+		c.Enabled = false;
+		c.Touch();
+		go.WorldPosition = 0;
+		scene.PreRender();
+		Assert.AreEqual( 4, c.PreRenderCalls, "Disabled components shouldn't pre-render" );
+
+		c.Enabled = true;
+		scene.PreRender();
+		Assert.AreEqual( 5, c.PreRenderCalls );
+	}
+
+	/// <summary>
+	/// A dirty component destroyed by another one's pre-render, in the same frame, shouldn't be pre-rendered
+	/// </summary>
+	[TestMethod]
+	public void DestroyedWhilePreRendering()
+	{
+		var scene = new Scene();
+		using var sceneScope = scene.Push();
+
+		var a = scene.CreateObject().Components.Create<PreRenderDestroyComponent>();
+		var b = scene.CreateObject().Components.Create<PreRenderDestroyComponent>();
+		a.Other = b;
+		b.Other = a;
+
+		scene.PreRender();
+
+		Assert.AreEqual( 1, a.PreRenderCalls + b.PreRenderCalls, "Whichever goes first destroys the other" );
+		Assert.AreNotEqual( a.IsValid, b.IsValid );
+	}
+
+	/// <summary>
+	/// The scene turns gradient fog off at the start of every tick, so the component has to turn it back on every frame
+	/// </summary>
+	[TestMethod]
+	public void GradientFogStaysOn()
+	{
+		var scene = new Scene();
+		using var sceneScope = scene.Push();
+
+		var go = scene.CreateObject();
+		go.Components.Create<GradientFog>();
+
+		for ( int i = 0; i < 2; i++ )
+		{
+			scene.GameTick();
+			scene.PreRender();
+
+			Assert.IsTrue( scene.SceneWorld.GradientFog.Enabled, $"Fog should be on after tick {i + 1}" );
+		}
+	}
+}
+
+public class PreRenderCountComponent : Component, Component.PreRenderOnlyWhenDirty, IPreRenderSubscriber
+{
+	public int PreRenderCalls;
+
+	protected override void OnPreRender() => PreRenderCalls++;
+
+	public void Touch() => MarkPreRenderDirty();
+}
+
+public class PreRenderDestroyComponent : Component, Component.PreRenderOnlyWhenDirty, IPreRenderSubscriber
+{
+	public int PreRenderCalls;
+	public Component Other;
+
+	protected override void OnPreRender()
+	{
+		PreRenderCalls++;
+		Other.Destroy();
+	}
+}
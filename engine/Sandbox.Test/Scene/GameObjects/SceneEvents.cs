@@ -0,0 +1,85 @@
+using Sandbox;
+using System.Linq;
+
+namespace GameObjects;
+
+[TestClass]
+public class SceneEvents
+{
+	[TestMethod]
+	public void PostWithInvoker()
+	{
+		var scene = new Scene();
+		using var sceneScope = scene.Push();
+
+		var listeners = Enumerable.Range( 0, 8 )
+			.Select( _ => scene.CreateObject().Components.Create<SceneEventTestComponent>() )
+			.ToArray();
+
+		listeners[3].Enabled = false;
+
+		ISceneEventTest.Post( new TestHurt( 10 ) );
+		ISceneEventTest.Post( x => x.OnHurt( 5 ) );
+
+		for ( int i = 0; i < listeners.Length; i++ )
+		{
+			Assert.AreEqual( i == 3 ? 0 : 15, listeners[i].Damage );
+		}
+	}
+
+	/// <summary>
+	/// Listeners added or removed while an event is running shouldn't break it, and should be
+	/// picked up next time it runs.
+	/// </summary>
+	[TestMethod]
+	public void ChangeListenersWhileRunning()
+	{
+		var scene = new Scene();
+		using var sceneScope = scene.Push();
+
+		var first = scene.CreateObject().Components.Create<SceneEventTestComponent>();
+		first.OnHurtAction = () =>
+		{
+			scene.CreateObject().Components.Create<SceneEventTestComponent>();
+			first.OnHurtAction = null;
+		};
+
+		scene.CreateObject().Components.Create<SceneEventTestComponent>();
+
+		ISceneEventTest.Post( new TestHurt( 1 ) );
+
+		Assert.AreEqual( 2, scene.GetAll<SceneEventTestComponent>().Sum( x => x.Damage ) );
+
+		ISceneEventTest.Post( new TestHurt( 1 ) );
+
+		Assert.AreEqual( 5, scene.GetAll<SceneEventTestComponent>().Sum( x => x.Damage ) );
+
+		first.Enabled = false;
+		ISceneEventTest.Post( new TestHurt( 1 ) );
+
+		Assert.AreEqual( 2, scene.GetAll<SceneEventTestComponent>().Count() );
+		Assert.AreEqual( 5, scene.GetAll<SceneEventTestComponent>().Sum( x => x.Damage ) );
+	}
+
+	readonly struct TestHurt( int amount ) : ISceneEventInvoker<ISceneEventTest>
+	{
+		public void Invoke( ISceneEventTest listener ) => listener.OnHurt( amount );
+	}
+}
+
+public interface ISceneEventTest : ISceneEvent<ISceneEventTest>
+{
+	void OnHurt( int amount );
+}
+
+public class SceneEventTestComponent : Component, ISceneEventTest
+{
+	public int Damage;
+	public System.Action OnHurtAction;
+
+	void ISceneEventTest.OnHurt( int amount )
+	{
+		Damage += amount;
+		OnHurtAction?.Invoke();
+	}
+}
@@ -0,0 +1,321 @@
+using Sandbox;
+using System;
+using System.Collections.Generic;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace GameObjects;
+
+[TestClass]
+public class SpatialIndex
+{
+	/// <summary>
+	/// Whatever happens to the objects, the spatial index should find the same components as checking every one.
+	/// </summary>
+	[TestMethod]
+	public void MatchesBruteForce()
+	{
+		var scene = new Scene();
+		using var sceneScope = scene.Push();
+
+		var random = new Random( 1234 );
+		var objects = new List<GameObject>();
+
+		Vector3 RandomPosition() => new Vector3( random.Float( -4000, 4000 ), random.Float( -4000, 4000 ), random.Float( 0, 1000 ) );
+
+		for ( int i = 0; i < 500; i++ )
+		{
+			var go = scene.CreateObject();
+			go.WorldPosition = RandomPosition();
+			go.Components.Create<SpatialTestComponent>();
+
+			// Some children that follow their parent around
+			if ( i % 5 == 0 && objects.Count > 0 )
+			{
+				go.Parent = objects[random.Next( objects.Count )];
+			}
+
+			objects.Add( go );
+		}
+
+		AssertMatches( scene, random );
+
+		// Move some
+		for ( int i = 0; i < 100; i++ )
+		{
+			objects[random.Next( objects.Count )].WorldPosition = RandomPosition();
+		}
+
+		AssertMatches( scene, random );
+
+		// Disable some
+		for ( int i = 0; i < 50; i++ )
+		{
+			var go = objects[random.Next( objects.Count )];
+
+			if ( i % 2 == 0 ) go.Enabled = false;
+			else go.Components.Get<SpatialTestComponent>( true ).Enabled = false;
+		}
+
+		AssertMatches( scene, random );
+
+		// Destroy some
+		for ( int i = 0; i < 50; i++ )
+		{
+			var go = objects[random.Next( objects.Count )];
+			if ( go.IsValid() ) go.Destroy();
+		}
+
+		scene.ProcessDeletes();
+
+		AssertMatches( scene, random );
+
+		// Bring some back and move them
+		foreach ( var go in objects )
+		{
+			if ( !go.IsValid() ) continue;
+
+			go.Enabled = true;
+			go.Components.Get<SpatialTestComponent>( true ).Enabled = true;
+			go.WorldPosition = RandomPosition();
+		}
+
+		AssertMatches( scene, random );
+	}
+
+	/// <summary>
+	/// Queries off the main thread should find the same things as on it.
+	/// </summary>
+	[TestMethod]
+	public void WorkerThreads()
+	{
+		var scene = new Scene();
+		using var sceneScope = scene.Push();
+
+		var random = new Random( 1234 );
+
+		for ( int i = 0; i < 1000; i++ )
+		{
+			var go = scene.CreateObject();
+			go.WorldPosition = new Vector3( random.Float( -4000, 4000 ), random.Float( -4000, 4000 ), 0 );
+			go.Components.Create<SpatialTestComponent>();
+		}
+
+		var spheres = new Sphere[64];
+		var expected = new int[spheres.Length];
+
+		for ( int i = 0; i < spheres.Length; i++ )
+		{
+			spheres[i] = new Sphere( new Vector3( random.Float( -4000, 4000 ), random.Float( -4000, 4000 ), 0 ), 500 );
+
+			var found = new List<SpatialTestComponent>();
+			scene.FindInSphere( spheres[i], found );
+			expected[i] = found.Count;
+		}
+
+		var results = new int[spheres.Length];
+
+		Parallel.For( 0, spheres.Length, i =>
+		{
+			var found = new List<SpatialTestComponent>();
+			scene.FindInSphere( spheres[i], found );
+			results[i] = found.Count;
+		} );
+
+		CollectionAssert.AreEqual( expected, results );
+	}
+
+	/// <summary>
+	/// Changes only reach the index when the scene updates it, so queries on any thread keep seeing the same
+	/// thing while the main thread creates and moves objects.
+	/// </summary>
+	[TestMethod]
+	public void QueriesWhileChanging()
+	{
+		var scene = new Scene();
+		using var sceneScope = scene.Push();
+
+		var random = new Random( 1234 );
+		var objects = new List<GameObject>();
+
+		Vector3 RandomPosition() => new Vector3( random.Float( -4000, 4000 ), random.Float( -4000, 4000 ), 0 );
+
+		for ( int i = 0; i < 1000; i++ )
+		{
+			var go = scene.CreateObject();
+			go.WorldPosition = RandomPosition();
+			go.Components.Create<SpatialTestComponent>();
+			objects.Add( go );
+		}
+
+		var spheres = new Sphere[64];
+		var expected = new int[spheres.Length];
+
+		for ( int i = 0; i < spheres.Length; i++ )
+		{
+			spheres[i] = new Sphere( RandomPosition(), 500 );
+
+			var found = new List<SpatialTestComponent>();
+			scene.FindInSphere( spheres[i], found );
+			expected[i] = found.Count;
+		}
+
+		var worker = Task.Run( () =>
+		{
+			var mismatches = 0;
+
+			for ( int pass = 0; pass < 20; pass++ )
+			{
+				Parallel.For( 0, spheres.Length, i =>
+				{
+					var found = new List<SpatialTestComponent>();
+					scene.FindInSphere( spheres[i], found );
+
+					if ( found.Count != expected[i] )
+						Interlocked.Increment( ref mismatches );
+				} );
+			}
+
+			return mismatches;
+		} );
+
+		for ( int i = 0; i < 200 && !worker.IsCompleted; i++ )
+		{
+			objects[random.Next( objects.Count )].WorldPosition = RandomPosition();
+
+			var go = scene.CreateObject();
+			go.WorldPosition = spheres[i % spheres.Length].Center;
+			go.Components.Create<SpatialTestComponent>();
+
+			var found = new List<SpatialTestComponent>();
+			scene.FindInSphere( spheres[i % spheres.Length], found );
+			Assert.AreEqual( expected[i % spheres.Length], found.Count, "Main thread queries shouldn't see changes before the update either" );
+		}
+
+		Assert.AreEqual( 0, worker.Result );
+
+		AssertMatches( scene, random );
+	}
+
+	/// <summary>
+	/// Components being enabled, disabled, added and destroyed on the main thread shouldn't be seen by queries
+	/// on other threads until the index is updated, and the queries shouldn't be touching the live component
+	/// lists while it happens.
+	/// </summary>
+	[TestMethod]
+	public void QueriesWhileComponentsChange()
+	{
+		var scene = new Scene();
+		using var sceneScope = scene.Push();
+
+		var random = new Random( 1234 );
+		var objects = new List<GameObject>();
+
+		Vector3 RandomPosition() => new Vector3( random.Float( -4000, 4000 ), random.Float( -4000, 4000 ), 0 );
+
+		for ( int i = 0; i < 1000; i++ )
+		{
+			var go = scene.CreateObject();
+			go.WorldPosition = RandomPosition();
+			go.Components.Create<SpatialTestComponent>();
+			objects.Add( go );
+		}
+
+		var spheres = new Sphere[64];
+		var expected = new int[spheres.Length];
+
+		for ( int i = 0; i < spheres.Length; i++ )
+		{
+			spheres[i] = new Sphere( RandomPosition(), 500 );
+		}
+
+		for ( int round = 0; round < 5; round++ )
+		{
+			scene.UpdateSpatialIndex();
+
+			for ( int i = 0; i < spheres.Length; i++ )
+			{
+				var found = new List<SpatialTestComponent>();
+				scene.FindInSphere( spheres[i], found );
+				expected[i] = found.Count;
+			}
+
+			var worker = Task.Run( () =>
+			{
+				var mismatches = 0;
+
+				for ( int pass = 0; pass < 20; pass++ )
+				{
+					Parallel.For( 0, spheres.Length, i =>
+					{
+						var found = new List<SpatialTestComponent>();
+						scene.FindInSphere( spheres[i], found );
+
+						if ( found.Count != expected[i] )
+							Interlocked.Increment( ref mismatches );
+					} );
+				}
+
+				return mismatches;
+			} );
+
+			for ( int i = 0; i < 500 && !worker.IsCompleted; i++ )
+			{
+				var go = objects[random.Next( objects.Count )];
+
+				switch ( i % 3 )
+				{
+					case 0:
+						var existing = go.Components.Get<SpatialTestComponent>( true );
+						if ( existing.IsValid() ) existing.Enabled = !existing.Enabled;
+						break;
+
+					case 1:
+						go.Components.Create<SpatialTestComponent>();
+						break;
+
+					case 2:
+						var all = go.Components.GetAll<SpatialTestComponent>( FindMode.EverythingInSelf ).ToArray();
+						if ( all.Length > 1 ) all[^1].Destroy();
+						break;
+				}
+			}
+
+			Assert.AreEqual( 0, worker.Result, $"Round {round}" );
+
+			AssertMatches( scene, random );
+		}
+	}
+
+	static void AssertMatches( Scene scene, Random random )
+	{
+		scene.UpdateSpatialIndex();
+
+		var all = scene.GetAll<SpatialTestComponent>().ToArray();
+
+		for ( int i = 0; i < 50; i++ )
+		{
+			var center = new Vector3( random.Float( -4000, 4000 ), random.Float( -4000, 4000 ), random.Float( 0, 1000 ) );
+			var radius = random.Float( 100, 2000 );
+
+			var sphere = new Sphere( center, radius );
+			var found = new List<SpatialTestComponent>();
+			scene.FindInSphere( sphere, found );
+
+			var expected = all.Where( x => x.WorldPosition.DistanceSquared( center ) <= radius * radius ).ToHashSet();
+			Assert.IsTrue( expected.SetEquals( found ), $"Sphere {i}: expected {expected.Count}, found {found.Count}" );
+			Assert.AreEqual( expected.Count, found.Count, "Shouldn't find anything twice" );
+
+			var box = BBox.FromPositionAndSize( center, radius * 2 );
+			found.Clear();
+			scene.FindInBox( box, found );
+
+			expected = all.Where( x => box.Contains( x.WorldPosition ) ).ToHashSet();
+			Assert.IsTrue( expected.SetEquals( found ), $"Box {i}: expected {expected.Count}, found {found.Count}" );
+		}
+	}
+}
+
+public class SpatialTestComponent : Component
+{
+}